@@ -0,0 +1,87 @@
+#include <eosio/chain/abi_serializer.hpp>
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#include <contracts.hpp>
+
+#include <benchmark.hpp>
+
+using namespace eosio::chain;
+using eosio::testing::contracts;
+
+namespace benchmark {
+
+namespace {
+
+const fc::microseconds max_serialization_time = fc::seconds(10);
+
+abi_def load_abi(const std::vector<char>& abi_json) {
+   return fc::json::from_string(abi_json.data()).as<abi_def>(); // embedded abi text is null terminated
+}
+
+void encode_decode(const abi_serializer& abis, const std::string& label, const std::string& type, const fc::variant& value) {
+   const auto yield = abi_serializer::create_yield_function(max_serialization_time);
+   const bytes binary = abis.variant_to_binary(type, value, yield);
+
+   benchmarking("abi encode " + label, [&]() {
+      abis.variant_to_binary(type, value, yield);
+   });
+   benchmarking("abi decode " + label, [&]() {
+      abis.binary_to_variant(type, binary, yield);
+   });
+}
+
+} // namespace
+
+void abi_benchmarking() {
+   const abi_def token_abi = load_abi(contracts::eosio_token_abi());
+   const abi_def bios_abi = load_abi(contracts::eosio_bios_abi());
+   const auto yield = abi_serializer::create_yield_function(max_serialization_time);
+
+   benchmarking("abi set_abi eosio.token", [&]() {
+      abi_serializer abis(token_abi, yield);
+   });
+   benchmarking("abi set_abi eosio.bios", [&]() {
+      abi_serializer abis(bios_abi, yield);
+   });
+
+   const abi_serializer token_abis(token_abi, yield);
+   const abi_serializer bios_abis(bios_abi, yield);
+
+   encode_decode(token_abis, "transfer", "transfer", fc::mutable_variant_object()
+      ("from", "alice")
+      ("to", "bob")
+      ("quantity", "1.00000000 WAX")
+      ("memo", "payment for order #12345, thank you!"));
+
+   const auto key = "EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV";
+   auto make_authority = [&](size_t keys) {
+      fc::variants key_weights;
+      for (size_t i = 0; i < keys; ++i)
+         key_weights.emplace_back(fc::mutable_variant_object()("key", key)("weight", 1));
+      return fc::mutable_variant_object()
+         ("threshold", 1)
+         ("keys", std::move(key_weights))
+         ("accounts", fc::variants{fc::mutable_variant_object()
+            ("permission", fc::mutable_variant_object()("actor", "eosio")("permission", "active"))
+            ("weight", 1)})
+         ("waits", fc::variants{});
+   };
+   encode_decode(bios_abis, "newaccount", "newaccount", fc::mutable_variant_object()
+      ("creator", "eosio")
+      ("name", "alice")
+      ("owner", make_authority(1))
+      ("active", make_authority(3)));
+
+   fc::variants producers;
+   for (char c = 'a'; c <= 'u'; ++c)
+      producers.emplace_back(fc::mutable_variant_object()
+         ("producer_name", std::string("producer") + c)
+         ("authority", fc::variants{"block_signing_authority_v0", fc::mutable_variant_object()
+            ("threshold", 1)
+            ("keys", fc::variants{fc::mutable_variant_object()("key", key)("weight", 1)})}));
+   encode_decode(bios_abis, "setprods", "setprods", fc::mutable_variant_object()
+      ("schedule", std::move(producers)));
+}
+
+} // benchmark
@@ -0,0 +1,57 @@
+#include <eosio/chain/authority_checker.hpp>
+#include <fc/crypto/private_key.hpp>
+
+#include <benchmark.hpp>
+
+using namespace eosio::chain;
+
+namespace benchmark {
+
+namespace {
+
+public_key_type make_key(const std::string& seed) {
+   return fc::crypto::private_key::regenerate<fc::ecc::private_key_shim>(fc::sha256::hash(seed)).get_public_key();
+}
+
+authority make_key_authority(uint32_t threshold, const std::vector<public_key_type>& keys) {
+   authority auth(threshold, {}, {}, {});
+   for (const auto& k : keys)
+      auth.keys.push_back(key_weight{k, 1});
+   std::sort(auth.keys.begin(), auth.keys.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+   return auth;
+}
+
+} // namespace
+
+void authority_benchmarking() {
+   std::vector<public_key_type> keys;
+   for (int i = 0; i < 5; ++i)
+      keys.push_back(make_key("authority benchmark key " + std::to_string(i)));
+
+   // actor@active of three accounts, each satisfied by its own key; looked up like authorization_manager does
+   std::map<permission_level, authority> permissions;
+   for (int i = 0; i < 3; ++i)
+      permissions[permission_level{name("account" + std::to_string(i + 1)), config::active_name}] = make_key_authority(1, {keys[i]});
+   auto permission_to_authority = [&](const permission_level& p) -> const authority& { return permissions.at(p); };
+   const std::function<void()> checktime = []() {};
+
+   auto check = [&](const std::string& label, const authority& auth, const flat_set<public_key_type>& provided) {
+      EOS_ASSERT(make_auth_checker(permission_to_authority, config::default_max_auth_depth, provided, {}, fc::microseconds(0), checktime)
+                    .satisfied(auth),
+                 authorization_exception, "benchmark authority ${l} not satisfied", ("l", label));
+      benchmarking("authority_checker " + label, [&]() {
+         auto checker = make_auth_checker(permission_to_authority, config::default_max_auth_depth, provided, {}, fc::microseconds(0), checktime);
+         checker.satisfied(auth);
+      });
+   };
+
+   check("1 of 1 key", make_key_authority(1, {keys[0]}), {keys[0]});
+   check("3 of 5 keys", make_key_authority(3, keys), {keys[1], keys[2], keys[4]});
+
+   authority nested(2, {}, {}, {});
+   for (const auto& [level, auth] : permissions)
+      nested.accounts.push_back(permission_level_weight{level, 1});
+   check("2 of 3 accounts", nested, {keys[1], keys[2]});
+}
+
+} // benchmark
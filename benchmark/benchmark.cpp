@@ -3,6 +3,9 @@
 #include <iomanip>
 #include <locale>
 
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
 #include <benchmark.hpp>
 
 namespace benchmark {
@@ -15,6 +18,11 @@ std::map<std::string, std::function<void()>> features {
    { "key", key_benchmarking },
    { "hash", hash_benchmarking },
    { "blake2", blake2_benchmarking },
+   { "json", json_benchmarking },
+   { "abi", abi_benchmarking },
+   { "block", block_benchmarking },
+   { "authority", authority_benchmarking },
+   { "chain", chain_benchmarking },
 };
 
 // values to control cout format
@@ -24,6 +32,9 @@ constexpr auto time_width = 12;
 constexpr auto ns_width = 2;
 
 uint32_t num_runs = 1;
+uint32_t num_chain_runs = 1;
+output_format format = output_format::text;
+std::string current_feature;
 
 std::map<std::string, std::function<void()>> get_features() {
    return features;
@@ -33,7 +44,17 @@ void set_num_runs(uint32_t runs) {
    num_runs = runs;
 }
 
+void set_num_chain_runs(uint32_t runs) {
+   num_chain_runs = runs;
+}
+
+void set_output_format(output_format f) {
+   format = f;
+}
+
 void print_header() {
+   if (format == output_format::json)
+      return;
    std::cout << std::left << std::setw(name_width) << "function"
       << std::setw(runs_width) << "runs"
       << std::setw(time_width + ns_width) << std::right << "average"
@@ -42,7 +63,30 @@ void print_header() {
       << std::endl << std::endl;
 }
 
+void print_feature(const std::string& name) {
+   current_feature = name;
+   if (format == output_format::text)
+      std::cout << name << ":" << std::endl;
+}
+
+// one JSON object per line, so results can be appended to a file and compared across versions
+void print_json_results(const std::string& name, uint32_t runs, uint64_t total, uint64_t min, uint64_t max) {
+   std::cout << fc::json::to_string(fc::mutable_variant_object()
+                                       ("feature", current_feature)
+                                       ("function", name)
+                                       ("runs", runs)
+                                       ("average_ns", total/runs)
+                                       ("minimum_ns", min)
+                                       ("maximum_ns", max),
+                                    fc::time_point::maximum())
+             << std::endl;
+}
+
 void print_results(std::string name, uint32_t runs, uint64_t total, uint64_t min, uint64_t max) {
+   if (format == output_format::json) {
+      print_json_results(name, runs, total, min, max);
+      return;
+   }
    std::cout.imbue(std::locale(""));
    std::cout
       << std::setw(name_width) << std::left << name
@@ -63,9 +107,15 @@ bytes to_bytes(const std::string& source) {
 };
 
 void benchmarking(std::string name, const std::function<void()>& func) {
+   benchmarking(std::move(name), func, {});
+}
+
+void run_benchmarking(std::string name, uint32_t runs, const std::function<void()>& func, const std::function<void()>& prepare) {
    uint64_t total {0}, min {std::numeric_limits<uint64_t>::max()}, max {0};
 
-   for (auto i = 0U; i < num_runs; ++i) {
+   for (auto i = 0U; i < runs; ++i) {
+      if (prepare)
+         prepare();
       auto start_time = std::chrono::high_resolution_clock::now();
       func();
       auto end_time = std::chrono::high_resolution_clock::now();
@@ -76,7 +126,15 @@ void benchmarking(std::string name, const std::function<void()>& func) {
       max = std::max(max, duration);
    }
 
-   print_results(name, num_runs, total, min, max);
+   print_results(name, runs, total, min, max);
+}
+
+void benchmarking(std::string name, const std::function<void()>& func, const std::function<void()>& prepare) {
+   run_benchmarking(std::move(name), num_runs, func, prepare);
+}
+
+void benchmarking_chain(std::string name, const std::function<void()>& func, const std::function<void()>& prepare) {
+   run_benchmarking(std::move(name), num_chain_runs, func, prepare);
 }
 
 } // benchmark
@@ -9,9 +9,14 @@
 namespace benchmark {
 using bytes = std::vector<char>;
 
+enum class output_format { text, json };
+
 void set_num_runs(uint32_t runs);
+void set_num_chain_runs(uint32_t runs);
+void set_output_format(output_format format);
 std::map<std::string, std::function<void()>> get_features();
 void print_header();
+void print_feature(const std::string& name);
 bytes to_bytes(const std::string& source);
 
 void alt_bn_128_benchmarking();
@@ -19,7 +24,16 @@ void modexp_benchmarking();
 void key_benchmarking();
 void hash_benchmarking();
 void blake2_benchmarking();
+void json_benchmarking();
+void abi_benchmarking();
+void block_benchmarking();
+void authority_benchmarking();
+void chain_benchmarking();
 
 void benchmarking(std::string name, const std::function<void()>& func);
+// `prepare` runs untimed before each timed call of `func`
+void benchmarking(std::string name, const std::function<void()>& func, const std::function<void()>& prepare);
+// like benchmarking(), but runs the number of times set by set_num_chain_runs(), for functions driving a whole chain
+void benchmarking_chain(std::string name, const std::function<void()>& func, const std::function<void()>& prepare);
 
 } // benchmark
@@ -0,0 +1,56 @@
+#include <eosio/chain/block_log.hpp>
+#include <fc/bitutil.hpp>
+#include <fc/io/raw.hpp>
+
+#include <token_tester.hpp>
+
+#include <benchmark.hpp>
+
+using namespace eosio::chain;
+
+namespace benchmark {
+
+void block_benchmarking() {
+   constexpr uint32_t trxs_per_block = 100;
+   token_tester t(trxs_per_block + 1);
+   const signed_block_ptr block = t.produce_transfer_block(trxs_per_block);
+   const auto label = std::to_string(block->transactions.size()) + " trxs";
+
+   const bytes packed = fc::raw::pack(*block);
+   benchmarking("fc::raw pack signed_block " + label, [&]() {
+      fc::raw::pack(*block);
+   });
+   benchmarking("fc::raw unpack signed_block " + label, [&]() {
+      fc::raw::unpack<signed_block>(packed);
+   });
+
+   const auto resolver = t.get_resolver();
+   const auto yield = abi_serializer::create_yield_function(t.abi_serializer_max_time);
+   benchmarking("abi to_variant signed_block " + label, [&]() {
+      fc::variant v;
+      abi_serializer::to_variant(*block, v, resolver, yield);
+   });
+
+   // block_log append/read of copies of the block renumbered 2, 3, ...
+   fc::temp_directory dir;
+   block_log log(dir.path());
+   log.reset(genesis_state(), std::make_shared<signed_block>());
+   uint32_t block_num = 1;
+   signed_block_ptr next;
+   benchmarking("block_log append " + label, [&]() {
+      log.append(next, next->calculate_id());
+   }, [&]() {
+      next = std::make_shared<signed_block>(block->clone());
+      next->previous._hash[0] = fc::endian_reverse_u32(block_num++);
+   });
+   log.flush();
+
+   uint32_t read_num = 1;
+   benchmarking("block_log read_block_by_num " + label, [&]() {
+      log.read_block_by_num(read_num);
+   }, [&]() {
+      read_num = read_num % block_num + 1;
+   });
+}
+
+} // benchmark
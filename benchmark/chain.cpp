@@ -0,0 +1,66 @@
+#include <token_tester.hpp>
+
+#include <benchmark.hpp>
+
+using namespace eosio::chain;
+
+namespace benchmark {
+
+// end-to-end push_transaction through controller, eosio.token running in the configured wasm runtime
+void chain_benchmarking() {
+   constexpr uint32_t num_accounts = 100;
+   constexpr uint32_t trxs_per_block = 100;
+   token_tester t(num_accounts);
+
+   // a token nobody holds, so open stores a row and close removes it again
+   t.push_action(token_tester::token_account, "create"_n, token_tester::token_account, fc::mutable_variant_object()
+      ("issuer", token_tester::token_account)
+      ("maximum_supply", "1000.00000000 TST"));
+   t.produce_block();
+
+   std::optional<signed_transaction> trx;
+   uint32_t pushed = 0;
+   auto next_block = [&]() {
+      if (++pushed % trxs_per_block == 0)
+         t.produce_block();
+   };
+
+   // db_find_i64, db_get_i64 and two db_update_i64
+   benchmarking_chain("push_transaction transfer", [&]() {
+      t.push_transaction(*trx, fc::time_point::maximum(), 0);
+   }, [&]() {
+      next_block();
+      trx = t.make_transfer(pushed, pushed + 1);
+   });
+
+   // db_store_i64 then db_remove_i64 of the same row
+   benchmarking_chain("push_transaction open+close", [&]() {
+      t.push_transaction(*trx, fc::time_point::maximum(), 0);
+   }, [&]() {
+      next_block();
+      const name owner = t.accounts[pushed % num_accounts];
+      trx.emplace();
+      trx->actions.emplace_back(vector<permission_level>{{owner, config::active_name}}, token_tester::token_account, "open"_n,
+                                t.pack_token_action("open"_n, fc::mutable_variant_object()
+                                   ("owner", owner)
+                                   ("symbol", "8,TST")
+                                   ("ram_payer", owner)));
+      trx->actions.emplace_back(vector<permission_level>{{owner, config::active_name}}, token_tester::token_account, "close"_n,
+                                t.pack_token_action("close"_n, fc::mutable_variant_object()
+                                   ("owner", owner)
+                                   ("symbol", "8,TST")));
+      t.set_transaction_headers(*trx);
+      trx->sign(t.get_private_key(owner, "active"), t.control->get_chain_id());
+   });
+
+   benchmarking_chain("produce_block 100 transfers", [&]() {
+      t.produce_block();
+   }, [&]() {
+      for (uint32_t i = 0; i < trxs_per_block; ++i) {
+         auto transfer = t.make_transfer(i, i + 1);
+         t.push_transaction(transfer, fc::time_point::maximum(), 0);
+      }
+   });
+}
+
+} // benchmark
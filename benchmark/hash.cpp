@@ -4,6 +4,7 @@
 #include <fc/crypto/sha256.hpp>
 #include <fc/crypto/sha512.hpp>
 #include <fc/crypto/ripemd160.hpp>
+#include <fc/io/raw.hpp>
 #include <fc/utility.hpp>
 
 #include <benchmark.hpp>
@@ -44,6 +45,36 @@ void hash_benchmarking() {
    };
    benchmarking("sha256 (" + std::to_string(large_message.length()) + " bytes)", sha256_large_msg);
 
+   // merkle root of 1k/10k leaves: one hash per node as eosio::chain::merkle used to do, vs one hash_many per level
+   for (size_t leaves : {1000, 10000}) {
+      std::vector<fc::sha256> ids(leaves);
+      for (size_t i = 0; i < leaves; ++i)
+         ids[i] = fc::sha256::hash(std::to_string(i));
+
+      auto merkle_per_node = [&]() {
+         auto level = ids;
+         while (level.size() > 1) {
+            if (level.size() % 2)
+               level.push_back(level.back());
+            for (size_t i = 0; i < level.size() / 2; ++i)
+               level[i] = fc::sha256::hash(std::make_pair(level[2 * i], level[2 * i + 1]));
+            level.resize(level.size() / 2);
+         }
+      };
+      benchmarking("sha256 merkle per node (" + std::to_string(leaves) + " leaves)", merkle_per_node);
+
+      auto merkle_hash_many = [&]() {
+         auto level = ids;
+         while (level.size() > 1) {
+            if (level.size() % 2)
+               level.push_back(level.back());
+            fc::sha256::hash_many(level.front().data(), 2 * sizeof(fc::sha256), level.size() / 2, level.data());
+            level.resize(level.size() / 2);
+         }
+      };
+      benchmarking("sha256 merkle hash_many (" + std::to_string(leaves) + " leaves)", merkle_hash_many);
+   }
+
    auto sha512_small_msg = [&]() {
       fc::sha512::hash(small_message);
    };
@@ -0,0 +1,118 @@
+#include <fc/io/json.hpp>
+#include <fc/io/json_baseline.hpp>
+#include <fc/variant_object.hpp>
+
+#include <benchmark.hpp>
+
+namespace benchmark {
+
+// push_transaction style request: an eosio.token transfer
+static const std::string transaction_json = R"=====({
+   "signatures": ["SIG_K1_K5PGhrkUBkThs8zdTD9mGUJZvxL4eU46UjfYJSEdZ9PXS2Cgv5jAk57yTx4xnrdSocQm6DDvTaEJZi5WLBsoZC4XYNS8b3"],
+   "compression": "none",
+   "packed_context_free_data": "",
+   "packed_trx": "8468635b7f379feeb95500000000010000000000ea305500409e9a2264b89a010000000000ea305500000000a8ed3232660000000000ea305500a6823403ea30550100000001000240cc0bf90a5656c8bb81f0eb86f49f89613c5cd988c018715d4646c6bd0ad3d8010000000100000001000240cc0bf90a5656c8bb81f0eb86f49f89613c5cd988c018715d4646c6bd0ad3d80100000000",
+   "transaction": {
+      "expiration": "2018-08-02T20:24:36",
+      "ref_block_num": 14207,
+      "ref_block_prefix": 1438248607,
+      "max_net_usage_words": 0,
+      "max_cpu_usage_ms": 0,
+      "delay_sec": 0,
+      "context_free_actions": [],
+      "actions": [{
+         "account": "eosio.token",
+         "name": "transfer",
+         "authorization": [{"actor": "alice", "permission": "active"}],
+         "data": {"from": "alice", "to": "bob", "quantity": "1.00000000 WAX", "memo": "payment for order #12345, thank you! éè"},
+         "hex_data": "0000000000855c340000000000000e3d00e1f5050000000008574158000000002870617966656e7420666f72206f726465722023313233343520"
+      }],
+      "transaction_extensions": []
+   }
+})=====";
+
+// get_table_rows style response: rows of NFT assets with nested data
+static std::string make_table_rows_json(size_t num_rows) {
+   fc::variants rows;
+   rows.reserve(num_rows);
+   for (size_t i = 0; i < num_rows; ++i) {
+      rows.emplace_back(fc::mutable_variant_object()
+         ("asset_id", 1099511627776ull + i)
+         ("collection_name", "alien.worlds")
+         ("schema_name", "tool.worlds")
+         ("template_id", 19552 + i % 100)
+         ("ram_payer", "m.federation")
+         ("backed_tokens", fc::variants{})
+         ("immutable_serialized_data", "0a0b1c2d3e4f5a6b7c8d9e0f1a2b3c4d5e6f7a8b9c0d")
+         ("mutable_serialized_data", "")
+         ("data", fc::mutable_variant_object()("name", "Standard Drill")("img", "QmPGDDScCUgm6mbhXpWEPDRJrvwZVMWcPmrYsonbwJh5Kt")
+                                              ("description", "A \"basic\" drill\nfor mining")));
+   }
+   return fc::json::to_string(fc::mutable_variant_object()("rows", std::move(rows))("more", true)("next_key", "1099511628776"),
+                              fc::time_point::maximum());
+}
+
+// every string value of v, as escaped when emitting it
+static void collect_strings(const fc::variant& v, std::vector<std::string>& out) {
+   if (v.is_string()) {
+      out.push_back(v.get_string());
+   } else if (v.is_array()) {
+      for (const auto& e : v.get_array())
+         collect_strings(e, out);
+   } else if (v.is_object()) {
+      for (const auto& e : v.get_object()) {
+         out.push_back(e.key());
+         collect_strings(e.value(), out);
+      }
+   }
+}
+
+// each benchmark runs the implementation fc::json had before (old) next to the current one (new)
+void json_benchmarking() {
+   const std::string table_rows_json = make_table_rows_json(1000);
+   const auto no_yield = [](size_t) {};
+
+   for (const auto& [name, json] : {std::pair{std::string("trx"), transaction_json},
+                                    std::pair{std::string("table rows"), table_rows_json}}) {
+      const fc::variant v = fc::json::from_string(json);
+
+      auto parse_old = [&]() {
+         fc::json_baseline::from_string(json);
+      };
+      benchmarking("json parse " + name + " (old)", parse_old);
+      auto parse_new = [&]() {
+         fc::json::from_string(json);
+      };
+      benchmarking("json parse " + name + " (new)", parse_new);
+
+      std::vector<std::string> strings;
+      collect_strings(v, strings);
+      auto escape_old = [&]() {
+         for (const auto& str : strings)
+            fc::json_baseline::escape_string(str, no_yield);
+      };
+      benchmarking("json escape " + name + " strings (old)", escape_old);
+      auto escape_new = [&]() {
+         for (const auto& str : strings)
+            fc::escape_string(str, no_yield);
+      };
+      benchmarking("json escape " + name + " strings (new)", escape_new);
+
+      auto emit = [&]() {
+         fc::json::to_string(v, fc::time_point::maximum());
+      };
+      benchmarking("json emit " + name, emit);
+   }
+
+   const std::string long_str(64 * 1024, 'x');
+   auto escape_long_old = [&]() {
+      fc::json_baseline::escape_string(long_str, no_yield);
+   };
+   benchmarking("json escape 64 KiB (old)", escape_long_old);
+   auto escape_long_new = [&]() {
+      fc::escape_string(long_str, no_yield);
+   };
+   benchmarking("json escape 64 KiB (new)", escape_long_new);
+}
+
+} // benchmark
@@ -10,7 +10,9 @@ using bpo::variables_map;
 
 int main(int argc, char* argv[]) {
    uint32_t num_runs = 1;
+   uint32_t num_chain_runs = 1;
    std::string feature_name;
+   std::string output;
 
    auto features = benchmark::get_features();
 
@@ -19,6 +21,8 @@ int main(int argc, char* argv[]) {
       ("feature,f", bpo::value<std::string>(), "feature to be benchmarked; if this option is not present, all features are benchmarked.")
       ("list,l", "list of supported features")
       ("runs,r", bpo::value<uint32_t>(&num_runs)->default_value(1000), "the number of times running a function during benchmarking")
+      ("chain-runs", bpo::value<uint32_t>(&num_chain_runs)->default_value(50), "the number of times running a function that pushes transactions or produces blocks on a chain")
+      ("output,o", bpo::value<std::string>(&output)->default_value("text"), "output format: text, or json for one JSON object per benchmarked function")
       ("help,h", "benchmark functions, and report average, minimum, and maximum execution time in nanoseconds");
 
    variables_map vmap;
@@ -53,6 +57,11 @@ int main(int argc, char* argv[]) {
             return 1;
          }
       }
+
+      if (output != "text" && output != "json") {
+         std::cout << output << " is not a supported output format" << std::endl;
+         return 1;
+      }
    } catch (bpo::unknown_option &ex) {
       std::cerr << ex.what() << std::endl;
       cli.print (std::cerr);
@@ -61,19 +70,24 @@ int main(int argc, char* argv[]) {
       std::cerr << "unknown exception" << std::endl;
    }
 
+   const bool text = output == "text";
    benchmark::set_num_runs(num_runs);
+   benchmark::set_num_chain_runs(num_chain_runs);
+   benchmark::set_output_format(text ? benchmark::output_format::text : benchmark::output_format::json);
    benchmark::print_header();
 
    if (feature_name.empty()) {
       for (auto& [name, f]: features) {
-         std::cout << name << ":" << std::endl;
+         benchmark::print_feature(name);
          f();
-         std::cout << std::endl;
+         if (text)
+            std::cout << std::endl;
       }
    } else {
-      std::cout << feature_name << ":" << std::endl;
+      benchmark::print_feature(feature_name);
       features[feature_name]();
-      std::cout << std::endl;
+      if (text)
+         std::cout << std::endl;
    }
 
    return 0;
@@ -0,0 +1,71 @@
+#include <fc/io/json.hpp>
+
+#include <contracts.hpp>
+
+#include <token_tester.hpp>
+
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+namespace benchmark {
+
+token_tester::token_tester(uint32_t num_accounts) {
+   const auto abi_json = contracts::eosio_token_abi();
+   token_abi = abi_serializer(fc::json::from_string(abi_json.data()).as<abi_def>(),
+                              abi_serializer::create_yield_function(abi_serializer_max_time));
+
+   create_account(token_account);
+   set_code(token_account, contracts::eosio_token_wasm());
+   set_abi(token_account, abi_json.data());
+
+   for (uint32_t i = 0; i < num_accounts; ++i)
+      accounts.push_back(name(std::string("user") + char('a' + i / 26 % 26) + char('a' + i % 26)));
+   create_accounts(accounts);
+
+   push_action(token_account, "create"_n, token_account, fc::mutable_variant_object()
+      ("issuer", token_account)
+      ("maximum_supply", "10000000000.00000000 WAX"));
+   push_action(token_account, "issue"_n, token_account, fc::mutable_variant_object()
+      ("to", token_account)
+      ("quantity", "1000000000.00000000 WAX")
+      ("memo", ""));
+   for (const auto& a : accounts) {
+      push_action(token_account, "transfer"_n, token_account, fc::mutable_variant_object()
+         ("from", token_account)
+         ("to", a)
+         ("quantity", "1000000.00000000 WAX")
+         ("memo", ""));
+   }
+   produce_block();
+}
+
+bytes token_tester::pack_token_action(name action, const fc::variant& data) const {
+   return token_abi.variant_to_binary(token_abi.get_action_type(action), data,
+                                      abi_serializer::create_yield_function(abi_serializer_max_time));
+}
+
+signed_transaction token_tester::make_transfer(uint32_t from_index, uint32_t to_index) {
+   const name from = accounts[from_index % accounts.size()];
+   const name to = accounts[to_index % accounts.size()];
+
+   signed_transaction trx;
+   trx.actions.emplace_back(vector<permission_level>{{from, config::active_name}}, token_account, "transfer"_n,
+                            pack_token_action("transfer"_n, fc::mutable_variant_object()
+                               ("from", from)
+                               ("to", to)
+                               ("quantity", "0.00000001 WAX")
+                               ("memo", "benchmark " + std::to_string(next_memo++))));
+   set_transaction_headers(trx);
+   trx.sign(get_private_key(from, "active"), control->get_chain_id());
+   return trx;
+}
+
+signed_block_ptr token_tester::produce_transfer_block(uint32_t count) {
+   for (uint32_t i = 0; i < count; ++i) {
+      auto trx = make_transfer(i, i + 1);
+      push_transaction(trx, fc::time_point::maximum(), 0);
+   }
+   return produce_block();
+}
+
+} // benchmark
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <eosio/testing/tester.hpp>
+
+namespace benchmark {
+
+// tester with eosio.token deployed and a WAX balance issued to `num_accounts` user accounts
+struct token_tester : eosio::testing::tester {
+   explicit token_tester(uint32_t num_accounts);
+
+   // a signed eosio.token transfer between two user accounts; each call has a unique memo, so a unique id
+   eosio::chain::signed_transaction make_transfer(uint32_t from_index, uint32_t to_index);
+
+   // pushes `count` transfers and produces a block containing them
+   eosio::chain::signed_block_ptr produce_transfer_block(uint32_t count);
+
+   eosio::chain::bytes pack_token_action(eosio::chain::name action, const fc::variant& data) const;
+
+   static constexpr eosio::chain::name token_account = eosio::chain::string_to_name("eosio.token");
+
+   std::vector<eosio::chain::name> accounts;
+   eosio::chain::abi_serializer    token_abi;
+   uint64_t                        next_memo = 0;
+};
+
+} // benchmark
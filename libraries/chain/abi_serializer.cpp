@@ -5,6 +5,8 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <fc/io/varint.hpp>
 
+#include <unordered_map>
+
 namespace eosio { namespace chain {
 
    const size_t abi_serializer::max_recursion_depth;
@@ -80,9 +82,41 @@ namespace eosio { namespace chain {
       set_abi(abi, create_yield_function(max_serialization_time));
    }
 
+   abi_serializer::abi_serializer( const abi_serializer& other )
+   : typedefs(other.typedefs)
+   , structs(other.structs)
+   , actions(other.actions)
+   , tables(other.tables)
+   , error_messages(other.error_messages)
+   , variants(other.variants)
+   , action_results(other.action_results)
+   , built_in_types(other.built_in_types)
+   {
+      copy_type_plans( other );
+   }
+
+   abi_serializer& abi_serializer::operator=( const abi_serializer& other ) {
+      if( this != &other ) {
+         typedefs       = other.typedefs;
+         structs        = other.structs;
+         actions        = other.actions;
+         tables         = other.tables;
+         error_messages = other.error_messages;
+         variants       = other.variants;
+         action_results = other.action_results;
+         built_in_types = other.built_in_types;
+         copy_type_plans( other );
+      }
+      return *this;
+   }
+
    void abi_serializer::add_specialized_unpack_pack( const string& name,
                                                      std::pair<abi_serializer::unpack_function, abi_serializer::pack_function> unpack_pack ) {
+      bool added = built_in_types.find(name) == built_in_types.end();
       built_in_types[name] = std::move( unpack_pack );
+      // a new built-in may shadow an ABI type; replacing an existing one is picked up through the plan's pointer
+      if( added && !type_plans.empty() )
+         compile_type_plans();
    }
 
    void abi_serializer::configure_built_in_types() {
@@ -129,6 +163,10 @@ namespace eosio { namespace chain {
    }
 
    void abi_serializer::set_abi(abi_def abi, const yield_function_t& yield) {
+      // plans hold iterators into the maps cleared below, drop them first so a throw does not leave them dangling
+      type_plans.clear();
+      type_plan_index.clear();
+
       impl::abi_traverse_context ctx(yield);
 
       EOS_ASSERT(starts_with(abi.version, "eosio::abi/1."), unsupported_abi_version_exception, "ABI has an unsupported version");
@@ -186,6 +224,7 @@ namespace eosio { namespace chain {
       EOS_ASSERT( action_results.size() == action_results_size, duplicate_abi_action_results_def_exception, "duplicate action results definition detected" );
 
       validate(ctx);
+      compile_type_plans();
    }
 
    void abi_serializer::set_abi(const abi_def& abi, const fc::microseconds& max_serialization_time) {
@@ -334,6 +373,140 @@ namespace eosio { namespace chain {
       } FC_CAPTURE_AND_RETHROW( (r)  ) }
    }
 
+   void abi_serializer::compile_type_plans() {
+      type_plans.clear();
+      type_plan_index.clear();
+
+      for( const auto& t : typedefs )
+         compile_type_plan( t.first, 0 );
+      for( const auto& s : structs )
+         compile_type_plan( s.first, 0 );
+      for( const auto& v : variants )
+         compile_type_plan( v.first, 0 );
+      for( const auto& a : actions )
+         compile_type_plan( a.second, 0 );
+      for( const auto& t : tables )
+         compile_type_plan( t.second, 0 );
+      for( const auto& r : action_results )
+         compile_type_plan( r.second, 0 );
+   }
+
+   uint32_t abi_serializer::compile_type_plan( const std::string_view& type, size_t depth ) {
+      auto itr = type_plan_index.find( type );
+      if( itr != type_plan_index.end() )
+         return itr->second;
+
+      // reserve the slot first so that recursive types refer back to it
+      const uint32_t index = type_plans.size();
+      type_plan_index.emplace( type_name(type), index );
+      type_plans.emplace_back();
+
+      type_plan plan;
+      plan.type = type_name(type);
+
+      // anything nested deeper than this can never be decoded within max_recursion_depth; leave it to the by-name path
+      if( depth > 2 * max_recursion_depth ) {
+         type_plans[index] = std::move( plan );
+         return index;
+      }
+
+      auto rtype = resolve_type( type );
+      auto ftype = fundamental_type( rtype );
+      auto btype = built_in_types.find( ftype );
+      if( btype != built_in_types.end() ) {
+         plan.k = type_plan::kind::built_in;
+         plan.built_in_name = type_name(ftype);
+         plan.is_array = is_array( rtype );
+         plan.is_optional = is_optional( rtype );
+         plan.built_in = &btype->second;
+      } else if( is_array( rtype ) ) {
+         plan.k = type_plan::kind::array;
+         plan.element = compile_type_plan( ftype, depth + 1 );
+      } else if( is_optional( rtype ) ) {
+         plan.k = type_plan::kind::optional;
+         plan.element = compile_type_plan( ftype, depth + 1 );
+      } else if( auto v_itr = variants.find( rtype ); v_itr != variants.end() ) {
+         plan.k = type_plan::kind::variant;
+         plan.variant_itr = v_itr;
+         plan.alternatives.reserve( v_itr->second.types.size() );
+         for( const auto& t : v_itr->second.types )
+            plan.alternatives.push_back( compile_type_plan( t, depth + 1 ) );
+      } else if( auto s_itr = structs.find( rtype ); s_itr != structs.end() ) {
+         const auto& st = s_itr->second;
+         plan.k = type_plan::kind::structure;
+         plan.struct_itr = s_itr;
+         if( st.base != type_name() ) {
+            plan.base = compile_type_plan( resolve_type( st.base ), depth + 1 );
+            if( type_plans[*plan.base].k != type_plan::kind::structure )
+               plan.k = type_plan::kind::unresolved; // base is not a struct, report through the by-name path
+         }
+         plan.fields.reserve( st.fields.size() );
+         for( const auto& f : st.fields ) {
+            type_plan::field field;
+            auto field_type = _remove_bin_extension( f.type );
+            field.plan = compile_type_plan( field_type, depth + 1 );
+            field.extension = ends_with( f.type, "$" );
+            field.optional = is_optional( f.type );
+            field.is_bytes = resolve_type( field_type ) == "bytes";
+            plan.fields.push_back( field );
+         }
+      }
+
+      type_plans[index] = std::move( plan );
+      return index;
+   }
+
+   namespace {
+      /// iterators into `to` by the address of the value they correspond to in `from`, of which `to` is a copy
+      template<typename Map>
+      std::unordered_map<const void*, typename Map::const_iterator> copied_iterators( const Map& from, const Map& to ) {
+         std::unordered_map<const void*, typename Map::const_iterator> r;
+         r.reserve( from.size() );
+         for( auto f = from.cbegin(), t = to.cbegin(); f != from.cend(); ++f, ++t )
+            r.emplace( &f->second, t );
+         return r;
+      }
+   }
+
+   void abi_serializer::copy_type_plans( const abi_serializer& other ) {
+      type_plans = other.type_plans;
+      type_plan_index = other.type_plan_index;
+      if( type_plans.empty() )
+         return;
+
+      // the maps were copied from `other` in order, rebind the plans to the same entries of our copies
+      const auto struct_itrs = copied_iterators( other.structs, structs );
+      const auto variant_itrs = copied_iterators( other.variants, variants );
+      const auto built_in_itrs = copied_iterators( other.built_in_types, built_in_types );
+      for( auto& plan : type_plans ) {
+         switch( plan.k ) {
+            case type_plan::kind::built_in:
+               plan.built_in = &built_in_itrs.at( plan.built_in )->second;
+               break;
+            case type_plan::kind::variant:
+               plan.variant_itr = variant_itrs.at( &plan.variant_itr->second );
+               break;
+            case type_plan::kind::structure:
+               plan.struct_itr = struct_itrs.at( &plan.struct_itr->second );
+               break;
+            case type_plan::kind::unresolved:
+               plan.struct_itr = {}; // a struct whose base is not a struct, never followed
+               break;
+            case type_plan::kind::array:
+            case type_plan::kind::optional:
+               break;
+         }
+      }
+   }
+
+   const abi_serializer::type_plan* abi_serializer::find_type_plan( const std::string_view& type )const {
+      auto itr = type_plan_index.find( type );
+      if( itr == type_plan_index.end() )
+         return nullptr;
+      const auto& plan = type_plans[itr->second];
+      return plan.k == type_plan::kind::unresolved ? nullptr : &plan;
+   }
+
    std::string_view abi_serializer::resolve_type(const std::string_view& type)const {
       auto itr = typedefs.find(type);
       if( itr != typedefs.end() ) {
@@ -396,6 +569,9 @@ namespace eosio { namespace chain {
    fc::variant abi_serializer::_binary_to_variant( const std::string_view& type, fc::datastream<const char *>& stream,
                                                    impl::binary_to_variant_context& ctx )const
    {
+      if( const auto* plan = find_type_plan(type) )
+         return _binary_to_variant(*plan, stream, ctx);
+
       auto h = ctx.enter_scope();
       auto rtype = resolve_type(type);
       auto ftype = fundamental_type(rtype);
@@ -456,6 +632,110 @@ namespace eosio { namespace chain {
       return fc::variant( std::move(mvo) );
    }
 
+   void abi_serializer::_binary_to_variant( const type_plan& plan, fc::datastream<const char *>& stream,
+                                            fc::mutable_variant_object& obj, impl::binary_to_variant_context& ctx )const
+   {
+      auto h = ctx.enter_scope();
+      ctx.hint_struct_type_if_in_array( plan.struct_itr );
+      const auto& st = plan.struct_itr->second;
+      if( plan.base ) {
+         _binary_to_variant(type_plans[*plan.base], stream, obj, ctx);
+      }
+      bool encountered_extension = false;
+      for( uint32_t i = 0; i < plan.fields.size(); ++i ) {
+         const auto& field = plan.fields[i];
+         encountered_extension |= field.extension;
+         if( !stream.remaining() ) {
+            if( field.extension ) {
+               continue;
+            }
+            if( encountered_extension ) {
+               EOS_THROW( abi_exception, "Encountered field '${f}' without binary extension designation while processing struct '${p}'",
+                          ("f", ctx.maybe_shorten(st.fields[i].name))("p", ctx.get_path_string()) );
+            }
+            EOS_THROW( unpack_exception, "Stream unexpectedly ended; unable to unpack field '${f}' of struct '${p}'",
+                       ("f", ctx.maybe_shorten(st.fields[i].name))("p", ctx.get_path_string()) );
+
+         }
+         auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = plan.struct_itr, .field_ordinal = i } );
+         auto v = _binary_to_variant(type_plans[field.plan], stream, ctx);
+         if( ctx.is_logging() && v.is_string() && field.is_bytes ) {
+            fc::mutable_variant_object sub_obj;
+            auto size = v.get_string().size() / 2; // half because it is in hex
+            sub_obj( "size", size );
+            if( size > impl::hex_log_max_size ) {
+               sub_obj( "trimmed_hex", v.get_string().substr( 0, impl::hex_log_max_size*2 ) );
+            } else {
+               sub_obj( "hex", std::move( v ) );
+            }
+            obj( st.fields[i].name, std::move(sub_obj) );
+         } else {
+            obj( st.fields[i].name, std::move(v) );
+         }
+      }
+   }
+
+   fc::variant abi_serializer::_binary_to_variant( const type_plan& plan, fc::datastream<const char *>& stream,
+                                                   impl::binary_to_variant_context& ctx )const
+   {
+      if( plan.k == type_plan::kind::unresolved )
+         return _binary_to_variant(plan.type, stream, ctx);
+
+      auto h = ctx.enter_scope();
+      if( plan.k == type_plan::kind::built_in ) {
+         try {
+            return plan.built_in->first(stream, plan.is_array, plan.is_optional, ctx.get_yield_function());
+         } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack ${class} type '${type}' while processing '${p}'",
+                                   ("class", plan.is_array ? "array of built-in" : plan.is_optional ? "optional of built-in" : "built-in")
+                                   ("type", impl::limit_size(plan.built_in_name))("p", ctx.get_path_string()) )
+      }
+      switch( plan.k ) {
+         case type_plan::kind::array: {
+            ctx.hint_array_type_if_in_array();
+            fc::unsigned_int size;
+            try {
+               fc::raw::unpack(stream, size);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack size of array '${p}'", ("p", ctx.get_path_string()) )
+            vector<fc::variant> vars;
+            auto h1 = ctx.push_to_path( impl::array_index_path_item{} );
+            const auto& element = type_plans[plan.element];
+            for( decltype(size.value) i = 0; i < size; ++i ) {
+               ctx.set_array_index_of_path_back(i);
+               vars.emplace_back( _binary_to_variant(element, stream, ctx) );
+            }
+            return fc::variant( std::move(vars) );
+         }
+         case type_plan::kind::optional: {
+            char flag;
+            try {
+               fc::raw::unpack(stream, flag);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack presence flag of optional '${p}'", ("p", ctx.get_path_string()) )
+            return flag ? _binary_to_variant(type_plans[plan.element], stream, ctx) : fc::variant();
+         }
+         case type_plan::kind::variant: {
+            const auto& v_itr = plan.variant_itr;
+            ctx.hint_variant_type_if_in_array( v_itr );
+            fc::unsigned_int select;
+            try {
+               fc::raw::unpack(stream, select);
+            } EOS_RETHROW_EXCEPTIONS( unpack_exception, "Unable to unpack tag of variant '${p}'", ("p", ctx.get_path_string()) )
+            EOS_ASSERT( (size_t)select < v_itr->second.types.size(), unpack_exception,
+                        "Unpacked invalid tag (${select}) for variant '${p}'", ("select", select.value)("p",ctx.get_path_string()) );
+            auto h1 = ctx.push_to_path( impl::variant_path_item{ .variant_itr = v_itr, .variant_ordinal = static_cast<uint32_t>(select) } );
+            return vector<fc::variant>{v_itr->second.types[select], _binary_to_variant(type_plans[plan.alternatives[select]], stream, ctx)};
+         }
+         case type_plan::kind::built_in:
+         case type_plan::kind::structure:
+         case type_plan::kind::unresolved:
+            break;
+      }
+
+      fc::mutable_variant_object mvo;
+      _binary_to_variant(plan, stream, mvo, ctx);
+      EOS_ASSERT( mvo.size() > 0, unpack_exception, "Unable to unpack '${p}' from stream", ("p", ctx.get_path_string()) );
+      return fc::variant( std::move(mvo) );
+   }
+
    fc::variant abi_serializer::_binary_to_variant( const std::string_view& type, const bytes& binary, impl::binary_to_variant_context& ctx )const
    {
       auto h = ctx.enter_scope();
@@ -485,6 +765,9 @@ namespace eosio { namespace chain {
 
    void abi_serializer::_variant_to_binary( const std::string_view& type, const fc::variant& var, fc::datastream<char *>& ds, impl::variant_to_binary_context& ctx )const
    { try {
+      if( const auto* plan = find_type_plan(type) )
+         return _variant_to_binary(*plan, var, ds, ctx);
+
       auto h = ctx.enter_scope();
       auto rtype = resolve_type(type);
 
@@ -589,6 +872,125 @@ namespace eosio { namespace chain {
       }
    } FC_CAPTURE_AND_RETHROW() }
 
+   void abi_serializer::_variant_to_binary( const type_plan& plan, const fc::variant& var, fc::datastream<char *>& ds, impl::variant_to_binary_context& ctx )const
+   { try {
+      if( plan.k == type_plan::kind::unresolved )
+         return _variant_to_binary(plan.type, var, ds, ctx);
+
+      auto h = ctx.enter_scope();
+      switch( plan.k ) {
+         case type_plan::kind::built_in:
+            plan.built_in->second(var, ds, plan.is_array, plan.is_optional, ctx.get_yield_function());
+            break;
+         case type_plan::kind::array: {
+            ctx.hint_array_type_if_in_array();
+            const auto& vars = var.get_array();
+            fc::raw::pack(ds, (fc::unsigned_int)vars.size());
+
+            auto h1 = ctx.push_to_path( impl::array_index_path_item{} );
+            auto h2 = ctx.disallow_extensions_unless(false);
+
+            const auto& element = type_plans[plan.element];
+            int64_t i = 0;
+            for (const auto& var : vars) {
+               ctx.set_array_index_of_path_back(i);
+               _variant_to_binary(element, var, ds, ctx);
+               ++i;
+            }
+            break;
+         }
+         case type_plan::kind::optional: {
+            char flag = !var.is_null();
+            fc::raw::pack(ds, flag);
+            if( flag ) {
+               _variant_to_binary(type_plans[plan.element], var, ds, ctx);
+            }
+            break;
+         }
+         case type_plan::kind::variant: {
+            const auto& v_itr = plan.variant_itr;
+            ctx.hint_variant_type_if_in_array( v_itr );
+            auto& v = v_itr->second;
+            EOS_ASSERT( var.is_array() && var.size() == 2, pack_exception,
+                       "Expected input to be an array of two items while processing variant '${p}'", ("p", ctx.get_path_string()) );
+            EOS_ASSERT( var[size_t(0)].is_string(), pack_exception,
+                       "Encountered non-string as first item of input array while processing variant '${p}'", ("p", ctx.get_path_string()) );
+            const auto& variant_type_str = var[size_t(0)].get_string();
+            auto it = find(v.types.begin(), v.types.end(), variant_type_str);
+            EOS_ASSERT( it != v.types.end(), pack_exception,
+                        "Specified type '${t}' in input array is not valid within the variant '${p}'",
+                        ("t", ctx.maybe_shorten(variant_type_str))("p", ctx.get_path_string()) );
+            const auto select = static_cast<uint32_t>(it - v.types.begin());
+            fc::raw::pack(ds, fc::unsigned_int(select));
+            auto h1 = ctx.push_to_path( impl::variant_path_item{ .variant_itr = v_itr, .variant_ordinal = select } );
+            _variant_to_binary( type_plans[plan.alternatives[select]], var[size_t(1)], ds, ctx );
+            break;
+         }
+         case type_plan::kind::structure: {
+            const auto& s_itr = plan.struct_itr;
+            ctx.hint_struct_type_if_in_array( s_itr );
+            const auto& st = s_itr->second;
+
+            if( var.is_object() ) {
+               const auto& vo = var.get_object();
+
+               if( plan.base ) {
+                  auto h2 = ctx.disallow_extensions_unless(false);
+                  _variant_to_binary(type_plans[*plan.base], var, ds, ctx);
+               }
+               bool disallow_additional_fields = false;
+               for( uint32_t i = 0; i < plan.fields.size(); ++i ) {
+                  const auto& field = plan.fields[i];
+                  const auto& name = st.fields[i].name;
+                  auto itr = vo.find(name);
+                  bool present = itr != vo.end();
+                  if( present || field.optional ) {
+                     if( disallow_additional_fields )
+                        EOS_THROW( pack_exception, "Unexpected field '${f}' found in input object while processing struct '${p}'",
+                                   ("f", ctx.maybe_shorten(name))("p", ctx.get_path_string()) );
+                     {
+                        auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = s_itr, .field_ordinal = i } );
+                        auto h2 = ctx.disallow_extensions_unless( i + 1 == plan.fields.size() );
+                        _variant_to_binary(type_plans[field.plan], present ? itr->value() : fc::variant(nullptr), ds, ctx);
+                     }
+                  } else if( field.extension && ctx.extensions_allowed() ) {
+                     disallow_additional_fields = true;
+                  } else if( disallow_additional_fields ) {
+                     EOS_THROW( abi_exception, "Encountered field '${f}' without binary extension designation while processing struct '${p}'",
+                                ("f", ctx.maybe_shorten(name))("p", ctx.get_path_string()) );
+                  } else {
+                     EOS_THROW( pack_exception, "Missing field '${f}' in input object while processing struct '${p}'",
+                                ("f", ctx.maybe_shorten(name))("p", ctx.get_path_string()) );
+                  }
+               }
+            } else if( var.is_array() ) {
+               const auto& va = var.get_array();
+               EOS_ASSERT( !plan.base, invalid_type_inside_abi,
+                           "Using input array to specify the fields of the derived struct '${p}'; input arrays are currently only allowed for structs without a base",
+                           ("p",ctx.get_path_string()) );
+               for( uint32_t i = 0; i < plan.fields.size(); ++i ) {
+                  const auto& field = plan.fields[i];
+                  if( va.size() > i ) {
+                     auto h1 = ctx.push_to_path( impl::field_path_item{ .parent_struct_itr = s_itr, .field_ordinal = i } );
+                     auto h2 = ctx.disallow_extensions_unless( i + 1 == plan.fields.size() );
+                     _variant_to_binary(type_plans[field.plan], va[i], ds, ctx);
+                  } else if( field.extension && ctx.extensions_allowed() ) {
+                     break;
+                  } else {
+                     EOS_THROW( pack_exception, "Early end to input array specifying the fields of struct '${p}'; require input for field '${f}'",
+                                ("p", ctx.get_path_string())("f", ctx.maybe_shorten(st.fields[i].name)) );
+                  }
+               }
+            } else {
+               EOS_THROW( pack_exception, "Unexpected input encountered while processing struct '${p}'", ("p",ctx.get_path_string()) );
+            }
+            break;
+         }
+         case type_plan::kind::unresolved:
+            break;
+      }
+   } FC_CAPTURE_AND_RETHROW() }
+
    bytes abi_serializer::_variant_to_binary( const std::string_view& type, const fc::variant& var, impl::variant_to_binary_context& ctx )const
    { try {
       auto h = ctx.enter_scope();
@@ -11,6 +11,9 @@
 #include <eosio/chain/code_object.hpp>
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/deep_mind.hpp>
+#include <eosio/chain/table_temperature.hpp>
+#include <eosio/chain/contract_profiler.hpp>
+#include <fc/scoped_exit.hpp>
 #include <boost/container/flat_set.hpp>
 
 using boost::container::flat_set;
@@ -93,6 +96,12 @@ void apply_context::exec_one()
                   control.check_contract_list( receiver );
                   control.check_action_list( act->account, act->name );
                }
+               auto* prof = control.get_contract_profiler();
+               const auto wasm_start = prof ? fc::time_point::now() : fc::time_point();
+               auto record_wasm_time = fc::make_scoped_exit( [&]() {
+                  if( prof )
+                     prof->record( receiver, act->name, fc::time_point::now() - wasm_start );
+               } );
                try {
                   control.get_wasm_interface().apply( receiver_account->code_hash, receiver_account->vm_type, receiver_account->vm_version, *this );
                } catch( const wasm_exit& ) {}
@@ -663,12 +672,19 @@ uint32_t apply_context::schedule_action( action&& act_to_schedule, account_name
 }
 
 const table_id_object* apply_context::find_table( name code, name scope, name table ) {
-   return db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   const auto* tab = db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
+   if( tab ) {
+      if( auto* temp = control.get_table_temperature() )
+         temp->touch( tab->id._id );
+   }
+   return tab;
 }
 
 const table_id_object& apply_context::find_or_create_table( name code, name scope, name table, const account_name &payer ) {
    const auto* existing_tid =  db.find<table_id_object, by_code_scope_table>(boost::make_tuple(code, scope, table));
    if (existing_tid != nullptr) {
+      if( auto* temp = control.get_table_temperature() )
+         temp->touch( existing_tid->id._id );
       return *existing_tid;
    }
 
@@ -683,7 +699,7 @@ const table_id_object& apply_context::find_or_create_table( name code, name scop
 
    update_db_usage(payer, config::billable_size_v<table_id_object>);
 
-   return db.create<table_id_object>([&](table_id_object &t_id){
+   const auto& tid = db.create<table_id_object>([&](table_id_object &t_id){
       t_id.code = code;
       t_id.scope = scope;
       t_id.table = table;
@@ -693,6 +709,9 @@ const table_id_object& apply_context::find_or_create_table( name code, name scop
          dm_logger->on_create_table(t_id);
       }
    });
+   if( auto* temp = control.get_table_temperature() )
+      temp->touch( tid.id._id );
+   return tid;
 }
 
 void apply_context::remove_table( const table_id_object& tid ) {
@@ -0,0 +1,74 @@
+#include <eosio/chain/contract_profiler.hpp>
+
+#include <algorithm>
+
+namespace eosio { namespace chain {
+
+contract_profiler::contract_profiler( size_t max_entries )
+:_max_entries_per_shard( std::max<size_t>( max_entries / num_shards, 1 ) )
+,_since( fc::time_point::now() )
+{
+}
+
+void contract_profiler::record( account_name contract, action_name action, fc::microseconds elapsed ) {
+   const key_t k{ contract, action };
+   const uint64_t us = std::max<int64_t>( elapsed.count(), 0 );
+   auto& s = _shards[key_hash()( k ) % num_shards];
+
+   std::lock_guard g( s.mtx );
+   auto itr = s.entries.find( k );
+   if( itr == s.entries.end() ) {
+      if( s.entries.size() >= _max_entries_per_shard ) {
+         s.untracked_us += us;
+         return;
+      }
+      itr = s.entries.emplace( k, entry{ contract, action } ).first;
+   }
+   auto& e = itr->second;
+   ++e.calls;
+   e.total_us += us;
+   e.max_us = std::max( e.max_us, us );
+}
+
+std::vector<contract_profiler::entry> contract_profiler::top( size_t n ) const {
+   std::vector<entry> result;
+   for( const auto& s : _shards ) {
+      std::lock_guard g( s.mtx );
+      for( const auto& [k, e] : s.entries )
+         result.push_back( e );
+   }
+   auto by_total = []( const entry& a, const entry& b ) { return a.total_us > b.total_us; };
+   if( result.size() > n ) {
+      std::partial_sort( result.begin(), result.begin() + n, result.end(), by_total );
+      result.resize( n );
+   } else {
+      std::sort( result.begin(), result.end(), by_total );
+   }
+   return result;
+}
+
+uint64_t contract_profiler::untracked_us() const {
+   uint64_t result = 0;
+   for( const auto& s : _shards ) {
+      std::lock_guard g( s.mtx );
+      result += s.untracked_us;
+   }
+   return result;
+}
+
+fc::time_point contract_profiler::since() const {
+   std::lock_guard g( _since_mtx );
+   return _since;
+}
+
+void contract_profiler::clear() {
+   for( auto& s : _shards ) {
+      std::lock_guard g( s.mtx );
+      s.entries.clear();
+      s.untracked_us = 0;
+   }
+   std::lock_guard g( _since_mtx );
+   _since = fc::time_point::now();
+}
+
+} } /// eosio::chain
@@ -21,6 +21,9 @@
 #include <eosio/chain/protocol_feature_manager.hpp>
 #include <eosio/chain/authorization_manager.hpp>
 #include <eosio/chain/resource_limits.hpp>
+#include <eosio/chain/state_commitment.hpp>
+#include <eosio/chain/table_temperature.hpp>
+#include <eosio/chain/contract_profiler.hpp>
 #include <eosio/chain/chain_snapshot.hpp>
 #include <eosio/chain/thread_utils.hpp>
 #include <eosio/chain/platform_timer.hpp>
@@ -35,6 +38,7 @@
 
 #include <new>
 #include <shared_mutex>
+#include <unordered_map>
 
 namespace eosio { namespace chain {
 
@@ -70,11 +74,13 @@ class maybe_session {
 
       maybe_session( maybe_session&& other)
       :_session(move(other._session))
+      ,_usage(move(other._usage))
       {
       }
 
-      explicit maybe_session(database& db) {
+      explicit maybe_session(database& db, resource_limits_manager& rl) {
          _session.emplace(db.start_undo_session(true));
+         _usage.emplace(rl);
       }
 
       maybe_session(const maybe_session&) = delete;
@@ -82,16 +88,22 @@ class maybe_session {
       void squash() {
          if (_session)
             _session->squash();
+         if (_usage)
+            _usage->commit();
       }
 
       void undo() {
          if (_session)
             _session->undo();
+         if (_usage)
+            _usage->undo();
       }
 
       void push() {
          if (_session)
             _session->push();
+         if (_usage)
+            _usage->commit();
       }
 
       maybe_session& operator = ( maybe_session&& mv ) {
@@ -101,12 +113,15 @@ class maybe_session {
          } else {
             _session.reset();
          }
+         _usage = move(mv._usage);
+         mv._usage.reset();
 
          return *this;
       };
 
    private:
-      std::optional<database::session>     _session;
+      std::optional<database::session>                          _session;
+      std::optional<resource_limits_manager::usage_checkpoint>  _usage; ///< undone along with _session when batching resource usage
 };
 
 struct building_block {
@@ -233,6 +248,9 @@ struct controller_impl {
    fork_database                   fork_db;
    resource_limits_manager         resource_limits;
    authorization_manager           authorization;
+   state_commitment                state_commit; ///< only maintained when conf.maintain_state_commitment
+   std::unique_ptr<table_temperature> table_temp; ///< only when conf.table_cold_after_blocks > 0
+   std::unique_ptr<contract_profiler> contract_prof; ///< only when conf.profile_contracts
    protocol_feature_manager        protocol_features;
    controller::config              conf;
    const chain_id_type             chain_id; // read by thread_pool threads, value will not be changed
@@ -244,6 +262,18 @@ struct controller_impl {
    uint32_t                        snapshot_head_block = 0;
    struct chain; // chain is a namespace so use an embedded type for the named_thread_pool tag
    named_thread_pool<chain>        thread_pool;
+
+   // blocks whose header state was computed before their predecessor reached fork_db; the producer signature and
+   // transaction merkle root of each are checked on thread_pool in parallel, only the header state chain is serial;
+   // entries are removed when their block is pushed or becomes irreversible, or when far behind a newer entry
+   struct validated_ahead_block {
+      block_state_ptr                      bsp;      // header state, predecessor for the blocks that follow
+      std::shared_future<block_state_ptr>  verified; // completes once signature and merkle root are checked
+   };
+   static constexpr uint32_t                                    max_validation_window_blocks = 1024;
+   std::mutex                                                   validation_window_mtx;
+   std::unordered_map<block_id_type, validated_ahead_block>     validation_window;
+
    deep_mind_handler*              deep_mind_logger = nullptr;
    bool                            okay_to_print_integrity_hash_on_stop = false;
 
@@ -276,6 +306,9 @@ struct controller_impl {
 
       db.undo();
 
+      if( conf.maintain_state_commitment )
+         state_commit.restore_block( prev->id );
+
       protocol_features.popped_blocks_to( prev->block_num );
    }
 
@@ -327,6 +360,13 @@ struct controller_impl {
          if( shutdown ) shutdown();
       } );
 
+      resource_limits.set_batched_usage( conf.batch_resource_usage );
+
+      if( conf.table_cold_after_blocks > 0 )
+         table_temp = std::make_unique<table_temperature>( conf.table_cold_after_blocks );
+      if( conf.profile_contracts )
+         contract_prof = std::make_unique<contract_profiler>();
+
       set_activation_handler<builtin_protocol_feature_t::preactivate_feature>();
       set_activation_handler<builtin_protocol_feature_t::replace_deferred>();
       set_activation_handler<builtin_protocol_feature_t::get_sender>();
@@ -471,6 +511,7 @@ struct controller_impl {
          branch.emplace_back(fork_db.root());
          fork_db.advance_root( root_id );
       }
+      prune_validation_window( fork_db.root()->block_num );
 
       // delete branch in thread pool
       boost::asio::post( thread_pool.get_executor(), [branch{std::move(branch)}]() {} );
@@ -739,6 +780,16 @@ struct controller_impl {
 
       if( check_shutdown() ) return;
 
+      if( conf.maintain_state_commitment ) {
+         if( state_commit.read( conf.state_dir / config::state_commitment_filename, head->id ) ) {
+            ilog( "loaded state commitment at block ${n}: ${c}", ("n", head->block_num)("c", state_commit.digest()) );
+         } else {
+            ilog( "calculating state commitment, this walks the entire chain state..." );
+            state_commit.calculate( db, thread_pool.get_executor() );
+            ilog( "state commitment at block ${n}: ${c}", ("n", head->block_num)("c", state_commit.digest()) );
+         }
+      }
+
       // At this point head != nullptr && fork_db.head() != nullptr && fork_db.root() != nullptr.
       // Furthermore, fork_db.root()->block_num <= lib_num.
       // Also, even though blog.head() may still be nullptr, blog.first_block_num() is guaranteed to be lib_num + 1.
@@ -766,6 +817,8 @@ struct controller_impl {
       //only log this not just if configured to, but also if initialization made it to the point we'd log the startup too
       if(okay_to_print_integrity_hash_on_stop && conf.integrity_hash_on_stop)
          ilog( "chain database stopped with hash: ${hash}", ("hash", calculate_integrity_hash()) );
+      if( conf.maintain_state_commitment && head )
+         state_commit.write( conf.state_dir / config::state_commitment_filename, head->id );
    }
 
    void add_indices() {
@@ -843,7 +896,16 @@ struct controller_impl {
 
    void add_to_snapshot( const snapshot_writer_ptr& snapshot ) {
       // clear in case the previous call to clear did not finish in time of deadline
-      clear_expired_input_transactions( fc::time_point::maximum() );
+      if( conf.maintain_state_commitment && state_commit.valid() && !pending ) {
+         // outside of a block, run in its own session so the state commitment sees the removals
+         auto session = db.start_undo_session( true );
+         clear_expired_input_transactions( fc::time_point::maximum() );
+         state_commit.apply_last_undo_session( db );
+         session.squash();
+         state_commit.record_block( head->id );
+      } else {
+         clear_expired_input_transactions( fc::time_point::maximum() );
+      }
 
       snapshot->write_section<chain_snapshot_header>([this]( auto &section ){
          section.add_row(chain_snapshot_header(), db);
@@ -1017,6 +1079,14 @@ struct controller_impl {
       );
    }
 
+   const state_commitment& calculate_state_commitment() {
+      if( !conf.maintain_state_commitment || !state_commit.valid() ) {
+         EOS_ASSERT( !pending, block_validate_exception, "cannot calculate the state commitment while building a block" );
+         state_commit.calculate( db, thread_pool.get_executor() );
+      }
+      return state_commit;
+   }
+
    sha256 calculate_integrity_hash() {
       sha256::encoder enc;
       auto hash_writer = std::make_shared<integrity_hash_snapshot_writer>(enc);
@@ -1291,7 +1361,7 @@ struct controller_impl {
 
       maybe_session undo_session;
       if ( !self.skip_db_sessions() )
-         undo_session = maybe_session(db);
+         undo_session = maybe_session(db, resource_limits);
 
       auto gtrx = generated_transaction(gto);
 
@@ -1536,7 +1606,8 @@ struct controller_impl {
                                            fc::microseconds max_transaction_time,
                                            uint32_t billed_cpu_time_us,
                                            bool explicit_billed_cpu_time,
-                                           int64_t subjective_cpu_bill_us )
+                                           int64_t subjective_cpu_bill_us,
+                                           const std::function<void()>& on_authorized = {} )
    {
       EOS_ASSERT(block_deadline != fc::time_point(), transaction_exception, "deadline cannot be uninitialized");
 
@@ -1599,6 +1670,8 @@ struct controller_impl {
                        trx->is_dry_run()
                );
             }
+            if( on_authorized )
+               on_authorized();
             trx_context.exec();
             trx_context.finalize(); // Automatically rounds up network and CPU usage in trace and bills payers if successful
 
@@ -1698,6 +1771,9 @@ struct controller_impl {
 
       emit( self.block_start, head->block_num + 1 );
 
+      if( table_temp )
+         table_temp->set_block_num( head->block_num + 1 );
+
       // at block level, no transaction specific logging is possible
       if (auto dm_logger = get_deep_mind_logger(false)) {
          // The head block represents the block just before this one that is about to start, so add 1 to get this block num
@@ -1713,7 +1789,7 @@ struct controller_impl {
          EOS_ASSERT( db.revision() == head->block_num, database_exception, "db revision is not on par with head block",
                      ("db.revision()", db.revision())("controller_head_block", head->block_num)("fork_db_head_block", fork_db.head()->block_num) );
 
-         pending.emplace( maybe_session(db), *head, when, confirm_block_count, new_protocol_feature_activations );
+         pending.emplace( maybe_session(db, resource_limits), *head, when, confirm_block_count, new_protocol_feature_activations );
       } else {
          pending.emplace( maybe_session(), *head, when, confirm_block_count, new_protocol_feature_activations );
       }
@@ -1881,6 +1957,7 @@ struct controller_impl {
       }
 
       // Update resource limits:
+      resource_limits.flush_batched_usage();
       resource_limits.process_account_limit_updates();
       const auto& chain_config = self.get_global_properties().configuration;
       uint64_t CPU_TARGET = EOS_PERCENT(chain_config.max_block_cpu_usage, chain_config.target_block_cpu_usage_pct);
@@ -1972,6 +2049,23 @@ struct controller_impl {
 
       // push the state for pending.
       pending->push();
+
+      if( conf.maintain_state_commitment ) {
+         if( self.skip_db_sessions( s ) ) {
+            state_commit.invalidate(); // no undo session recorded the changes of this block
+         } else {
+            try {
+               state_commit.apply_last_undo_session( db );
+               state_commit.record_block( head->id );
+               if( fork_db.root() )
+                  state_commit.prune_blocks( fork_db.root()->block_num );
+            } catch( const fc::exception& e ) {
+               // the block is committed regardless, recalculate the commitment when it is next requested
+               elog( "unable to update state commitment: ${e}", ("e", e.to_detail_string()) );
+               state_commit.invalidate();
+            }
+         }
+      }
    }
 
    /**
@@ -2073,7 +2167,7 @@ struct controller_impl {
          const bool existing_trxs_metas = !bsp->trxs_metas().empty();
          const bool pub_keys_recovered = bsp->is_pub_keys_recovered();
          const bool skip_auth_checks = self.skip_auth_check();
-         std::vector<std::tuple<transaction_metadata_ptr, recover_keys_future>> trx_metas;
+         std::vector<std::tuple<transaction_metadata_ptr, std::shared_future<transaction_metadata_ptr>>> trx_metas;
          bool use_bsp_cached = false;
          if( pub_keys_recovered || (skip_auth_checks && existing_trxs_metas) ) {
             use_bsp_cached = true;
@@ -2082,36 +2176,48 @@ struct controller_impl {
             for( const auto& receipt : b->transactions ) {
                if( std::holds_alternative<packed_transaction>(receipt.trx)) {
                   const auto& pt = std::get<packed_transaction>(receipt.trx);
+                  const size_t idx = trx_metas.size();
                   transaction_metadata_ptr trx_meta_ptr = trx_lookup ? trx_lookup( pt.id() ) : transaction_metadata_ptr{};
                   if( trx_meta_ptr && *trx_meta_ptr->packed_trx() != pt ) trx_meta_ptr = nullptr;
                   if( trx_meta_ptr && ( skip_auth_checks || !trx_meta_ptr->recovered_keys().empty() ) ) {
-                     trx_metas.emplace_back( std::move( trx_meta_ptr ), recover_keys_future{} );
+                     trx_metas.emplace_back( std::move( trx_meta_ptr ), std::shared_future<transaction_metadata_ptr>{} );
                   } else if( skip_auth_checks ) {
                      packed_transaction_ptr ptrx( b, &pt ); // alias signed_block_ptr
                      trx_metas.emplace_back(
                            transaction_metadata::create_no_recover_keys( std::move(ptrx), transaction_metadata::trx_type::input ),
-                           recover_keys_future{} );
+                           std::shared_future<transaction_metadata_ptr>{} );
+                  } else if( idx < bsp->_trx_recoveries.size() ) {
+                     // started when the block state was created
+                     trx_metas.emplace_back( transaction_metadata_ptr{}, bsp->_trx_recoveries[idx] );
                   } else {
                      packed_transaction_ptr ptrx( b, &pt ); // alias signed_block_ptr
                      auto fut = transaction_metadata::start_recover_keys(
                            std::move( ptrx ), thread_pool.get_executor(), chain_id, microseconds::maximum(), transaction_metadata::trx_type::input  );
-                     trx_metas.emplace_back( transaction_metadata_ptr{}, std::move( fut ) );
+                     trx_metas.emplace_back( transaction_metadata_ptr{}, fut.share() );
                   }
                }
             }
          }
 
          transaction_trace_ptr trace;
+         fc::microseconds recover_keys_time, recover_keys_wait_time;
 
          size_t packed_idx = 0;
          const auto& trx_receipts = std::get<building_block>(pending->_block_stage)._pending_trx_receipts;
          for( const auto& receipt : b->transactions ) {
             auto num_pending_receipts = trx_receipts.size();
             if( std::holds_alternative<packed_transaction>(receipt.trx) ) {
-               const auto& trx_meta = ( use_bsp_cached ? bsp->trxs_metas().at( packed_idx )
-                                                       : ( !!std::get<0>( trx_metas.at( packed_idx ) ) ?
-                                                             std::get<0>( trx_metas.at( packed_idx ) )
-                                                             : std::get<1>( trx_metas.at( packed_idx ) ).get() ) );
+               transaction_metadata_ptr trx_meta;
+               if( use_bsp_cached ) {
+                  trx_meta = bsp->trxs_metas().at( packed_idx );
+               } else if( std::get<0>( trx_metas.at( packed_idx ) ) ) {
+                  trx_meta = std::get<0>( trx_metas.at( packed_idx ) );
+               } else {
+                  auto wait_start = fc::time_point::now();
+                  trx_meta = std::get<1>( trx_metas.at( packed_idx ) ).get();
+                  recover_keys_wait_time += fc::time_point::now() - wait_start;
+               }
+               recover_keys_time += trx_meta->signature_cpu_usage();
                trace = push_transaction( trx_meta, fc::time_point::maximum(), fc::microseconds::maximum(), receipt.cpu_usage_us, true, 0 );
                ++packed_idx;
             } else if( std::holds_alternative<transaction_id_type>(receipt.trx) ) {
@@ -2156,10 +2262,13 @@ struct controller_impl {
          if( !use_bsp_cached ) {
             bsp->set_trxs_metas( std::move( ab._trx_metas ), !skip_auth_checks );
          }
+         bsp->_trx_recoveries.clear(); // only read on the main thread once the block state is shared
          // create completed_block with the existing block_state as we just verified it is the same as assembled_block
          pending->_block_stage = completed_block{ bsp };
 
          br = pending->_block_report; // copy before commit block destroys pending
+         br.recover_keys_time = recover_keys_time;
+         br.recover_keys_wait_time = recover_keys_wait_time;
          commit_block(s);
          br.total_time = fc::time_point::now() - start;
          return;
@@ -2179,6 +2288,24 @@ struct controller_impl {
    } FC_CAPTURE_AND_RETHROW() } /// apply_block
 
 
+   // thread safe, bsp must not be shared yet
+   // recovers the keys of the block's transactions on thread_pool while the block waits to be applied; skipped when
+   // apply_block would not check authorizations, see light_validation_allowed()
+   void start_trx_recoveries( const block_state_ptr& bsp ) {
+      if( read_mode == db_read_mode::IRREVERSIBLE || conf.block_validation_mode != validation_mode::FULL ||
+          conf.trusted_producers.count( bsp->block->producer ) )
+         return;
+      const signed_block_ptr& b = bsp->block;
+      bsp->_trx_recoveries.reserve( b->transactions.size() );
+      for( const auto& receipt : b->transactions ) {
+         if( std::holds_alternative<packed_transaction>(receipt.trx) ) {
+            packed_transaction_ptr ptrx( b, &std::get<packed_transaction>(receipt.trx) ); // alias signed_block_ptr
+            bsp->_trx_recoveries.emplace_back( transaction_metadata::start_recover_keys(
+                  std::move( ptrx ), thread_pool.get_executor(), chain_id, microseconds::maximum(), transaction_metadata::trx_type::input ).share() );
+         }
+      }
+   }
+
    // thread safe, expected to be called from thread other than the main thread
    block_state_ptr create_block_state_i( const block_id_type& id, const signed_block_ptr& b, const block_header_state& prev ) {
       auto trx_mroot = calculate_trx_merkle( b->transactions );
@@ -2199,12 +2326,114 @@ struct controller_impl {
 
       EOS_ASSERT( id == bsp->id, block_validate_exception,
                   "provided id ${id} does not match block id ${bid}", ("id", id)("bid", bsp->id) );
+      start_trx_recoveries( bsp );
       return bsp;
    }
 
+   // thread safe, expected to be called from thread other than the main thread
+   // header state is computed on the calling thread, signature and merkle root are checked on thread_pool
+   validated_ahead_block start_block_validation( const block_id_type& id, const signed_block_ptr& b, const block_header_state& prev ) {
+      const bool skip_validate_signee = true;
+      auto bsp = std::make_shared<block_state>(
+            prev,
+            b,
+            protocol_features.get_protocol_feature_set(),
+            [this]( block_timestamp_type timestamp,
+                    const flat_set<digest_type>& cur_features,
+                    const vector<digest_type>& new_features )
+            { check_protocol_features( timestamp, cur_features, new_features ); },
+            skip_validate_signee
+      );
+
+      EOS_ASSERT( id == bsp->id, block_validate_exception,
+                  "provided id ${id} does not match block id ${bid}", ("id", id)("bid", bsp->id) );
+      start_trx_recoveries( bsp );
+
+      auto verified = post_async_task( thread_pool.get_executor(), [bsp]() {
+         auto trx_mroot = calculate_trx_merkle( bsp->block->transactions );
+         EOS_ASSERT( bsp->block->transaction_mroot == trx_mroot, block_validate_exception,
+                     "invalid block transaction merkle root ${b} != ${c}", ("b", bsp->block->transaction_mroot)("c", trx_mroot) );
+         bsp->verify_signee();
+         return bsp;
+      } );
+
+      return { std::move(bsp), verified.share() };
+   }
+
+   // thread safe
+   void add_to_validation_window( const block_id_type& id, validated_ahead_block&& v ) {
+      const uint32_t block_num = block_header::num_from_id( id );
+      std::lock_guard g( validation_window_mtx );
+      if( validation_window.size() >= max_validation_window_blocks ) {
+         // entries this far behind will not be applied, e.g. successors of a block that failed validation
+         for( auto itr = validation_window.begin(); itr != validation_window.end(); ) {
+            if( block_header::num_from_id( itr->first ) + max_validation_window_blocks <= block_num )
+               itr = validation_window.erase( itr );
+            else
+               ++itr;
+         }
+         if( validation_window.size() >= max_validation_window_blocks )
+            return;
+      }
+      validation_window.emplace( id, std::move(v) );
+   }
+
+   // thread safe, blocks not after lib_num can no longer be applied, e.g. ones of forks that did not become irreversible
+   void prune_validation_window( uint32_t lib_num ) {
+      std::lock_guard g( validation_window_mtx );
+      for( auto itr = validation_window.begin(); itr != validation_window.end(); ) {
+         if( block_header::num_from_id( itr->first ) <= lib_num )
+            itr = validation_window.erase( itr );
+         else
+            ++itr;
+      }
+   }
+
+   // thread safe, returns an invalid future if b was not validated ahead
+   // the id does not cover the producer signature, so an entry of another signed_block with the same id, e.g. a copy
+   // with a forged signature received first, is discarded rather than used for b
+   std::shared_future<block_state_ptr> take_from_validation_window( const block_id_type& id, const signed_block_ptr& b ) {
+      std::lock_guard g( validation_window_mtx );
+      auto itr = validation_window.find( id );
+      if( itr == validation_window.end() )
+         return {};
+      std::shared_future<block_state_ptr> verified;
+      if( itr->second.bsp->block == b )
+         verified = std::move( itr->second.verified );
+      validation_window.erase( itr );
+      return verified;
+   }
+
+   // thread safe, expected to be called from thread other than the main thread
+   // b->previous is not in fork_db yet; if it is in the validation window start validating b against it
+   void validate_ahead( const block_id_type& id, const signed_block_ptr& b ) {
+      block_state_ptr prev;
+      {
+         std::lock_guard g( validation_window_mtx );
+         if( validation_window.count( id ) )
+            return;
+         auto itr = validation_window.find( b->previous );
+         if( itr == validation_window.end() )
+            return;
+         prev = itr->second.bsp;
+      }
+
+      try {
+         add_to_validation_window( id, start_block_validation( id, b, *prev ) );
+      } catch( const fc::exception& e ) {
+         // reported when the block is validated normally once its predecessor is applied
+         dlog( "unable to validate block ${id} ahead: ${e}", ("id", id)("e", e.to_string()) );
+      }
+   }
+
    std::future<block_state_ptr> create_block_state_future( const block_id_type& id, const signed_block_ptr& b ) {
       EOS_ASSERT( b, block_validate_exception, "null block" );
 
+      // validated ahead while its predecessor was still being applied; only usable once the predecessor was accepted
+      if( auto verified = take_from_validation_window( id, b ); verified.valid() && fork_db.get_block_header( b->previous ) && !fork_db.get_block( id ) ) {
+         return std::async( std::launch::deferred, [verified]() { return verified.get(); } );
+      }
+
       return post_async_task( thread_pool.get_executor(), [b, id, control=this]() {
          // no reason for a block_state if fork_db already knows about block
          auto existing = control->fork_db.get_block( id );
@@ -2228,9 +2457,19 @@ struct controller_impl {
 
       // previous not found could mean that previous block not applied yet
       auto prev = fork_db.get_block_header( b->previous );
-      if( !prev ) return {};
+      if( !prev ) {
+         validate_ahead( id, b );
+         return {};
+      }
+
+      auto bsp = create_block_state_i( id, b, *prev );
+
+      // successors arriving before this block is applied are validated against it
+      std::promise<block_state_ptr> verified;
+      verified.set_value( bsp );
+      add_to_validation_window( id, { bsp, verified.get_future().share() } );
 
-      return create_block_state_i( id, b, *prev );
+      return bsp;
    }
 
    void push_block( controller::block_report& br,
@@ -2257,6 +2496,7 @@ struct controller_impl {
          emit( self.pre_accepted_block, b );
 
          fork_db.add( bsp );
+         take_from_validation_window( bsp->id, b );
 
          if (self.is_trusted_producer(b->producer)) {
             trusted_producer_light_validation = true;
@@ -3019,11 +3259,12 @@ void controller::push_block( controller::block_report& br,
 transaction_trace_ptr controller::push_transaction( const transaction_metadata_ptr& trx,
                                                     fc::time_point block_deadline, fc::microseconds max_transaction_time,
                                                     uint32_t billed_cpu_time_us, bool explicit_billed_cpu_time,
-                                                    int64_t subjective_cpu_bill_us ) {
+                                                    int64_t subjective_cpu_bill_us,
+                                                    const std::function<void()>& on_authorized ) {
    validate_db_available_size();
    EOS_ASSERT( get_read_mode() != db_read_mode::IRREVERSIBLE, transaction_type_exception, "push transaction not allowed in irreversible mode" );
    EOS_ASSERT( trx && !trx->implicit() && !trx->scheduled(), transaction_type_exception, "Implicit/Scheduled transaction not allowed" );
-   return my->push_transaction(trx, block_deadline, max_transaction_time, billed_cpu_time_us, explicit_billed_cpu_time, subjective_cpu_bill_us );
+   return my->push_transaction(trx, block_deadline, max_transaction_time, billed_cpu_time_us, explicit_billed_cpu_time, subjective_cpu_bill_us, on_authorized );
 }
 
 transaction_trace_ptr controller::push_scheduled_transaction( const transaction_id_type& trxid,
@@ -3237,6 +3478,18 @@ block_id_type controller::get_block_id_for_num( uint32_t block_num )const { try
    return id;
 } FC_CAPTURE_AND_RETHROW( (block_num) ) }
 
+const state_commitment& controller::calculate_state_commitment() { try {
+   return my->calculate_state_commitment();
+} FC_LOG_AND_RETHROW() }
+
+table_temperature* controller::get_table_temperature()const {
+   return my->table_temp.get();
+}
+
+contract_profiler* controller::get_contract_profiler()const {
+   return my->contract_prof.get();
+}
+
 sha256 controller::calculate_integrity_hash() { try {
    return my->calculate_integrity_hash();
 } FC_LOG_AND_RETHROW() }
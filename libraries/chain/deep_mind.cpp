@@ -7,7 +7,18 @@
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/account_object.hpp>
 #include <eosio/chain/protocol_feature_manager.hpp>
+#include <eosio/chain/exceptions.hpp>
 #include <fc/crypto/hex.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/io/raw_variant.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 namespace {
 
@@ -22,10 +33,112 @@ namespace {
       }
    }
 
+   // Binary records pack each field with fc::raw, except for the few types below which have no fc::raw
+   // representation or which would otherwise need a temporary copy.
+   struct raw_bytes {
+      const char* data;
+      std::size_t size;
+   };
+
+   template<typename Stream>
+   void pack_field(Stream& ds, const raw_bytes& b) {
+      fc::raw::pack(ds, fc::unsigned_int(b.size));
+      if (b.size)
+         ds.write(b.data, b.size);
+   }
+
+   template<typename Stream>
+   void pack_field(Stream& ds, const char* str) {
+      pack_field(ds, raw_bytes{str, std::strlen(str)});
+   }
+
+   template<typename Stream>
+   void pack_field(Stream& ds, const eosio::chain::permission_object& p) {
+      fc::raw::pack(ds, p.usage_id._id);
+      fc::raw::pack(ds, p.parent._id);
+      fc::raw::pack(ds, p.owner);
+      fc::raw::pack(ds, p.name);
+      fc::raw::pack(ds, p.last_updated);
+      fc::raw::pack(ds, p.auth.to_authority());
+   }
+
+   template<typename Stream, typename T>
+   void pack_field(Stream& ds, const T& v) {
+      fc::raw::pack(ds, v);
+   }
+
 }
 
 namespace eosio::chain {
 
+   deep_mind_binary_writer::deep_mind_binary_writer(const std::string& target, size_t buffer_size)
+   :_buffer(buffer_size)
+   {
+      static const std::string unix_prefix = "unix:";
+      if (target.compare(0, unix_prefix.size(), unix_prefix) == 0) {
+         const std::string path = target.substr(unix_prefix.size());
+         sockaddr_un addr{};
+         EOS_ASSERT(!path.empty() && path.size() < sizeof(addr.sun_path), misc_exception,
+                    "Invalid deep mind unix socket path ${p}", ("p", path));
+         addr.sun_family = AF_UNIX;
+         std::memcpy(addr.sun_path, path.c_str(), path.size());
+
+         _fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+         EOS_ASSERT(_fd >= 0, misc_exception, "Failed to create deep mind socket: ${e}", ("e", std::strerror(errno)));
+         if (::connect(_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+            const int err = errno;
+            ::close(_fd);
+            EOS_THROW(misc_exception, "Failed to connect deep mind socket ${p}: ${e}", ("p", path)("e", std::strerror(err)));
+         }
+         _is_socket = true;
+      } else {
+         _fd = ::open(target.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+         EOS_ASSERT(_fd >= 0, misc_exception, "Failed to open deep mind output ${p}: ${e}", ("p", target)("e", std::strerror(errno)));
+      }
+   }
+
+   deep_mind_binary_writer::~deep_mind_binary_writer()
+   {
+      flush();
+      ::close(_fd);
+   }
+
+   char* deep_mind_binary_writer::reserve(size_t size)
+   {
+      if (_pos + size > _buffer.size()) {
+         flush();
+         if (size > _buffer.size())
+            _buffer.resize(size);
+      }
+      char* result = _buffer.data() + _pos;
+      _pos += size;
+      return result;
+   }
+
+   void deep_mind_binary_writer::flush()
+   {
+      write_fully(_buffer.data(), _pos);
+      _pos = 0;
+   }
+
+   void deep_mind_binary_writer::write_fully(const char* data, size_t size)
+   {
+      while (!_is_stopped && size) {
+         const ssize_t written = _is_socket ? ::send(_fd, data, size, MSG_NOSIGNAL) : ::write(_fd, data, size);
+         if (written < 0) {
+            if (errno == EINTR)
+               continue;
+            fprintf(stderr, "DMLOG BINARY_WRITE_FAILURE_TERMINATED remaining=%zu %s\n", size, std::strerror(errno));
+            _is_stopped = true;
+            // same policy as dmlog_appender: a consumer must never see a gap, so stop the node instead
+            kill(getpid(), SIGTERM);
+            break;
+         }
+         data += written;
+         size -= written;
+      }
+   }
+
    void deep_mind_handler::update_config(deep_mind_config config)
    {
       _config = std::move(config);
@@ -36,6 +149,36 @@ namespace eosio::chain {
       fc::logger::update( logger_name, _logger );
    }
 
+   void deep_mind_handler::update_binary_output(const std::string& target)
+   {
+      if (_binary)
+         _binary->flush();
+      _binary.reset();
+      if (!target.empty())
+         _binary = std::make_unique<deep_mind_binary_writer>(target);
+   }
+
+   void deep_mind_handler::flush()
+   {
+      if (_binary)
+         _binary->flush();
+   }
+
+   template<typename... T>
+   void deep_mind_handler::write_record(deep_mind_record tag, const T&... fields)
+   {
+      // size pass first so the record is packed straight into the writer's buffer
+      fc::datastream<size_t> ss;
+      (pack_field(ss, fields), ...);
+      const size_t payload_size = ss.tellp();
+      const size_t record_size = sizeof(uint32_t) + sizeof(uint8_t) + payload_size;
+
+      fc::datastream<char*> ds(_binary->reserve(record_size), record_size);
+      fc::raw::pack(ds, static_cast<uint32_t>(payload_size));
+      fc::raw::pack(ds, static_cast<uint8_t>(tag));
+      (pack_field(ds, fields), ...);
+   }
+
    static const char* prefix(deep_mind_handler::operation_qualifier q) {
       switch(q)
       {
@@ -48,6 +191,21 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_startup(chainbase::database& db, uint32_t head_block_num)
    {
+      if (_binary) {
+         write_record(deep_mind_record::version, std::string("leap"), uint32_t{13}, uint32_t{0});
+         write_record(deep_mind_record::abidump_start, head_block_num,
+                      db.get<dynamic_global_property_object>().global_action_sequence);
+         const auto& idx = db.get_index<account_index>();
+         for (auto& row : idx.indices()) {
+            if (row.abi.size() != 0) {
+               write_record(deep_mind_record::abidump_abi, row.name, raw_bytes{row.abi.data(), row.abi.size()});
+            }
+         }
+         write_record(deep_mind_record::abidump_end);
+         _binary->flush();
+         return;
+      }
+
       // FIXME: We should probably feed that from CMake directly somehow ...
       fc_dlog(_logger, "DEEP_MIND_VERSION leap 13 0");
 
@@ -69,11 +227,22 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_start_block(uint32_t block_num)
    {
+      if (_binary) {
+         write_record(deep_mind_record::start_block, block_num);
+         return;
+      }
+
       fc_dlog(_logger, "START_BLOCK ${block_num}", ("block_num", block_num));
    }
 
    void deep_mind_handler::on_accepted_block(const std::shared_ptr<block_state>& bsp)
    {
+      if (_binary) {
+         write_record(deep_mind_record::accepted_block, bsp->block_num, *bsp);
+         _binary->flush();
+         return;
+      }
+
       auto packed_blk = fc::raw::pack(*bsp);
 
       fc_dlog(_logger, "ACCEPTED_BLOCK ${num} ${blk}",
@@ -84,6 +253,12 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_switch_forks(const block_id_type& old_head, const block_id_type& new_head)
    {
+      if (_binary) {
+         write_record(deep_mind_record::switch_fork, old_head, new_head);
+         _binary->flush();
+         return;
+      }
+
       fc_dlog(_logger, "SWITCH_FORK ${from_id} ${to_id}",
          ("from_id", old_head)
          ("to_id", new_head)
@@ -92,6 +267,11 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_onerror(const signed_transaction& etrx)
    {
+      if (_binary) {
+         write_record(deep_mind_record::trx_create_onerror, etrx.id(), etrx);
+         return;
+      }
+
       auto packed_trx = fc::raw::pack(etrx);
 
       fc_dlog(_logger, "TRX_OP CREATE onerror ${id} ${trx}",
@@ -102,6 +282,11 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_onblock(const signed_transaction& trx)
    {
+      if (_binary) {
+         write_record(deep_mind_record::trx_create_onblock, trx.id(), trx);
+         return;
+      }
+
       auto packed_trx = fc::raw::pack(trx);
 
       fc_dlog(_logger, "TRX_OP CREATE onblock ${id} ${trx}",
@@ -122,6 +307,17 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_applied_transaction(uint32_t block_num, const transaction_trace_ptr& trace)
    {
+      if (_binary) {
+         if (_config.zero_elapsed) {
+            transaction_trace trace_copy = *trace;
+            set_trace_elapsed_to_zero(trace_copy);
+            write_record(deep_mind_record::applied_transaction, block_num, trace_copy);
+         } else {
+            write_record(deep_mind_record::applied_transaction, block_num, *trace);
+         }
+         return;
+      }
+
       std::vector<char> packed_trace;
       
       if (_config.zero_elapsed) {
@@ -141,6 +337,12 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_add_ram_correction(const account_ram_correction_object& rco, uint64_t delta)
    {
+      if (_binary) {
+         write_record(deep_mind_record::ram_correction, _action_id, rco.id._id, _ram_trace.event_id, rco.name, delta);
+         _ram_trace = ram_trace();
+         return;
+      }
+
       fc_dlog(_logger, "RAM_CORRECTION_OP ${action_id} ${correction_id} ${event_id} ${payer} ${delta}",
          ("action_id", _action_id)
          ("correction_id", rco.id._id)
@@ -153,6 +355,11 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_preactivate_feature(const protocol_feature& feature)
    {
+      if (_binary) {
+         write_record(deep_mind_record::feature_pre_activate, _action_id, feature.feature_digest, feature.to_variant());
+         return;
+      }
+
       fc_dlog(_logger, "FEATURE_OP PRE_ACTIVATE ${action_id} ${feature_digest} ${feature}",
          ("action_id", _action_id)
          ("feature_digest", feature.feature_digest)
@@ -162,6 +369,11 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_activate_feature(const protocol_feature& feature)
    {
+      if (_binary) {
+         write_record(deep_mind_record::feature_activate, feature.feature_digest, feature.to_variant());
+         return;
+      }
+
       fc_dlog(_logger, "FEATURE_OP ACTIVATE ${feature_digest} ${feature}",
          ("feature_digest", feature.feature_digest)
          ("feature", feature.to_variant())
@@ -170,6 +382,11 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_input_action()
    {
+      if (_binary) {
+         write_record(deep_mind_record::creation_root, _action_id);
+         return;
+      }
+
       fc_dlog(_logger, "CREATION_OP ROOT ${action_id}",
          ("action_id", _action_id)
       );
@@ -180,24 +397,46 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_require_recipient()
    {
+      if (_binary) {
+         write_record(deep_mind_record::creation_notify, _action_id);
+         return;
+      }
+
       fc_dlog(_logger, "CREATION_OP NOTIFY ${action_id}",
          ("action_id", _action_id)
       );
    }
    void deep_mind_handler::on_send_inline()
    {
+      if (_binary) {
+         write_record(deep_mind_record::creation_inline, _action_id);
+         return;
+      }
+
       fc_dlog(_logger, "CREATION_OP INLINE ${action_id}",
          ("action_id", _action_id)
       );
    }
    void deep_mind_handler::on_send_context_free_inline()
    {
+      if (_binary) {
+         write_record(deep_mind_record::creation_cfa_inline, _action_id);
+         return;
+      }
+
       fc_dlog(_logger, "CREATION_OP CFA_INLINE ${action_id}",
          ("action_id", _action_id)
       );
    }
    void deep_mind_handler::on_cancel_deferred(operation_qualifier qual, const generated_transaction_object& gto)
    {
+      if (_binary) {
+         write_record(deep_mind_record::dtrx_cancel, static_cast<uint8_t>(qual), _action_id,
+                      gto.sender, gto.sender_id, gto.payer, gto.published, gto.delay_until, gto.expiration, gto.trx_id,
+                      raw_bytes{gto.packed_trx.data(), gto.packed_trx.size()});
+         return;
+      }
+
       fc_dlog(_logger, "DTRX_OP ${qual}CANCEL ${action_id} ${sender} ${sender_id} ${payer} ${published} ${delay} ${expiration} ${trx_id} ${trx}",
          ("qual", prefix(qual))
          ("action_id", _action_id)
@@ -213,6 +452,13 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_send_deferred(operation_qualifier qual, const generated_transaction_object& gto)
    {
+      if (_binary) {
+         write_record(deep_mind_record::dtrx_create, static_cast<uint8_t>(qual), _action_id,
+                      gto.sender, gto.sender_id, gto.payer, gto.published, gto.delay_until, gto.expiration, gto.trx_id,
+                      raw_bytes{gto.packed_trx.data(), gto.packed_trx.size()});
+         return;
+      }
+
       fc_dlog(_logger, "DTRX_OP ${qual}CREATE ${action_id} ${sender} ${sender_id} ${payer} ${published} ${delay} ${expiration} ${trx_id} ${trx}",
          ("qual", prefix(qual))
          ("action_id", _action_id)
@@ -228,6 +474,13 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_create_deferred(operation_qualifier qual, const generated_transaction_object& gto, const packed_transaction& packed_trx)
    {
+      if (_binary) {
+         write_record(deep_mind_record::dtrx_create, static_cast<uint8_t>(qual), _action_id,
+                      gto.sender, gto.sender_id, gto.payer, gto.published, gto.delay_until, gto.expiration, gto.trx_id,
+                      fc::raw::pack(packed_trx.get_signed_transaction()));
+         return;
+      }
+
       auto packed_signed_trx = fc::raw::pack(packed_trx.get_signed_transaction());
 
       fc_dlog(_logger, "DTRX_OP ${qual}CREATE ${action_id} ${sender} ${sender_id} ${payer} ${published} ${delay} ${expiration} ${trx_id} ${trx}",
@@ -245,12 +498,22 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_fail_deferred()
    {
+      if (_binary) {
+         write_record(deep_mind_record::dtrx_failed, _action_id);
+         return;
+      }
+
       fc_dlog(_logger, "DTRX_OP FAILED ${action_id}",
          ("action_id", _action_id)
       );
    }
    void deep_mind_handler::on_create_table(const table_id_object& tid)
    {
+      if (_binary) {
+         write_record(deep_mind_record::table_insert, _action_id, tid.code, tid.scope, tid.table, tid.payer);
+         return;
+      }
+
       fc_dlog(_logger, "TBL_OP INS ${action_id} ${code} ${scope} ${table} ${payer}",
          ("action_id", _action_id)
          ("code", tid.code)
@@ -261,6 +524,11 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_remove_table(const table_id_object& tid)
    {
+      if (_binary) {
+         write_record(deep_mind_record::table_remove, _action_id, tid.code, tid.scope, tid.table, tid.payer);
+         return;
+      }
+
       fc_dlog(_logger, "TBL_OP REM ${action_id} ${code} ${scope} ${table} ${payer}",
          ("action_id", _action_id)
          ("code", tid.code)
@@ -271,6 +539,12 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_db_store_i64(const table_id_object& tid, const key_value_object& kvo)
    {
+      if (_binary) {
+         write_record(deep_mind_record::db_insert, _action_id, kvo.payer, tid.code, tid.scope, tid.table, kvo.primary_key,
+                      raw_bytes{kvo.value.data(), kvo.value.size()});
+         return;
+      }
+
       fc_dlog(_logger, "DB_OP INS ${action_id} ${payer} ${table_code} ${scope} ${table_name} ${primkey} ${ndata}",
          ("action_id", _action_id)
          ("payer", kvo.payer)
@@ -283,6 +557,12 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_db_update_i64(const table_id_object& tid, const key_value_object& kvo, account_name payer, const char* buffer, std::size_t buffer_size)
    {
+      if (_binary) {
+         write_record(deep_mind_record::db_update, _action_id, kvo.payer, payer, tid.code, tid.scope, tid.table, kvo.primary_key,
+                      raw_bytes{kvo.value.data(), kvo.value.size()}, raw_bytes{buffer, buffer_size});
+         return;
+      }
+
       fc_dlog(_logger, "DB_OP UPD ${action_id} ${opayer}:${npayer} ${table_code} ${scope} ${table_name} ${primkey} ${odata}:${ndata}",
          ("action_id", _action_id)
          ("opayer", kvo.payer)
@@ -297,6 +577,12 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_db_remove_i64(const table_id_object& tid, const key_value_object& kvo)
    {
+      if (_binary) {
+         write_record(deep_mind_record::db_remove, _action_id, kvo.payer, tid.code, tid.scope, tid.table, kvo.primary_key,
+                      raw_bytes{kvo.value.data(), kvo.value.size()});
+         return;
+      }
+
       fc_dlog(_logger, "DB_OP REM ${action_id} ${payer} ${table_code} ${scope} ${table_name} ${primkey} ${odata}",
          ("action_id", _action_id)
          ("payer", kvo.payer)
@@ -309,6 +595,12 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_init_resource_limits(const resource_limits::resource_limits_config_object& config, const resource_limits::resource_limits_state_object& state)
    {
+      if (_binary) {
+         write_record(deep_mind_record::rlimit_config_insert, config);
+         write_record(deep_mind_record::rlimit_state_insert, state);
+         return;
+      }
+
       fc_dlog(_logger, "RLIMIT_OP CONFIG INS ${data}",
          ("data", config)
       );
@@ -318,18 +610,34 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_update_resource_limits_config(const resource_limits::resource_limits_config_object& config)
    {
+      if (_binary) {
+         write_record(deep_mind_record::rlimit_config_update, config);
+         return;
+      }
+
       fc_dlog(_logger, "RLIMIT_OP CONFIG UPD ${data}",
          ("data", config)
       );
    }
    void deep_mind_handler::on_update_resource_limits_state(const resource_limits::resource_limits_state_object& state)
    {
+      if (_binary) {
+         write_record(deep_mind_record::rlimit_state_update, state);
+         return;
+      }
+
       fc_dlog(_logger, "RLIMIT_OP STATE UPD ${data}",
          ("data", state)
       );
    }
    void deep_mind_handler::on_newaccount_resource_limits(const resource_limits::resource_limits_object& limits, const resource_limits::resource_usage_object& usage)
    {
+      if (_binary) {
+         write_record(deep_mind_record::rlimit_account_limits_insert, limits);
+         write_record(deep_mind_record::rlimit_account_usage_insert, usage);
+         return;
+      }
+
       fc_dlog(_logger, "RLIMIT_OP ACCOUNT_LIMITS INS ${data}",
          ("data", limits)
       );
@@ -339,12 +647,22 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_update_account_usage(const resource_limits::resource_usage_object& usage)
    {
+      if (_binary) {
+         write_record(deep_mind_record::rlimit_account_usage_update, usage);
+         return;
+      }
+
       fc_dlog(_logger, "RLIMIT_OP ACCOUNT_USAGE UPD ${data}",
          ("data", usage)
       );
    }
    void deep_mind_handler::on_set_account_limits(const resource_limits::resource_limits_object& limits)
    {
+      if (_binary) {
+         write_record(deep_mind_record::rlimit_account_limits_update, limits);
+         return;
+      }
+
       fc_dlog(_logger, "RLIMIT_OP ACCOUNT_LIMITS UPD ${data}",
          ("data", limits)
       );
@@ -355,6 +673,13 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_ram_event(account_name account, uint64_t new_usage, int64_t delta)
    {
+      if (_binary) {
+         write_record(deep_mind_record::ram_op, _action_id, _ram_trace.event_id, _ram_trace.family, _ram_trace.operation,
+                      _ram_trace.legacy_tag, account, new_usage, delta);
+         _ram_trace = ram_trace();
+         return;
+      }
+
       fc_dlog(_logger, "RAM_OP ${action_id} ${event_id} ${family} ${operation} ${legacy_tag} ${payer} ${new_usage} ${delta}",
          ("action_id", _action_id)
          ("event_id", _ram_trace.event_id)
@@ -370,6 +695,11 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_create_permission(const permission_object& p)
    {
+      if (_binary) {
+         write_record(deep_mind_record::perm_insert, _action_id, p.id._id, p);
+         return;
+      }
+
       fc_dlog(_logger, "PERM_OP INS ${action_id} ${permission_id} ${data}",
          ("action_id", _action_id)
          ("permission_id", p.id)
@@ -378,6 +708,11 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_modify_permission(const permission_object& old_permission, const permission_object& new_permission)
    {
+      if (_binary) {
+         write_record(deep_mind_record::perm_update, _action_id, new_permission.id._id, old_permission, new_permission);
+         return;
+      }
+
       fc_dlog(_logger, "PERM_OP UPD ${action_id} ${permission_id} ${data}",
          ("action_id", _action_id)
          ("permission_id", new_permission.id)
@@ -389,6 +724,11 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_remove_permission(const permission_object& permission)
    {
+      if (_binary) {
+         write_record(deep_mind_record::perm_remove, _action_id, permission.id._id, permission);
+         return;
+      }
+
       fc_dlog(_logger, "PERM_OP REM ${action_id} ${permission_id} ${data}",
         ("action_id", _action_id)
         ("permission_id", permission.id)
@@ -3,6 +3,7 @@
 #include <eosio/chain/trace.hpp>
 #include <eosio/chain/contract_types.hpp>
 #include <eosio/chain/exceptions.hpp>
+#include <optional>
 #include <utility>
 #include <fc/variant_object.hpp>
 #include <fc/scoped_exit.hpp>
@@ -36,6 +37,10 @@ struct abi_serializer {
 
    abi_serializer(){ configure_built_in_types(); }
    abi_serializer( abi_def abi, const yield_function_t& yield );
+   abi_serializer( const abi_serializer& other );
+   abi_serializer( abi_serializer&& other ) = default; // map nodes, and the iterators held by type_plans, move with the maps
+   abi_serializer& operator=( const abi_serializer& other );
+   abi_serializer& operator=( abi_serializer&& other ) = default;
    [[deprecated("use the overload with yield_function_t[=create_yield_function(max_serialization_time)]")]]
    abi_serializer( const abi_def& abi, const fc::microseconds& max_serialization_time );
    void set_abi( abi_def abi, const yield_function_t& yield );
@@ -150,14 +155,64 @@ private:
    map<type_name, pair<unpack_function, pack_function>, std::less<>> built_in_types;
    void configure_built_in_types();
 
+   /**
+    *  Flattened form of one ABI type, built by compile_type_plans() when the ABI is set.
+    *  Typedefs are resolved, built-ins are bound to their unpack/pack pair and every
+    *  referenced type is an index into type_plans, so encoding and decoding do no string
+    *  lookups below the top level type.
+    */
+   struct type_plan {
+      enum class kind : uint8_t {
+         unresolved, ///< not representable as a plan (nested too deep, or a struct whose base is not a struct); handled by name
+         built_in,
+         array,
+         optional,
+         variant,
+         structure
+      };
+
+      struct field {
+         uint32_t plan = 0;
+         bool     extension = false;  ///< declared with a trailing '$'
+         bool     optional = false;   ///< declared type ends with '?'
+         bool     is_bytes = false;   ///< resolves to "bytes", trimmed when logging
+      };
+
+      kind                                                 k = kind::unresolved;
+      type_name                                            type;            ///< type as referenced, before resolution
+      type_name                                            built_in_name;   ///< fundamental type, for error messages
+      bool                                                 is_array = false;
+      bool                                                 is_optional = false;
+      const pair<unpack_function, pack_function>*          built_in = nullptr;
+      uint32_t                                             element = 0;     ///< array and optional element plan
+      std::optional<uint32_t>                              base;            ///< plan of the base struct
+      map<type_name, struct_def, std::less<>>::const_iterator  struct_itr;
+      map<type_name, variant_def, std::less<>>::const_iterator variant_itr;
+      vector<field>                                        fields;
+      vector<uint32_t>                                     alternatives;    ///< plans of the variant's types
+   };
+
+   vector<type_plan>                          type_plans;
+   map<type_name, uint32_t, std::less<>>      type_plan_index;
+
+   void     compile_type_plans();
+   void     copy_type_plans( const abi_serializer& other );
+   uint32_t compile_type_plan( const std::string_view& type, size_t depth );
+   const type_plan* find_type_plan( const std::string_view& type )const;
+
    fc::variant _binary_to_variant( const std::string_view& type, const bytes& binary, impl::binary_to_variant_context& ctx )const;
    fc::variant _binary_to_variant( const std::string_view& type, fc::datastream<const char*>& binary, impl::binary_to_variant_context& ctx )const;
    void        _binary_to_variant( const std::string_view& type, fc::datastream<const char*>& stream,
                                    fc::mutable_variant_object& obj, impl::binary_to_variant_context& ctx )const;
+   fc::variant _binary_to_variant( const type_plan& plan, fc::datastream<const char*>& stream, impl::binary_to_variant_context& ctx )const;
+   void        _binary_to_variant( const type_plan& plan, fc::datastream<const char*>& stream,
+                                   fc::mutable_variant_object& obj, impl::binary_to_variant_context& ctx )const;
 
    bytes       _variant_to_binary( const std::string_view& type, const fc::variant& var, impl::variant_to_binary_context& ctx )const;
    void        _variant_to_binary( const std::string_view& type, const fc::variant& var,
                                    fc::datastream<char*>& ds, impl::variant_to_binary_context& ctx )const;
+   void        _variant_to_binary( const type_plan& plan, const fc::variant& var,
+                                   fc::datastream<char*>& ds, impl::variant_to_binary_context& ctx )const;
 
    static std::string_view _remove_bin_extension(const std::string_view& type);
    bool _is_type( const std::string_view& type, impl::abi_traverse_context& ctx )const;
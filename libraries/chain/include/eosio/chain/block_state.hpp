@@ -62,6 +62,9 @@ namespace eosio { namespace chain {
       /// this data is redundant with the data stored in block, but facilitates
       /// recapturing transactions when we pop a block
       deque<transaction_metadata_ptr>                    _cached_trxs;
+      /// key recovery of the packed transactions of block, started on the thread pool when the block state is
+      /// created so apply_block does not wait for it; set before the block state is shared, empty if not started
+      std::vector<std::shared_future<transaction_metadata_ptr>> _trx_recoveries;
    };
 
    using block_state_ptr = std::shared_ptr<block_state>;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+
+#include <array>
+#include <mutex>
+#include <unordered_map>
+
+namespace eosio { namespace chain {
+
+   /**
+    * Aggregates the time contracts spend executing WASM, per (contract, action), across all transactions.
+    *
+    * apply_context records every WASM apply on the thread that ran it, whichever runtime executed it. Recording costs
+    * two clock reads and an uncontended lock of one of several shards, so it is cheap enough to leave on in
+    * production. Native handlers, authorization checks and receipt creation are not included.
+    *
+    * The number of tracked (contract, action) pairs is bounded; the time of pairs first seen after the bound is
+    * reached is only counted in untracked_us().
+    */
+   class contract_profiler {
+      public:
+         static constexpr size_t default_max_entries = 64 * 1024;
+
+         struct entry {
+            account_name contract;
+            action_name  action;
+            uint64_t     calls    = 0;
+            uint64_t     total_us = 0;
+            uint64_t     max_us   = 0;
+         };
+
+         explicit contract_profiler( size_t max_entries = default_max_entries );
+
+         void record( account_name contract, action_name action, fc::microseconds elapsed );
+
+         /// the n entries with the most total time, descending
+         std::vector<entry> top( size_t n ) const;
+         uint64_t           untracked_us() const;
+         /// when aggregation started, construction or the last clear()
+         fc::time_point     since() const;
+         void               clear();
+
+      private:
+         static constexpr size_t num_shards = 16;
+
+         struct key_t {
+            account_name contract;
+            action_name  action;
+            friend bool operator==( const key_t& a, const key_t& b ) {
+               return a.contract == b.contract && a.action == b.action;
+            }
+         };
+
+         struct key_hash {
+            size_t operator()( const key_t& k ) const {
+               return std::hash<uint64_t>()( k.contract.to_uint64_t() * 0x9e3779b97f4a7c15ULL ^ k.action.to_uint64_t() );
+            }
+         };
+
+         struct shard {
+            mutable std::mutex                        mtx;
+            std::unordered_map<key_t, entry, key_hash> entries;
+            uint64_t                                  untracked_us = 0;
+         };
+
+         const size_t                 _max_entries_per_shard;
+         std::array<shard, num_shards> _shards;
+         mutable std::mutex           _since_mtx;
+         fc::time_point               _since;
+   };
+
+} } /// eosio::chain
+
+FC_REFLECT( eosio::chain::contract_profiler::entry, (contract)(action)(calls)(total_us)(max_us) )
@@ -24,6 +24,9 @@ namespace eosio { namespace vm { class wasm_allocator; }}
 namespace eosio { namespace chain {
 
    class authorization_manager;
+   class state_commitment;
+   class table_temperature;
+   class contract_profiler;
 
    namespace resource_limits {
       class resource_limits_manager;
@@ -86,6 +89,10 @@ namespace eosio { namespace chain {
             uint32_t                 terminate_at_block     = 0;
             bool                     integrity_hash_on_start= false;
             bool                     integrity_hash_on_stop = false;
+            bool                     batch_resource_usage   = false; //< accumulate account cpu/net usage in memory and write it to state once per block
+            bool                     maintain_state_commitment = false; //< keep a state_commitment updated with every block
+            uint32_t                 table_cold_after_blocks = 0; //< track contract table temperature when > 0, see table_temperature
+            bool                     profile_contracts = false; //< aggregate WASM execution time per contract and action, see contract_profiler
 
             wasm_interface::vm_type  wasm_runtime = chain::config::default_wasm_runtime;
             eosvmoc::config          eosvmoc_config;
@@ -141,12 +148,14 @@ namespace eosio { namespace chain {
          deque<transaction_metadata_ptr> abort_block();
 
        /**
-        *
+        * @param on_authorized - if set, called once the authorizations of trx are verified and before it executes;
+        *                        an exception it throws fails trx like one thrown by the execution
         */
          transaction_trace_ptr push_transaction( const transaction_metadata_ptr& trx,
                                                  fc::time_point deadline, fc::microseconds max_transaction_time,
                                                  uint32_t billed_cpu_time_us, bool explicit_billed_cpu_time,
-                                                 int64_t subjective_cpu_bill_us );
+                                                 int64_t subjective_cpu_bill_us,
+                                                 const std::function<void()>& on_authorized = {} );
 
          /**
           * Attempt to execute a specific transaction in our deferred trx database
@@ -161,6 +170,8 @@ namespace eosio { namespace chain {
             size_t             total_cpu_usage_us = 0;
             fc::microseconds   total_elapsed_time{};
             fc::microseconds   total_time{};
+            fc::microseconds   recover_keys_time{};      ///< signature recovery of the block's transactions, on the thread pool
+            fc::microseconds   recover_keys_wait_time{}; ///< main thread waiting for signature recovery to complete
          };
 
          block_state_ptr finalize_block( block_report& br, const signer_callback_type& signer_callback );
@@ -169,7 +180,9 @@ namespace eosio { namespace chain {
 
          // thread-safe
          std::future<block_state_ptr> create_block_state_future( const block_id_type& id, const signed_block_ptr& b );
-         // thread-safe
+         // thread-safe, returns null if the previous block is not in fork_db yet. If the previous block was passed
+         // here earlier, `b` is validated ahead against it on the chain thread pool and create_block_state_future
+         // returns that result once the previous block has been applied.
          block_state_ptr create_block_state( const block_id_type& id, const signed_block_ptr& b ) const;
 
          /**
@@ -253,6 +266,12 @@ namespace eosio { namespace chain {
          block_id_type get_block_id_for_num( uint32_t block_num )const;
 
          sha256 calculate_integrity_hash();
+         /// incrementally maintained when config::maintain_state_commitment, otherwise calculated from scratch on every call
+         const state_commitment& calculate_state_commitment();
+         /// nullptr unless config::table_cold_after_blocks > 0
+         table_temperature* get_table_temperature()const;
+         /// nullptr unless config::profile_contracts
+         contract_profiler* get_contract_profiler()const;
          void write_snapshot( const snapshot_writer_ptr& snapshot );
 
          bool sender_avoids_whitelist_blacklist_enforcement( account_name sender )const;
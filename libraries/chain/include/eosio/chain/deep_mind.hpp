@@ -42,6 +42,85 @@ public:
    {}
 };
 
+/**
+ * Type tag of a record written by deep_mind_handler in binary mode. Each record is framed as a little-endian
+ * uint32 payload length, the one byte tag and then the fc::raw packed payload. Values are part of the wire
+ * format; only append new tags.
+ */
+enum class deep_mind_record : uint8_t {
+   version = 1,
+   abidump_start,
+   abidump_abi,
+   abidump_end,
+   start_block,
+   accepted_block,
+   switch_fork,
+   trx_create_onerror,
+   trx_create_onblock,
+   applied_transaction,
+   ram_correction,
+   feature_pre_activate,
+   feature_activate,
+   creation_root,
+   creation_notify,
+   creation_inline,
+   creation_cfa_inline,
+   dtrx_cancel,
+   dtrx_create,
+   dtrx_failed,
+   table_insert,
+   table_remove,
+   db_insert,
+   db_update,
+   db_remove,
+   rlimit_config_insert,
+   rlimit_state_insert,
+   rlimit_config_update,
+   rlimit_state_update,
+   rlimit_account_limits_insert,
+   rlimit_account_usage_insert,
+   rlimit_account_usage_update,
+   rlimit_account_limits_update,
+   ram_op,
+   perm_insert,
+   perm_update,
+   perm_remove
+};
+
+/**
+ * Buffered writer for binary deep mind records. The target is either a path, opened for append (this covers
+ * regular files and FIFOs; opening a FIFO blocks until a reader attaches), or `unix:<path>` to connect to a
+ * listening unix domain stream socket. Records are accumulated in memory and written out when the buffer is
+ * full or on flush(), which deep_mind_handler calls once per accepted block or fork switch.
+ *
+ * Like dmlog_appender, a write error the writer cannot recover from stops further output and sends SIGTERM to
+ * the process, so a consumer never silently misses records.
+ */
+class deep_mind_binary_writer
+{
+public:
+   static constexpr size_t default_buffer_size = 4*1024*1024;
+
+   explicit deep_mind_binary_writer(const std::string& target, size_t buffer_size = default_buffer_size);
+   ~deep_mind_binary_writer();
+
+   deep_mind_binary_writer(const deep_mind_binary_writer&) = delete;
+   deep_mind_binary_writer& operator=(const deep_mind_binary_writer&) = delete;
+
+   /// Returns space for `size` contiguous bytes at the end of the buffer, flushing first if they do not fit.
+   char* reserve(size_t size);
+   void  flush();
+
+private:
+   void write_fully(const char* data, size_t size);
+
+   int               _fd = -1;
+   bool              _is_socket = false;
+   bool              _is_stopped = false;
+   std::vector<char> _buffer;
+   size_t            _pos = 0;
+};
+
 class deep_mind_handler
 {
 public:
@@ -52,6 +131,10 @@ public:
    void update_config(deep_mind_config config);
 
    void update_logger(const std::string& logger_name);
+   /// Switches to binary framing written to `target` (see deep_mind_binary_writer), or back to text logging
+   /// through the deep-mind logger when `target` is empty.
+   void update_binary_output(const std::string& target);
+   void flush();
    enum class operation_qualifier { none, modify, push };
 
    void on_startup(chainbase::database& db, uint32_t head_block_num);
@@ -93,10 +176,14 @@ public:
    void on_modify_permission(const permission_object& old_permission, const permission_object& new_permission);
    void on_remove_permission(const permission_object& permission);
 private:
+   template<typename... T>
+   void write_record(deep_mind_record tag, const T&... fields);
+
    uint32_t         _action_id = 0;
    ram_trace        _ram_trace;
    deep_mind_config _config;
    fc::logger       _logger;
+   std::unique_ptr<deep_mind_binary_writer> _binary;
 };
 
 }
@@ -64,10 +64,36 @@ namespace eosio { namespace chain {
    class resource_limits_manager {
       public:
 
-         explicit resource_limits_manager(chainbase::database& db, std::function<deep_mind_handler*(bool is_trx_transient)> get_deep_mind_logger)
-         :_db(db),_get_deep_mind_logger(get_deep_mind_logger)
-         {
-         }
+         /**
+          * Undo marker for batched usage, created alongside a database undo session. Unless commit() is called,
+          * undo() or destruction discards the usage batched since the checkpoint was created, just as undoing
+          * the session discards the database changes made under it. A no-op when batching is disabled.
+          */
+         class usage_checkpoint {
+            public:
+               explicit usage_checkpoint( resource_limits_manager& rl );
+               usage_checkpoint( usage_checkpoint&& other );
+               usage_checkpoint& operator=( usage_checkpoint&& other );
+               ~usage_checkpoint();
+
+               usage_checkpoint( const usage_checkpoint& ) = delete;
+               usage_checkpoint& operator=( const usage_checkpoint& ) = delete;
+
+               void commit();
+               void undo();
+
+            private:
+               friend class resource_limits_manager;
+
+               resource_limits_manager* _rl = nullptr;
+               uint64_t                 _generation = 0;
+               size_t                   _journal_size = 0;
+               uint64_t                 _pending_cpu_usage = 0;
+               uint64_t                 _pending_net_usage = 0;
+         };
+
+         explicit resource_limits_manager(chainbase::database& db, std::function<deep_mind_handler*(bool is_trx_transient)> get_deep_mind_logger);
+         ~resource_limits_manager();
 
          void add_indices();
          void initialize_database();
@@ -112,9 +138,28 @@ namespace eosio { namespace chain {
 
          int64_t get_account_ram_usage( const account_name& name ) const;
 
+         /**
+          * When enabled, account cpu/net usage and the block's pending cpu/net usage are accumulated in memory
+          * for the duration of a block instead of being written to the database by every transaction. Limits
+          * are still checked per transaction against the accumulated values; flush_batched_usage() writes the
+          * final values, which are identical to those produced without batching. Per transaction account usage
+          * is not reported to deep mind while batching.
+          */
+         void set_batched_usage( bool enabled );
+         bool is_batched_usage() const { return _batched != nullptr; }
+         void flush_batched_usage();
+
       private:
+         struct batched_usage;
+         struct pending_account_usage;
+
+         pending_account_usage get_pending_usage( const account_name& account ) const;
+         void set_pending_usage( const account_name& account, const pending_account_usage& usage );
+         void rollback_batched_usage( const usage_checkpoint& cp );
+
          chainbase::database&         _db;
          std::function<deep_mind_handler*(bool is_trx_transient)> _get_deep_mind_logger;
+         std::unique_ptr<batched_usage> _batched;
    };
 } } } /// eosio::chain
 
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+
+#include <boost/asio/io_context.hpp>
+
+#include <array>
+#include <deque>
+
+namespace eosio { namespace chain {
+
+   /**
+    * Order independent commitment to the chain state database which is maintained incrementally.
+    *
+    * Each row is hashed in its snapshot form, so chainbase ids do not take part and nodes restored from a snapshot
+    * agree with nodes that replayed from genesis. Rows of contract tables are hashed together with the code, scope
+    * and table they belong to. The row hashes of each index are added up in four independent 64-bit lanes; a row
+    * is taken out again by subtracting its hash, which makes updating the sum for a created, modified or removed row
+    * O(1) regardless of the size of the index. The commitment is the sha256 of all index sums.
+    *
+    * calculate() walks the whole database once. Afterwards apply_last_undo_session() folds in the rows chainbase
+    * recorded in the most recent undo session of every index, i.e. the changes of one block.
+    *
+    * The result is not comparable to controller::calculate_integrity_hash().
+    */
+   class state_commitment {
+      public:
+         static constexpr uint32_t magic_number = 0x3c5a7e11;
+         static constexpr uint32_t version      = 1;
+
+         struct index_sum {
+            std::array<uint64_t, 4> lanes{};
+
+            void add( const digest_type& d );
+            void sub( const digest_type& d );
+            digest_type digest() const;
+         };
+
+         state_commitment();
+
+         /// recompute every index sum from the rows of db, one task per index on thread_pool; blocks until done
+         void calculate( const chainbase::database& db, boost::asio::io_context& thread_pool );
+
+         /// update the index sums with the changes recorded in the last undo session of db
+         void apply_last_undo_session( const chainbase::database& db );
+
+         void invalidate();
+         bool valid() const { return _valid; }
+
+         digest_type digest() const;
+
+         /// digest of each index sum, to narrow down where two states differ
+         std::vector<std::pair<std::string, digest_type>> index_digests() const;
+
+         /// remember the current sums as the state after block id, replacing an entry for the same block
+         void record_block( const block_id_type& id );
+
+         /// return to the sums recorded for block id, invalidates if they are not known
+         void restore_block( const block_id_type& id );
+
+         /// forget recorded blocks below block_num, they can no longer be popped
+         void prune_blocks( uint32_t block_num );
+
+         /// persist the sums as the state at head
+         void write( const fc::path& file, const block_id_type& head ) const;
+
+         /// load sums written by write() for head; the file is removed so a later crash cannot leave a stale file
+         bool read( const fc::path& file, const block_id_type& head );
+
+      private:
+         using sums_type = std::vector<index_sum>;
+
+         sums_type                                       _sums;
+         bool                                            _valid = false;
+         std::deque<std::pair<block_id_type, sums_type>> _history; ///< oldest first
+   };
+
+} } /// eosio::chain
+
+FC_REFLECT(eosio::chain::state_commitment::index_sum, (lanes))
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace eosio { namespace chain {
+
+   /**
+    * Tracks how recently each contract table was accessed, to tell hot chain state from cold.
+    *
+    * apply_context records an access whenever a contract looks up a table, as the number of the block being built
+    * or applied. Every table id below 2^32 has its own slot, in chunks of atomics allocated when a table of the
+    * chunk is first accessed, so recording is lock free and safe from read-only threads. Tables not accessed since
+    * tracking started count as accessed in the first tracked block.
+    *
+    * Recording does not affect execution in any way. This only measures; rows of cold tables stay in the chain
+    * state database, moving them to a separate store would need changes to chainbase.
+    */
+   class table_temperature {
+      public:
+         struct table_report {
+            uint32_t hot_tables = 0;
+            uint32_t cold_tables = 0;
+            uint64_t hot_rows = 0;
+            uint64_t cold_rows = 0;
+         };
+
+         struct residency_report {
+            uint64_t resident_bytes = 0;    ///< of the chain state database, as reported by the kernel
+            uint64_t nonresident_bytes = 0;
+         };
+
+         explicit table_temperature( uint32_t cold_after_blocks );
+         ~table_temperature();
+
+         /// block accesses are attributed to from now on
+         void set_block_num( uint32_t block_num );
+
+         void touch( int64_t table_id ) {
+            if( auto* slot = find_slot( table_id, true ) )
+               slot->store( _block_num.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+         }
+
+         /// block number of the most recent access of table_id
+         uint32_t last_access( int64_t table_id ) const;
+
+         bool is_cold( int64_t table_id ) const {
+            const uint32_t cur = _block_num.load( std::memory_order_relaxed );
+            return cur > _cold_after_blocks && last_access( table_id ) < cur - _cold_after_blocks;
+         }
+
+         uint32_t cold_after_blocks() const { return _cold_after_blocks; }
+
+         /**
+          * Continues walking the contract tables of db where the previous call stopped, visiting at most max_tables,
+          * so the cost per call is bounded. Returns the counts once a walk over all tables completed. Not thread safe,
+          * must be called where db may be read.
+          */
+         std::optional<table_report> walk_tables( const chainbase::database& db, size_t max_tables );
+
+         /// one mincore over the database mapping; thread safe while db is open
+         static residency_report state_residency( const chainbase::database& db );
+
+      private:
+         static constexpr uint32_t chunk_bits = 16;
+         static constexpr uint32_t num_chunks = uint32_t(1) << ( 32 - chunk_bits );
+
+         /// nullptr for ids that are not tracked, or when the chunk was never accessed and create is false
+         std::atomic<uint32_t>* find_slot( int64_t table_id, bool create ) const {
+            const uint64_t id = static_cast<uint64_t>( table_id );
+            if( id >> 32 )
+               return nullptr;
+            auto& c = _chunks[id >> chunk_bits];
+            auto* slots = c.load( std::memory_order_acquire );
+            if( !slots && create )
+               slots = allocate_chunk( c );
+            return slots ? &slots[id & ( ( uint64_t(1) << chunk_bits ) - 1 )] : nullptr;
+         }
+
+         static std::atomic<uint32_t>* allocate_chunk( std::atomic<std::atomic<uint32_t>*>& c );
+
+         const uint32_t                                              _cold_after_blocks;
+         std::unique_ptr<std::atomic<std::atomic<uint32_t>*>[]>      _chunks;
+         std::atomic<uint32_t>                                       _block_num{0};
+         uint32_t                                                    _start_block_num = 0;
+
+         // state of the walk in progress
+         int64_t                                                     _walk_next_id = 0;
+         table_report                                                _walk;
+   };
+
+} } /// eosio::chain
@@ -2,6 +2,7 @@
 #include <eosio/chain/controller.hpp>
 #include <eosio/chain/trace.hpp>
 #include <eosio/chain/platform_timer.hpp>
+#include <eosio/chain/resource_limits.hpp>
 #include <signal.h>
 
 namespace eosio { namespace chain {
@@ -130,6 +131,7 @@ namespace eosio { namespace chain {
          const packed_transaction&                   packed_trx;
          const transaction_id_type&                  id;
          std::optional<chainbase::database::session> undo_session;
+         std::optional<resource_limits::resource_limits_manager::usage_checkpoint> usage_checkpoint;
          transaction_trace_ptr                       trace;
          fc::time_point                              start;
 
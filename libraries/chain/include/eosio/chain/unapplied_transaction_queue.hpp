@@ -8,6 +8,7 @@
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
+#include <boost/multi_index/composite_key.hpp>
 
 namespace fc {
   inline std::size_t hash_value( const fc::sha256& v ) {
@@ -34,6 +35,7 @@ struct unapplied_transaction {
    trx_enum_type                  trx_type = trx_enum_type::unknown;
    bool                           return_failure_trace = false;
    next_func_t                    next;
+   uint64_t                       order = 0; ///< position within trx_type, see incoming_trx_scheduler
 
    const transaction_id_type& id()const { return trx_meta->id(); }
    fc::time_point_sec expiration()const { return trx_meta->packed_trx()->expiration(); }
@@ -44,6 +46,21 @@ struct unapplied_transaction {
    unapplied_transaction(unapplied_transaction&&) = default;
 };
 
+/**
+ * Orders incoming transactions of the unapplied_transaction_queue, those with a lower order are processed first
+ * and equal orders in arrival order. Without a scheduler all incoming transactions are processed in arrival order.
+ */
+class incoming_trx_scheduler {
+public:
+   virtual ~incoming_trx_scheduler() = default;
+
+   /// called once as trx is added to the queue
+   virtual uint64_t schedule( const transaction_metadata& trx ) = 0;
+   /// a transaction of order was taken off the queue to be processed
+   virtual void processed( uint64_t order ) = 0;
+   virtual void clear() = 0;
+};
+
 /**
  * Track unapplied transactions for incoming, forked blocks, and aborted blocks.
  */
@@ -58,7 +75,12 @@ private:
          hashed_unique< tag<by_trx_id>,
                const_mem_fun<unapplied_transaction, const transaction_id_type&, &unapplied_transaction::id>
          >,
-         ordered_non_unique< tag<by_type>, member<unapplied_transaction, trx_enum_type, &unapplied_transaction::trx_type> >,
+         ordered_non_unique< tag<by_type>,
+               composite_key< unapplied_transaction,
+                  member<unapplied_transaction, trx_enum_type, &unapplied_transaction::trx_type>,
+                  member<unapplied_transaction, uint64_t, &unapplied_transaction::order>
+               >
+         >,
          ordered_non_unique< tag<by_expiry>, const_mem_fun<unapplied_transaction, fc::time_point_sec, &unapplied_transaction::expiration> >
       >
    > unapplied_trx_queue_type;
@@ -67,11 +89,18 @@ private:
    uint64_t max_transaction_queue_size = 1024*1024*1024; // enforced for incoming
    uint64_t size_in_bytes = 0;
    size_t incoming_count = 0;
+   std::unique_ptr<incoming_trx_scheduler> scheduler;
 
 public:
 
    void set_max_transaction_queue_size( uint64_t v ) { max_transaction_queue_size = v; }
 
+   /// only while empty, orders already assigned would not be comparable to the new scheduler's
+   void set_incoming_scheduler( std::unique_ptr<incoming_trx_scheduler> s ) {
+      EOS_ASSERT( empty(), misc_exception, "incoming transaction scheduler can only be changed while the queue is empty" );
+      scheduler = std::move( s );
+   }
+
    bool empty() const {
       return queue.empty();
    }
@@ -82,6 +111,7 @@ public:
 
    void clear() {
       queue.clear();
+      if( scheduler ) scheduler->clear();
    }
 
    size_t incoming_size()const {
@@ -160,8 +190,9 @@ public:
    void add_incoming( const transaction_metadata_ptr& trx, bool api_trx, bool return_failure_trace, next_func_t next ) {
       auto itr = queue.get<by_trx_id>().find( trx->id() );
       if( itr == queue.get<by_trx_id>().end() ) {
+         const uint64_t order = scheduler ? scheduler->schedule( *trx ) : 0;
          auto insert_itr = queue.insert(
-               { trx, api_trx ? trx_enum_type::incoming_api : trx_enum_type::incoming_p2p, return_failure_trace, std::move( next ) } );
+               { trx, api_trx ? trx_enum_type::incoming_api : trx_enum_type::incoming_p2p, return_failure_trace, std::move( next ), order } );
          if( insert_itr.second ) added( insert_itr.first );
       } else {
          if( itr->trx_meta == trx ) return; // same trx meta pointer
@@ -179,9 +210,9 @@ public:
 
    // forked, aborted
    iterator unapplied_begin() { return queue.get<by_type>().begin(); }
-   iterator unapplied_end() { return queue.get<by_type>().upper_bound( trx_enum_type::aborted ); }
+   iterator unapplied_end() { return queue.get<by_type>().upper_bound( boost::make_tuple( trx_enum_type::aborted ) ); }
 
-   iterator incoming_begin() { return queue.get<by_type>().lower_bound( trx_enum_type::incoming_api ); }
+   iterator incoming_begin() { return queue.get<by_type>().lower_bound( boost::make_tuple( trx_enum_type::incoming_api ) ); }
    iterator incoming_end() { return queue.get<by_type>().end(); } // if changed to upper_bound, verify usage performance
 
    iterator lower_bound( const transaction_id_type& id ) {
@@ -192,6 +223,7 @@ public:
 
    /// caller's responsibility to call next() if applicable
    iterator erase( iterator itr ) {
+      if( scheduler && is_incoming( itr->trx_type ) ) scheduler->processed( itr->order );
       removed( itr );
       return queue.get<by_type>().erase( itr );
    }
@@ -200,7 +232,7 @@ private:
    template<typename Itr>
    void added( Itr itr ) {
       auto size = calc_size( itr->trx_meta );
-      if( itr->trx_type == trx_enum_type::incoming_p2p || itr->trx_type == trx_enum_type::incoming_api ) {
+      if( is_incoming( itr->trx_type ) ) {
          ++incoming_count;
          EOS_ASSERT( size_in_bytes + size < max_transaction_queue_size, tx_resource_exhaustion,
                      "Transaction ${id}, size ${s} bytes would exceed configured "
@@ -213,12 +245,16 @@ private:
 
    template<typename Itr>
    void removed( Itr itr ) {
-      if( itr->trx_type == trx_enum_type::incoming_p2p || itr->trx_type == trx_enum_type::incoming_api ) {
+      if( is_incoming( itr->trx_type ) ) {
          --incoming_count;
       }
       size_in_bytes -= calc_size( itr->trx_meta );
    }
 
+   static bool is_incoming( trx_enum_type t ) {
+      return t == trx_enum_type::incoming_p2p || t == trx_enum_type::incoming_api;
+   }
+
    static uint64_t calc_size( const transaction_metadata_ptr& trx ) {
       // packed_trx caches unpacked transaction so double
       return (trx->packed_trx()->get_unprunable_size() + trx->packed_trx()->get_prunable_size()) * 2 + sizeof( *trx );
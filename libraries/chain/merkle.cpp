@@ -35,18 +35,26 @@ bool is_canonical_right(const digest_type& val) {
 digest_type merkle(deque<digest_type> ids) {
    if( 0 == ids.size() ) { return digest_type(); }
 
-   while( ids.size() > 1 ) {
-      if( ids.size() % 2 )
-         ids.push_back(ids.back());
-
-      for (size_t i = 0; i < ids.size() / 2; i++) {
-         ids[i] = digest_type::hash(make_canonical_pair(ids[2 * i], ids[(2 * i) + 1]));
+   // each level is hashed with one fc::sha256::hash_many call over the canonicalized pairs, laid out
+   // back to back as the 64 byte messages left||right, with the results written in place
+   vector<digest_type> level( std::make_move_iterator(ids.begin()), std::make_move_iterator(ids.end()) );
+   ids.clear();
+
+   while( level.size() > 1 ) {
+      if( level.size() % 2 )
+         level.push_back(level.back());
+
+      for( size_t i = 0; i < level.size(); i += 2 ) {
+         level[i]   = make_canonical_left(level[i]);
+         level[i+1] = make_canonical_right(level[i+1]);
       }
 
-      ids.resize(ids.size() / 2);
+      const size_t pairs = level.size() / 2;
+      digest_type::hash_many( level.front().data(), 2 * sizeof(digest_type), pairs, level.data() );
+      level.resize( pairs );
    }
 
-   return ids.front();
+   return level.front();
 }
 
 } } // eosio::chain
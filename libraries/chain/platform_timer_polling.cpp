@@ -0,0 +1,177 @@
+#include <eosio/chain/platform_timer.hpp>
+#include <eosio/chain/platform_timer_accuracy.hpp>
+
+#include <fc/fwd_impl.hpp>
+#include <fc/log/logger_config.hpp> //set_os_thread_name()
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+namespace eosio { namespace chain {
+
+/*
+ * Instead of arming a kernel timer for every transaction, each platform_timer publishes its deadline in an atomic
+ * and a single watcher thread shared by all instances polls the published deadlines, flipping `expired` and
+ * invoking the expiration callback exactly like the signal handler of the POSIX implementation does. Starting and
+ * stopping a timer are a few atomic operations and make no system calls while the watcher is busy.
+ *
+ * The watcher polls every poll_interval while any timer is armed and blocks once all timers have been idle for
+ * idle_polls consecutive polls; only then does start() have to wake it.
+ */
+
+static constexpr std::chrono::microseconds poll_interval{20};
+static constexpr unsigned                  idle_polls = 500;
+
+static constexpr int64_t no_deadline = 0;
+static constexpr int64_t firing      = -1; // watcher is expiring the timer, start()/stop() must wait for it
+
+//a thread is shared for all instances
+static std::mutex                   timer_ref_mutex;
+static std::vector<platform_timer*> timers;
+static std::thread                  checktime_thread;
+static uint64_t                     checktime_generation; // bumped to stop the current watcher
+
+static std::mutex                   wake_mutex;
+static std::condition_variable      wake_cv;
+static std::atomic_bool             watcher_sleeping;
+
+struct platform_timer::impl {
+   std::atomic<int64_t> deadline{no_deadline}; // microseconds since epoch
+
+   // waits out an in progress expiration and leaves the timer without a deadline
+   void disarm() {
+      int64_t d = deadline.load();
+      while(true) {
+         if(d == firing) {
+            std::this_thread::yield();
+            d = deadline.load();
+         } else if(deadline.compare_exchange_weak(d, no_deadline)) {
+            return;
+         }
+      }
+   }
+
+   // returns true if any timer is armed; timer_ref_mutex must be held
+   static bool poll(int64_t now) {
+      bool armed = false;
+      for(platform_timer* t : timers) {
+         int64_t d = t->my->deadline.load();
+         if(d <= no_deadline)
+            continue;
+         armed = true;
+         if(now >= d && t->my->deadline.compare_exchange_strong(d, firing)) {
+            t->expired = 1;
+            t->call_expiration_callback();
+            t->my->deadline.store(no_deadline);
+         }
+      }
+      return armed;
+   }
+
+   static bool any_armed() {
+      return std::any_of(timers.begin(), timers.end(), [](platform_timer* t) { return t->my->deadline.load() > no_deadline; });
+   }
+
+   static void run(uint64_t generation) {
+      fc::set_os_thread_name("checktime");
+#ifdef __linux__
+      prctl(PR_SET_TIMERSLACK, 1UL); // default 50us slack would dominate poll_interval
+#endif
+      unsigned idle = 0;
+      while(true) {
+         {
+            std::lock_guard guard(timer_ref_mutex);
+            if(generation != checktime_generation)
+               return;
+            idle = poll(fc::time_point::now().time_since_epoch().count()) ? 0 : idle + 1;
+         }
+         if(idle < idle_polls) {
+            std::this_thread::sleep_for(poll_interval);
+            continue;
+         }
+
+         std::unique_lock wake_guard(wake_mutex);
+         watcher_sleeping = true;
+         // recheck after publishing watcher_sleeping: a start() that raced with the last poll either shows up
+         // here or sees watcher_sleeping and notifies, which cannot happen before the wait below releases wake_mutex
+         bool armed;
+         {
+            std::lock_guard guard(timer_ref_mutex);
+            armed = generation != checktime_generation || any_armed();
+         }
+         if(!armed)
+            wake_cv.wait(wake_guard);
+         watcher_sleeping = false;
+         idle = 0;
+      }
+   }
+};
+
+platform_timer::platform_timer() {
+   static_assert(sizeof(impl) <= fwd_size);
+   static_assert(std::atomic<int64_t>::is_always_lock_free, "deadline must be lock-free");
+
+   {
+      std::lock_guard guard(timer_ref_mutex);
+      if(timers.empty())
+         checktime_thread = std::thread(&impl::run, checktime_generation);
+      timers.push_back(this);
+   }
+
+   compute_and_print_timer_accuracy(*this);
+}
+
+platform_timer::~platform_timer() {
+   stop();
+   std::thread to_join;
+   {
+      std::lock_guard guard(timer_ref_mutex);
+      timers.erase(std::find(timers.begin(), timers.end(), this));
+      if(timers.empty()) {
+         ++checktime_generation;
+         to_join = std::move(checktime_thread);
+      }
+   }
+   if(to_join.joinable()) {
+      {
+         std::lock_guard wake_guard(wake_mutex);
+         wake_cv.notify_all();
+      }
+      to_join.join();
+   }
+}
+
+void platform_timer::start(fc::time_point tp) {
+   my->disarm();
+   if(tp == fc::time_point::maximum()) {
+      expired = 0;
+      return;
+   }
+   fc::microseconds x = tp.time_since_epoch() - fc::time_point::now().time_since_epoch();
+   if(x.count() <= 0)
+      expired = 1;
+   else {
+      expired = 0;
+      my->deadline.store(tp.time_since_epoch().count());
+      if(watcher_sleeping.load()) {
+         std::lock_guard wake_guard(wake_mutex);
+         wake_cv.notify_all();
+      }
+   }
+}
+
+void platform_timer::stop() {
+   if(expired)
+      return;
+   my->disarm();
+   expired = 1;
+}
+
+}}
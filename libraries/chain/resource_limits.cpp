@@ -7,6 +7,8 @@
 #include <boost/tuple/tuple_io.hpp>
 #include <eosio/chain/database_utils.hpp>
 #include <algorithm>
+#include <optional>
+#include <unordered_map>
 
 namespace eosio { namespace chain { namespace resource_limits {
 
@@ -48,6 +50,154 @@ void resource_limits_state_object::update_virtual_net_limit( const resource_limi
    virtual_net_limit = update_elastic_limit(virtual_net_limit, average_block_net_usage.average(), cfg.net_limit_parameters);
 }
 
+struct resource_limits_manager::pending_account_usage {
+   usage_accumulator net_usage;
+   usage_accumulator cpu_usage;
+};
+
+struct resource_limits_manager::batched_usage {
+   struct journal_entry {
+      account_name                         owner;
+      std::optional<pending_account_usage> previous; ///< empty when the account had no batched usage
+   };
+
+   std::unordered_map<account_name, pending_account_usage> accounts;
+   std::vector<journal_entry>                              journal;
+   uint64_t                                                pending_cpu_usage = 0;
+   uint64_t                                                pending_net_usage = 0;
+   uint64_t                                                generation = 0; ///< bumped on flush, invalidates older checkpoints
+};
+
+resource_limits_manager::resource_limits_manager(chainbase::database& db, std::function<deep_mind_handler*(bool is_trx_transient)> get_deep_mind_logger)
+:_db(db),_get_deep_mind_logger(get_deep_mind_logger)
+{
+}
+
+resource_limits_manager::~resource_limits_manager() = default;
+
+resource_limits_manager::usage_checkpoint::usage_checkpoint( resource_limits_manager& rl ) {
+   if( rl._batched ) {
+      _rl                = &rl;
+      _generation        = rl._batched->generation;
+      _journal_size      = rl._batched->journal.size();
+      _pending_cpu_usage = rl._batched->pending_cpu_usage;
+      _pending_net_usage = rl._batched->pending_net_usage;
+   }
+}
+
+resource_limits_manager::usage_checkpoint::usage_checkpoint( usage_checkpoint&& other )
+:_rl(other._rl)
+,_generation(other._generation)
+,_journal_size(other._journal_size)
+,_pending_cpu_usage(other._pending_cpu_usage)
+,_pending_net_usage(other._pending_net_usage)
+{
+   other._rl = nullptr;
+}
+
+resource_limits_manager::usage_checkpoint& resource_limits_manager::usage_checkpoint::operator=( usage_checkpoint&& other ) {
+   if( this != &other ) {
+      undo();
+      _rl                = other._rl;
+      _generation        = other._generation;
+      _journal_size      = other._journal_size;
+      _pending_cpu_usage = other._pending_cpu_usage;
+      _pending_net_usage = other._pending_net_usage;
+      other._rl = nullptr;
+   }
+   return *this;
+}
+
+resource_limits_manager::usage_checkpoint::~usage_checkpoint() {
+   undo();
+}
+
+void resource_limits_manager::usage_checkpoint::commit() {
+   _rl = nullptr;
+}
+
+void resource_limits_manager::usage_checkpoint::undo() {
+   if( _rl ) {
+      _rl->rollback_batched_usage( *this );
+      _rl = nullptr;
+   }
+}
+
+void resource_limits_manager::set_batched_usage( bool enabled ) {
+   if( enabled ) {
+      if( !_batched )
+         _batched = std::make_unique<batched_usage>();
+   } else if( _batched ) {
+      flush_batched_usage();
+      _batched.reset();
+   }
+}
+
+void resource_limits_manager::flush_batched_usage() {
+   if( !_batched )
+      return;
+
+   for( const auto& [owner, pending] : _batched->accounts ) {
+      const auto& usage = _db.get<resource_usage_object,by_owner>( owner );
+      _db.modify( usage, [&]( auto& bu ){
+         bu.net_usage = pending.net_usage;
+         bu.cpu_usage = pending.cpu_usage;
+      });
+   }
+
+   if( _batched->pending_cpu_usage > 0 || _batched->pending_net_usage > 0 ) {
+      const auto& state = _db.get<resource_limits_state_object>();
+      _db.modify(state, [&](resource_limits_state_object& rls){
+         rls.pending_cpu_usage += _batched->pending_cpu_usage;
+         rls.pending_net_usage += _batched->pending_net_usage;
+      });
+   }
+
+   _batched->accounts.clear();
+   _batched->journal.clear();
+   _batched->pending_cpu_usage = 0;
+   _batched->pending_net_usage = 0;
+   ++_batched->generation;
+}
+
+void resource_limits_manager::rollback_batched_usage( const usage_checkpoint& cp ) {
+   // a flush since the checkpoint was taken moved everything into the database, whose own undo session covers it
+   if( !_batched || _batched->generation != cp._generation )
+      return;
+
+   auto& journal = _batched->journal;
+   while( journal.size() > cp._journal_size ) {
+      const auto& e = journal.back();
+      if( e.previous )
+         _batched->accounts.at( e.owner ) = *e.previous;
+      else
+         _batched->accounts.erase( e.owner );
+      journal.pop_back();
+   }
+   _batched->pending_cpu_usage = cp._pending_cpu_usage;
+   _batched->pending_net_usage = cp._pending_net_usage;
+}
+
+resource_limits_manager::pending_account_usage resource_limits_manager::get_pending_usage( const account_name& account ) const {
+   if( _batched ) {
+      auto itr = _batched->accounts.find( account );
+      if( itr != _batched->accounts.end() )
+         return itr->second;
+   }
+   const auto& usage = _db.get<resource_usage_object,by_owner>( account );
+   return { usage.net_usage, usage.cpu_usage };
+}
+
+void resource_limits_manager::set_pending_usage( const account_name& account, const pending_account_usage& usage ) {
+   auto [itr, inserted] = _batched->accounts.try_emplace( account, usage );
+   if( inserted ) {
+      _batched->journal.push_back( { account, {} } );
+   } else {
+      _batched->journal.push_back( { account, itr->second } );
+      itr->second = usage;
+   }
+}
+
 void resource_limits_manager::add_indices() {
    resource_index_set::add_indices(_db);
 }
@@ -128,6 +278,13 @@ void resource_limits_manager::set_block_parameters(const elastic_limit_parameter
 void resource_limits_manager::update_account_usage(const flat_set<account_name>& accounts, uint32_t time_slot ) {
    const auto& config = _db.get<resource_limits_config_object>();
    for( const auto& a : accounts ) {
+      if( _batched ) {
+         auto pending = get_pending_usage( a );
+         pending.net_usage.add( 0, time_slot, config.account_net_usage_average_window );
+         pending.cpu_usage.add( 0, time_slot, config.account_cpu_usage_average_window );
+         set_pending_usage( a, pending );
+         continue;
+      }
       const auto& usage = _db.get<resource_usage_object,by_owner>( a );
       _db.modify( usage, [&]( auto& bu ){
           bu.net_usage.add( 0, time_slot, config.account_net_usage_average_window );
@@ -142,25 +299,38 @@ void resource_limits_manager::add_transaction_usage(const flat_set<account_name>
 
    for( const auto& a : accounts ) {
 
-      const auto& usage = _db.get<resource_usage_object,by_owner>( a );
       int64_t unused;
       int64_t net_weight;
       int64_t cpu_weight;
       get_account_limits( a, unused, net_weight, cpu_weight );
 
-      _db.modify( usage, [&]( auto& bu ){
-          bu.net_usage.add( net_usage, time_slot, config.account_net_usage_average_window );
-          bu.cpu_usage.add( cpu_usage, time_slot, config.account_cpu_usage_average_window );
-
-         if (auto dm_logger = _get_deep_mind_logger(is_trx_transient)) {
-            dm_logger->on_update_account_usage(bu);
-         }
-      });
+      uint64_t cpu_value_ex;
+      uint64_t net_value_ex;
+      if( _batched ) {
+         auto pending = get_pending_usage( a );
+         pending.net_usage.add( net_usage, time_slot, config.account_net_usage_average_window );
+         pending.cpu_usage.add( cpu_usage, time_slot, config.account_cpu_usage_average_window );
+         set_pending_usage( a, pending );
+         cpu_value_ex = pending.cpu_usage.value_ex;
+         net_value_ex = pending.net_usage.value_ex;
+      } else {
+         const auto& usage = _db.get<resource_usage_object,by_owner>( a );
+         _db.modify( usage, [&]( auto& bu ){
+             bu.net_usage.add( net_usage, time_slot, config.account_net_usage_average_window );
+             bu.cpu_usage.add( cpu_usage, time_slot, config.account_cpu_usage_average_window );
+
+            if (auto dm_logger = _get_deep_mind_logger(is_trx_transient)) {
+               dm_logger->on_update_account_usage(bu);
+            }
+         });
+         cpu_value_ex = usage.cpu_usage.value_ex;
+         net_value_ex = usage.net_usage.value_ex;
+      }
 
       if( cpu_weight >= 0 && state.total_cpu_weight > 0 ) {
          uint128_t window_size = config.account_cpu_usage_average_window;
          auto virtual_network_capacity_in_window = (uint128_t)state.virtual_cpu_limit * window_size;
-         auto cpu_used_in_window                 = ((uint128_t)usage.cpu_usage.value_ex * window_size) / (uint128_t)config::rate_limiting_precision;
+         auto cpu_used_in_window                 = ((uint128_t)cpu_value_ex * window_size) / (uint128_t)config::rate_limiting_precision;
 
          uint128_t user_weight     = (uint128_t)cpu_weight;
          uint128_t all_user_weight = state.total_cpu_weight;
@@ -180,7 +350,7 @@ void resource_limits_manager::add_transaction_usage(const flat_set<account_name>
 
          uint128_t window_size = config.account_net_usage_average_window;
          auto virtual_network_capacity_in_window = (uint128_t)state.virtual_net_limit * window_size;
-         auto net_used_in_window                 = ((uint128_t)usage.net_usage.value_ex * window_size) / (uint128_t)config::rate_limiting_precision;
+         auto net_used_in_window                 = ((uint128_t)net_value_ex * window_size) / (uint128_t)config::rate_limiting_precision;
 
          uint128_t user_weight     = (uint128_t)net_weight;
          uint128_t all_user_weight = state.total_net_weight;
@@ -199,13 +369,24 @@ void resource_limits_manager::add_transaction_usage(const flat_set<account_name>
    }
 
    // account for this transaction in the block and do not exceed those limits either
-   _db.modify(state, [&](resource_limits_state_object& rls){
-      rls.pending_cpu_usage += cpu_usage;
-      rls.pending_net_usage += net_usage;
-   });
+   uint64_t pending_cpu_usage;
+   uint64_t pending_net_usage;
+   if( _batched ) {
+      _batched->pending_cpu_usage += cpu_usage;
+      _batched->pending_net_usage += net_usage;
+      pending_cpu_usage = state.pending_cpu_usage + _batched->pending_cpu_usage;
+      pending_net_usage = state.pending_net_usage + _batched->pending_net_usage;
+   } else {
+      _db.modify(state, [&](resource_limits_state_object& rls){
+         rls.pending_cpu_usage += cpu_usage;
+         rls.pending_net_usage += net_usage;
+      });
+      pending_cpu_usage = state.pending_cpu_usage;
+      pending_net_usage = state.pending_net_usage;
+   }
 
-   EOS_ASSERT( state.pending_cpu_usage <= config.cpu_limit_parameters.max, block_resource_exhausted, "Block has insufficient cpu resources" );
-   EOS_ASSERT( state.pending_net_usage <= config.net_limit_parameters.max, block_resource_exhausted, "Block has insufficient net resources" );
+   EOS_ASSERT( pending_cpu_usage <= config.cpu_limit_parameters.max, block_resource_exhausted, "Block has insufficient cpu resources" );
+   EOS_ASSERT( pending_net_usage <= config.net_limit_parameters.max, block_resource_exhausted, "Block has insufficient net resources" );
 }
 
 void resource_limits_manager::add_pending_ram_usage( const account_name account, int64_t ram_delta, bool is_trx_transient ) {
@@ -413,13 +594,13 @@ uint64_t resource_limits_manager::get_virtual_block_net_limit() const {
 uint64_t resource_limits_manager::get_block_cpu_limit() const {
    const auto& state = _db.get<resource_limits_state_object>();
    const auto& config = _db.get<resource_limits_config_object>();
-   return config.cpu_limit_parameters.max - state.pending_cpu_usage;
+   return config.cpu_limit_parameters.max - state.pending_cpu_usage - (_batched ? _batched->pending_cpu_usage : 0);
 }
 
 uint64_t resource_limits_manager::get_block_net_limit() const {
    const auto& state = _db.get<resource_limits_state_object>();
    const auto& config = _db.get<resource_limits_config_object>();
-   return config.net_limit_parameters.max - state.pending_net_usage;
+   return config.net_limit_parameters.max - state.pending_net_usage - (_batched ? _batched->pending_net_usage : 0);
 }
 
 std::pair<int64_t, bool> resource_limits_manager::get_account_cpu_limit( const account_name& name, uint32_t greylist_limit ) const {
@@ -431,7 +612,7 @@ std::pair<account_resource_limit, bool>
 resource_limits_manager::get_account_cpu_limit_ex( const account_name& name, uint32_t greylist_limit, const std::optional<block_timestamp_type>& current_time) const {
 
    const auto& state = _db.get<resource_limits_state_object>();
-   const auto& usage = _db.get<resource_usage_object, by_owner>(name);
+   const auto  usage = get_pending_usage( name );
    const auto& config = _db.get<resource_limits_config_object>();
 
    int64_t cpu_weight, x, y;
@@ -493,7 +674,7 @@ std::pair<account_resource_limit, bool>
 resource_limits_manager::get_account_net_limit_ex( const account_name& name, uint32_t greylist_limit, const std::optional<block_timestamp_type>& current_time) const {
    const auto& config = _db.get<resource_limits_config_object>();
    const auto& state  = _db.get<resource_limits_state_object>();
-   const auto& usage  = _db.get<resource_usage_object, by_owner>(name);
+   const auto  usage  = get_pending_usage( name );
 
    int64_t net_weight, x, y;
    get_account_limits( name, x, net_weight, y );
@@ -0,0 +1,299 @@
+#include <eosio/chain/state_commitment.hpp>
+#include <eosio/chain/account_object.hpp>
+#include <eosio/chain/block_header.hpp>
+#include <eosio/chain/block_summary_object.hpp>
+#include <eosio/chain/code_object.hpp>
+#include <eosio/chain/contract_table_objects.hpp>
+#include <eosio/chain/exceptions.hpp>
+#include <eosio/chain/generated_transaction_object.hpp>
+#include <eosio/chain/global_property_object.hpp>
+#include <eosio/chain/permission_link_object.hpp>
+#include <eosio/chain/permission_object.hpp>
+#include <eosio/chain/protocol_state_object.hpp>
+#include <eosio/chain/resource_limits_private.hpp>
+#include <eosio/chain/snapshot.hpp>
+#include <eosio/chain/thread_utils.hpp>
+#include <eosio/chain/transaction_object.hpp>
+
+#include <fc/io/fstream.hpp>
+#include <fc/scoped_exit.hpp>
+
+#include <future>
+#include <map>
+
+namespace eosio { namespace chain {
+
+namespace {
+
+   // every index of the chain state except database_header, in snapshot order
+   using committed_indices = std::tuple<
+      account_index*,
+      account_metadata_index*,
+      account_ram_correction_index*,
+      global_property_multi_index*,
+      protocol_state_multi_index*,
+      dynamic_global_property_multi_index*,
+      block_summary_multi_index*,
+      transaction_multi_index*,
+      generated_transaction_multi_index*,
+      code_index*,
+      table_id_multi_index*,
+      key_value_index*,
+      index64_index*,
+      index128_index*,
+      index256_index*,
+      index_double_index*,
+      index_long_double_index*,
+      permission_index*,
+      permission_usage_index*,
+      permission_link_index*,
+      resource_limits::resource_limits_index*,
+      resource_limits::resource_usage_index*,
+      resource_limits::resource_limits_state_index*,
+      resource_limits::resource_limits_config_index*
+   >;
+
+   const std::array<const char*, std::tuple_size_v<committed_indices>> index_names = {
+      "account",
+      "account_metadata",
+      "account_ram_correction",
+      "global_property",
+      "protocol_state",
+      "dynamic_global_property",
+      "block_summary",
+      "transaction",
+      "generated_transaction",
+      "code",
+      "contract_table",
+      "contract_row",
+      "contract_index64",
+      "contract_index128",
+      "contract_index256",
+      "contract_index_double",
+      "contract_index_long_double",
+      "permission",
+      "permission_usage",
+      "permission_link",
+      "resource_limits",
+      "resource_usage",
+      "resource_limits_state",
+      "resource_limits_config"
+   };
+
+   // calls f( position, (index_type*)nullptr ) for every committed index
+   template<typename F>
+   void for_each_index( F&& f ) {
+      size_t i = 0;
+      std::apply( [&]( auto... index_ptrs ) { ( f( i++, index_ptrs ), ... ); }, committed_indices{} );
+   }
+
+   template<typename T, typename = void>
+   struct is_contract_row : std::false_type {};
+
+   template<typename T>
+   struct is_contract_row<T, std::void_t<decltype(std::declval<T>().t_id)>> : std::true_type {};
+
+   /**
+    * Hashes rows, resolving the rows they refer to by id. Rows removed in the undo session being applied are
+    * still referenced by the old values of that session, so they are looked up there as well.
+    */
+   class row_hasher {
+      public:
+         explicit row_hasher( const chainbase::database& db )
+         :_db(db) {}
+
+         void add_removed( const table_id_object& t )   { _removed_tables[t.id._id] = &t; }
+         void add_removed( const permission_object& p ) { _removed_permissions[p.id._id] = &p; }
+
+         template<typename T>
+         digest_type operator()( const T& row ) const {
+            digest_type::encoder enc;
+            if constexpr( std::is_same_v<T, permission_object> ) {
+               // snapshot_row_traits<permission_object> also inlines the usage row, which is committed on its own
+               snapshot_permission_object res;
+               res.parent = find( _db.get_index<permission_index>(), _removed_permissions, row.parent._id ).name;
+               res.owner = row.owner;
+               res.name = row.name;
+               res.last_updated = row.last_updated;
+               res.auth = row.auth.to_authority();
+               fc::raw::pack( enc, res );
+            } else {
+               if constexpr( is_contract_row<T>::value ) {
+                  const auto& t = find( _db.get_index<table_id_multi_index>(), _removed_tables, row.t_id._id );
+                  fc::raw::pack( enc, t.code );
+                  fc::raw::pack( enc, t.scope );
+                  fc::raw::pack( enc, t.table );
+               }
+               fc::raw::pack( enc, detail::snapshot_row_traits<T>::to_snapshot_row( row, _db ) );
+            }
+            return enc.result();
+         }
+
+      private:
+         template<typename Index, typename Object>
+         static const Object& find( const Index& index, const std::map<int64_t, const Object*>& removed, int64_t id ) {
+            if( const auto* obj = index.find( id ) )
+               return *obj;
+            auto itr = removed.find( id );
+            EOS_ASSERT( itr != removed.end(), database_exception, "state commitment cannot find row ${id} of ${t}",
+                        ("id", id)("t", boost::core::demangle( typeid( Object ).name() )) );
+            return *itr->second;
+         }
+
+         const chainbase::database&                    _db;
+         std::map<int64_t, const table_id_object*>     _removed_tables;
+         std::map<int64_t, const permission_object*>   _removed_permissions;
+   };
+
+} // anonymous namespace
+
+void state_commitment::index_sum::add( const digest_type& d ) {
+   for( size_t i = 0; i < lanes.size(); ++i )
+      lanes[i] += d._hash[i];
+}
+
+void state_commitment::index_sum::sub( const digest_type& d ) {
+   for( size_t i = 0; i < lanes.size(); ++i )
+      lanes[i] -= d._hash[i];
+}
+
+digest_type state_commitment::index_sum::digest() const {
+   return digest_type::hash( *this );
+}
+
+state_commitment::state_commitment()
+:_sums(index_names.size())
+{
+}
+
+void state_commitment::calculate( const chainbase::database& db, boost::asio::io_context& thread_pool ) {
+   // indices are independent, sum them concurrently; nothing modifies db meanwhile
+   std::vector<std::future<index_sum>> futures;
+   for_each_index( [&]( size_t, auto* index_ptr ) {
+      using index_t = std::remove_pointer_t<decltype(index_ptr)>;
+      futures.emplace_back( post_async_task( thread_pool, [&db]() {
+         row_hasher hasher( db );
+         index_sum sum;
+         for( const auto& row : db.get_index<index_t>().indices() )
+            sum.add( hasher( row ) );
+         return sum;
+      } ) );
+   } );
+
+   for( size_t i = 0; i < futures.size(); ++i )
+      _sums[i] = futures[i].get();
+   _history.clear();
+   _valid = true;
+}
+
+void state_commitment::apply_last_undo_session( const chainbase::database& db ) {
+   if( !_valid )
+      return;
+
+   row_hasher hasher( db );
+   for( const auto& t : db.get_index<table_id_multi_index>().last_undo_session().removed_values )
+      hasher.add_removed( t );
+   for( const auto& p : db.get_index<permission_index>().last_undo_session().removed_values )
+      hasher.add_removed( p );
+
+   for_each_index( [&]( size_t i, auto* index_ptr ) {
+      using index_t = std::remove_pointer_t<decltype(index_ptr)>;
+      const auto& index = db.get_index<index_t>();
+      auto undo = index.last_undo_session();
+      auto& sum = _sums[i];
+
+      for( const auto& old : undo.old_values ) {
+         sum.sub( hasher( old ) );
+         sum.add( hasher( index.get( old.id ) ) );
+      }
+      for( const auto& removed : undo.removed_values )
+         sum.sub( hasher( removed ) );
+      for( const auto& created : undo.new_values )
+         sum.add( hasher( created ) );
+   } );
+}
+
+void state_commitment::invalidate() {
+   _valid = false;
+   _history.clear();
+}
+
+digest_type state_commitment::digest() const {
+   EOS_ASSERT( _valid, database_exception, "state commitment has not been calculated" );
+   return digest_type::hash( _sums );
+}
+
+std::vector<std::pair<std::string, digest_type>> state_commitment::index_digests() const {
+   EOS_ASSERT( _valid, database_exception, "state commitment has not been calculated" );
+   std::vector<std::pair<std::string, digest_type>> result;
+   result.reserve( _sums.size() );
+   for( size_t i = 0; i < _sums.size(); ++i )
+      result.emplace_back( index_names[i], _sums[i].digest() );
+   return result;
+}
+
+void state_commitment::record_block( const block_id_type& id ) {
+   if( !_valid )
+      return;
+   if( !_history.empty() && _history.back().first == id )
+      _history.back().second = _sums;
+   else
+      _history.emplace_back( id, _sums );
+}
+
+void state_commitment::restore_block( const block_id_type& id ) {
+   while( !_history.empty() && _history.back().first != id )
+      _history.pop_back();
+   if( _history.empty() ) {
+      invalidate();
+      return;
+   }
+   _sums = _history.back().second;
+}
+
+void state_commitment::prune_blocks( uint32_t block_num ) {
+   while( !_history.empty() && block_header::num_from_id( _history.front().first ) < block_num )
+      _history.pop_front();
+}
+
+void state_commitment::write( const fc::path& file, const block_id_type& head ) const {
+   if( !_valid )
+      return;
+   std::ofstream out( file.generic_string().c_str(), std::ios::out | std::ios::binary | std::ofstream::trunc );
+   fc::raw::pack( out, magic_number );
+   fc::raw::pack( out, version );
+   fc::raw::pack( out, head );
+   fc::raw::pack( out, _sums );
+}
+
+bool state_commitment::read( const fc::path& file, const block_id_type& head ) {
+   if( !fc::exists( file ) )
+      return false;
+   try {
+      auto remove_file = fc::make_scoped_exit( [&file]() { fc::remove( file ); } );
+      string content;
+      fc::read_file_contents( file, content );
+      fc::datastream<const char*> ds( content.data(), content.size() );
+
+      uint32_t totem = 0, ver = 0;
+      block_id_type id;
+      sums_type sums;
+      fc::raw::unpack( ds, totem );
+      fc::raw::unpack( ds, ver );
+      if( totem != magic_number || ver != version )
+         return false;
+      fc::raw::unpack( ds, id );
+      fc::raw::unpack( ds, sums );
+      if( id != head || sums.size() != _sums.size() )
+         return false;
+
+      _sums = std::move( sums );
+      _history.clear();
+      _valid = true;
+      return true;
+   } FC_LOG_AND_DROP();
+   wlog( "Unable to read state commitment file ${f}, recalculating", ("f", file.generic_string()) );
+   return false;
+}
+
+} } /// eosio::chain
@@ -0,0 +1,103 @@
+#include <eosio/chain/table_temperature.hpp>
+#include <eosio/chain/contract_table_objects.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace eosio { namespace chain {
+
+namespace {
+
+   // adds the resident and non-resident bytes of the pages spanning [addr, addr+size)
+   void add_residency( const void* addr, size_t size, uint64_t& resident, uint64_t& nonresident ) {
+      const uintptr_t page_size = sysconf( _SC_PAGESIZE );
+      const uintptr_t begin = reinterpret_cast<uintptr_t>( addr ) & ~( page_size - 1 );
+      const uintptr_t end   = reinterpret_cast<uintptr_t>( addr ) + size;
+      constexpr size_t chunk_pages = 1 << 20;
+
+      std::vector<unsigned char> vec;
+      for( uintptr_t pos = begin; pos < end; ) {
+         const size_t len = std::min<uintptr_t>( end - pos, chunk_pages * page_size );
+         const size_t pages = ( len + page_size - 1 ) / page_size;
+         vec.resize( pages );
+         if( mincore( reinterpret_cast<void*>( pos ), len, vec.data() ) != 0 )
+            return;
+         for( unsigned char v : vec ) {
+            if( v & 1 )
+               resident += page_size;
+            else
+               nonresident += page_size;
+         }
+         pos += len;
+      }
+   }
+
+} // anonymous namespace
+
+table_temperature::table_temperature( uint32_t cold_after_blocks )
+:_cold_after_blocks(cold_after_blocks)
+,_chunks(std::make_unique<std::atomic<std::atomic<uint32_t>*>[]>(num_chunks))
+{
+}
+
+table_temperature::~table_temperature() {
+   for( uint32_t i = 0; i < num_chunks; ++i )
+      delete[] _chunks[i].load( std::memory_order_relaxed );
+}
+
+std::atomic<uint32_t>* table_temperature::allocate_chunk( std::atomic<std::atomic<uint32_t>*>& c ) {
+   auto* slots = new std::atomic<uint32_t>[size_t(1) << chunk_bits]();
+   std::atomic<uint32_t>* expected = nullptr;
+   if( c.compare_exchange_strong( expected, slots, std::memory_order_acq_rel ) )
+      return slots;
+   // allocated by another thread meanwhile
+   delete[] slots;
+   return expected;
+}
+
+void table_temperature::set_block_num( uint32_t block_num ) {
+   if( _start_block_num == 0 )
+      _start_block_num = block_num;
+   _block_num.store( block_num, std::memory_order_relaxed );
+}
+
+uint32_t table_temperature::last_access( int64_t table_id ) const {
+   if( static_cast<uint64_t>( table_id ) >> 32 )
+      return _block_num.load( std::memory_order_relaxed ); // not tracked, never reported cold
+   const auto* slot = find_slot( table_id, false );
+   return std::max( slot ? slot->load( std::memory_order_relaxed ) : 0u, _start_block_num );
+}
+
+std::optional<table_temperature::table_report> table_temperature::walk_tables( const chainbase::database& db, size_t max_tables ) {
+   const auto& idx = db.get_index<table_id_multi_index, by_id>();
+   auto itr = idx.lower_bound( table_id_object::id_type( _walk_next_id ) );
+   for( size_t n = 0; itr != idx.end() && n < max_tables; ++itr, ++n ) {
+      if( is_cold( itr->id._id ) ) {
+         ++_walk.cold_tables;
+         _walk.cold_rows += itr->count;
+      } else {
+         ++_walk.hot_tables;
+         _walk.hot_rows += itr->count;
+      }
+      _walk_next_id = itr->id._id + 1;
+   }
+   if( itr != idx.end() )
+      return {};
+
+   const table_report r = _walk;
+   _walk = {};
+   _walk_next_id = 0;
+   return r;
+}
+
+table_temperature::residency_report table_temperature::state_residency( const chainbase::database& db ) {
+   residency_report r;
+   const auto* segment = db.get_segment_manager();
+   add_residency( segment, segment->get_size(), r.resident_bytes, r.nonresident_bytes );
+   return r;
+}
+
+} } /// eosio::chain
@@ -63,6 +63,7 @@ namespace eosio { namespace chain {
    {
       if (!c.skip_db_sessions() && !is_read_only()) {
          undo_session.emplace(c.mutable_db().start_undo_session(true));
+         usage_checkpoint.emplace(c.get_mutable_resource_limits_manager());
       }
       trace->id = id;
       trace->block_num = c.head_block_num() + 1;
@@ -411,10 +412,12 @@ namespace eosio { namespace chain {
 
    void transaction_context::squash() {
       if (undo_session) undo_session->squash();
+      if (usage_checkpoint) usage_checkpoint->commit();
    }
 
    void transaction_context::undo() {
       if (undo_session) undo_session->undo();
+      if (usage_checkpoint) usage_checkpoint->undo();
    }
 
    void transaction_context::check_net_usage()const {
@@ -2,6 +2,8 @@
 
 #include <appbase/application_base.hpp>
 #include <eosio/chain/exec_pri_queue.hpp>
+#include <chrono>
+#include <limits>
 #include <mutex>
 
 /*
@@ -41,6 +43,21 @@ public:
          return boost::asio::post( io_serv_, read_only_queue_.wrap( priority, --order_, std::forward<Func>( func)));
    }
 
+   // Like post() but if func has not started executing by deadline, on_expired is called in its place.
+   // Lets callers that give up on a result after some time, e.g. http requests, keep stale work off the app thread.
+   template <typename Func, typename ExpiredFunc>
+   auto post( int priority, exec_queue q, std::chrono::steady_clock::time_point deadline, Func&& func, ExpiredFunc&& on_expired ) {
+      auto& queue = q == exec_queue::read_write ? read_write_queue_ : read_only_queue_;
+      return post( priority, q, [&queue, deadline, func=std::forward<Func>(func), on_expired=std::forward<ExpiredFunc>(on_expired)]() mutable {
+         if( std::chrono::steady_clock::now() >= deadline ) {
+            queue.record_expired();
+            on_expired();
+         } else {
+            func();
+         }
+      } );
+   }
+
    // Legacy and deprecated. To be removed after cleaning up its uses in base appbase
    template <typename Func>
    auto post( int priority, Func&& func ) {
@@ -54,13 +71,13 @@ public:
    bool execute_highest() {
       if ( exec_window_ == exec_window::write ) {
          // During write window only main thread is accessing anything in two_queue_executor, no locking required
-         if( !read_write_queue_.empty() && (read_only_queue_.empty() || *read_only_queue_.top() < *read_write_queue_.top()) )  {
-            // read_write_queue_'s top function's priority greater than read_only_queue_'s top function's, or read_only_queue_ empty
+         if( !read_write_queue_.empty() && (!read_only_runnable() || *read_only_queue_.top() < *read_write_queue_.top()) )  {
+            // read_write_queue_'s top function's priority greater than read_only_queue_'s top function's, or no read_only function to run
             read_write_queue_.execute_highest();
-         } else if( !read_only_queue_.empty() ) {
+         } else if( read_only_runnable() ) {
             read_only_queue_.execute_highest();
          }
-         return !read_only_queue_.empty() || !read_write_queue_.empty();
+         return read_only_runnable() || !read_write_queue_.empty();
       } else {
          // When in read window, multiple threads including main app thread are accessing two_queue_executor, locking required
          return read_only_queue_.execute_highest_locked(false);
@@ -100,6 +117,18 @@ public:
       read_only_queue_.disable_locking();
    }
 
+   // During the write window the app thread leaves read_only tasks with priority below `priority` queued for the
+   // read-only thread pool to execute in the next read window, so they cannot delay blocks and transactions.
+   // Only useful when a read-only thread pool exists; the default runs every read_only task on the app thread.
+   void set_app_thread_min_read_only_priority( int priority ) {
+      app_thread_min_read_only_priority_ = priority;
+   }
+
+   // per queue depth and latency statistics accumulated since the previous call, thread safe
+   exec_pri_queue::stats take_stats( exec_queue q ) {
+      return q == exec_queue::read_write ? read_write_queue_.take_stats() : read_only_queue_.take_stats();
+   }
+
    bool is_read_window() const {
       return exec_window_ == exec_window::read;
    }
@@ -114,11 +143,17 @@ public:
 
    // members are ordered taking into account that the last one is destructed first
 private:
+   // write window only
+   bool read_only_runnable() const {
+      return !read_only_queue_.empty() && read_only_queue_.top()->priority() >= app_thread_min_read_only_priority_;
+   }
+
    boost::asio::io_service            io_serv_;
    appbase::exec_pri_queue            read_only_queue_;
    appbase::exec_pri_queue            read_write_queue_;
    std::atomic<std::size_t>           order_ { std::numeric_limits<size_t>::max() }; // to maintain FIFO ordering in both queues within priority
    exec_window                        exec_window_ { exec_window::write };
+   int                                app_thread_min_read_only_priority_ { std::numeric_limits<int>::min() };
 };
 
 using application = application_t<two_queue_executor>;
@@ -1,6 +1,8 @@
 #pragma once
 #include <boost/asio.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -13,6 +15,15 @@ class exec_pri_queue : public boost::asio::execution_context
 {
 public:
 
+   // accumulated since the previous take_stats()
+   struct stats {
+      uint64_t executed      = 0; // handlers executed, not counting expired ones
+      uint64_t expired       = 0; // handlers that were not run because their deadline passed while queued
+      uint64_t total_wait_us = 0; // time executed and expired handlers spent in the queue
+      uint64_t max_wait_us   = 0; // longest time a handler spent in the queue
+      uint64_t max_depth     = 0; // largest number of handlers queued at once
+   };
+
    void stop() {
       std::lock_guard g( mtx_ );
       exiting_blocking_ = true;
@@ -40,13 +51,32 @@ public:
       if (lock_enabled_) {
          std::lock_guard g( mtx_ );
          handlers_.push( std::move( handler ) );
+         update_max( max_depth_, handlers_.size() );
          if (num_waiting_)
             cond_.notify_one();
       } else {
          handlers_.push( std::move( handler ) );
+         update_max( max_depth_, handlers_.size() );
       }
    }
 
+   // thread safe
+   stats take_stats() {
+      stats s;
+      s.executed      = executed_.exchange(0);
+      s.expired       = expired_.exchange(0);
+      s.total_wait_us = total_wait_us_.exchange(0);
+      s.max_wait_us   = max_wait_us_.exchange(0);
+      s.max_depth     = max_depth_.exchange(0);
+      return s;
+   }
+
+   // called by handlers that skip their work because it is no longer wanted, the handler then counts as expired
+   // instead of executed; must be called from within the handler
+   void record_expired() {
+      handler_expired_ = true;
+   }
+
    // only call when no lock required
    void clear()
    {
@@ -58,9 +88,26 @@ private:
    auto pop() {
       auto t = std::move(const_cast<std::unique_ptr<queued_handler_base>&>(handlers_.top()));
       handlers_.pop();
+      auto wait_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t->enqueued()).count();
+      total_wait_us_ += wait_us;
+      update_max( max_wait_us_, wait_us );
       return t;
    }
 
+   // has to be a template, queued_handler_base is declared below
+   template <typename Handler>
+   void execute(Handler& t) {
+      handler_expired_ = false;
+      t.execute();
+      ++(handler_expired_ ? expired_ : executed_);
+   }
+
+   static void update_max(std::atomic<uint64_t>& m, uint64_t v) {
+      uint64_t cur = m.load(std::memory_order_relaxed);
+      while( cur < v && !m.compare_exchange_weak(cur, v, std::memory_order_relaxed) )
+         ;
+   }
+
 public:
 
    // only call when no lock required
@@ -69,7 +116,7 @@ public:
       if( !handlers_.empty() ) {
          auto t = pop();
          bool empty = handlers_.empty();
-         t->execute();
+         execute(*t);
          return !empty;
       }
 
@@ -100,7 +147,7 @@ public:
          return false;
       auto t = pop();
       g.unlock();
-      t->execute();
+      execute(*t);
       return true;
    }
 
@@ -177,6 +224,7 @@ private:
       queued_handler_base( int p, size_t order )
             : priority_( p )
             , order_( order )
+            , enqueued_( std::chrono::steady_clock::now() )
       {
       }
 
@@ -185,6 +233,7 @@ private:
       virtual void execute() = 0;
 
       int priority() const { return priority_; }
+      std::chrono::steady_clock::time_point enqueued() const { return enqueued_; }
       // C++20
       // friend std::weak_ordering operator<=>(const queued_handler_base&,
       //                                       const queued_handler_base&) noexcept = default;
@@ -197,6 +246,7 @@ private:
    private:
       int priority_;
       size_t order_;
+      std::chrono::steady_clock::time_point enqueued_;
    };
 
    template <typename Function>
@@ -236,6 +286,12 @@ private:
    std::function<bool()> should_exit_; // called holding mtx_
    using prio_queue = std::priority_queue<std::unique_ptr<queued_handler_base>, std::deque<std::unique_ptr<queued_handler_base>>, deref_less>;
    prio_queue handlers_;
+   std::atomic<uint64_t> executed_{0};
+   std::atomic<uint64_t> expired_{0};
+   std::atomic<uint64_t> total_wait_us_{0};
+   std::atomic<uint64_t> max_wait_us_{0};
+   std::atomic<uint64_t> max_depth_{0};
+   inline static thread_local bool handler_expired_ = false; // set by record_expired() of the handler being executed
 };
 
 } // appbase
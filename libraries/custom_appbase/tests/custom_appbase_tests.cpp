@@ -212,4 +212,75 @@ BOOST_AUTO_TEST_CASE( execute_from_both_queues ) {
    BOOST_CHECK_LT( rslts[6], rslts[11] );
 }
 
+// verify read_only functions below the app thread minimum priority are left for the read window
+BOOST_AUTO_TEST_CASE( app_thread_min_read_only_priority ) {
+   appbase::scoped_app app;
+   app->executor().set_app_thread_min_read_only_priority( priority::high );
+   auto app_thread = start_app_thread(app);
+
+   // post functions
+   std::map<int, int> rslts {};
+   int seq_num = 0;
+   app->executor().post( priority::low,    exec_queue::read_only,  [&]() { rslts[0]=seq_num; ++seq_num; } );
+   app->executor().post( priority::medium, exec_queue::read_write, [&]() { rslts[1]=seq_num; ++seq_num; } );
+   app->executor().post( priority::high,   exec_queue::read_only,  [&]() { rslts[2]=seq_num; ++seq_num; } );
+   app->executor().post( priority::medium, exec_queue::read_only,  [&]() { rslts[3]=seq_num; ++seq_num; } );
+   app->executor().post( priority::low,    exec_queue::read_write, [&]() { rslts[4]=seq_num; ++seq_num; } );
+
+   // stop application. Use lowest at the end to make sure this executes the last
+   app->executor().post( priority::lowest, exec_queue::read_write, [&]() {
+      // read_only functions below priority::high are still queued
+      BOOST_REQUIRE_EQUAL( app->executor().read_only_queue().size(), 2 );
+      BOOST_REQUIRE_EQUAL( app->executor().read_write_queue().size(), 0 ); // pop()s before execute
+      app->quit();
+      } );
+   app_thread.join();
+
+   BOOST_REQUIRE_EQUAL( rslts.size(), 3 );
+   BOOST_CHECK_EQUAL( rslts.count(0), 0u );
+   BOOST_CHECK_EQUAL( rslts.count(3), 0u );
+   BOOST_CHECK_LT( rslts[1], rslts[4] );
+}
+
+// verify functions posted with a deadline and the queue statistics
+BOOST_AUTO_TEST_CASE( deadline_and_stats ) {
+   appbase::scoped_app app;
+   auto app_thread = start_app_thread(app);
+
+   // post functions
+   std::map<int, int> rslts {};
+   int seq_num = 0;
+   int expired = 0;
+   auto now = std::chrono::steady_clock::now();
+   app->executor().post( priority::medium, exec_queue::read_write, now, [&]() { rslts[0]=seq_num; ++seq_num; }, [&]() { ++expired; } );
+   app->executor().post( priority::medium, exec_queue::read_write, now + std::chrono::hours(1), [&]() { rslts[1]=seq_num; ++seq_num; }, [&]() { ++expired; } );
+   app->executor().post( priority::medium, exec_queue::read_only,  [&]() { rslts[2]=seq_num; ++seq_num; } );
+
+   // stop application. Use lowest at the end to make sure this executes the last
+   app->executor().post( priority::lowest, exec_queue::read_write, [&]() {
+      app->quit();
+      } );
+   app_thread.join();
+
+   BOOST_REQUIRE_EQUAL( expired, 1 );
+   BOOST_REQUIRE_EQUAL( rslts.size(), 2 );
+   BOOST_CHECK_LT( rslts[1], rslts[2] );
+
+   auto rw_stats = app->executor().take_stats( exec_queue::read_write );
+   BOOST_CHECK_EQUAL( rw_stats.executed, 2u ); // the expired handler is only counted as expired
+   BOOST_CHECK_EQUAL( rw_stats.expired, 1u );
+   BOOST_CHECK_GE( rw_stats.max_depth, 1u );
+   BOOST_CHECK_GE( rw_stats.total_wait_us, rw_stats.max_wait_us );
+
+   auto ro_stats = app->executor().take_stats( exec_queue::read_only );
+   BOOST_CHECK_EQUAL( ro_stats.executed, 1u );
+   BOOST_CHECK_EQUAL( ro_stats.expired, 0u );
+
+   // statistics are reset by take_stats()
+   rw_stats = app->executor().take_stats( exec_queue::read_write );
+   BOOST_CHECK_EQUAL( rw_stats.executed, 0u );
+   BOOST_CHECK_EQUAL( rw_stats.expired, 0u );
+   BOOST_CHECK_EQUAL( rw_stats.max_depth, 0u );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -30,6 +30,22 @@ class sha256
     static sha256 hash( const string& );
     static sha256 hash( const sha256& );
 
+    /**
+     * Hash `count` independent messages of `size` bytes each, stored back to back at `data`, writing the
+     * digest of message i to out[i]. Uses multi-lane AVX2/AVX-512 or SHA extension kernels when the CPU
+     * supports them. `out` may be the same buffer as `data` when size >= sizeof(sha256).
+     */
+    static void hash_many( const char* data, uint32_t size, size_t count, sha256* out );
+
+    /// implementations hash_many selects between depending on the CPU
+    enum class hash_many_kernel { scalar, shani, avx2, avx512 };
+
+    /**
+     * hash_many using kernel k for any count, so tests can check every kernel the CPU supports.
+     * @return false, without hashing, if this build or CPU does not support k
+     */
+    static bool hash_many( hash_many_kernel k, const char* data, uint32_t size, size_t count, sha256* out );
+
     template<typename T>
     static sha256 hash( const T& t ) 
     { 
@@ -0,0 +1,16 @@
+#pragma once
+#include <fc/io/json.hpp>
+
+namespace fc::json_baseline
+{
+   /**
+    *  The implementations json::from_string and escape_string had before they scanned their input in bulk.
+    *  Kept as the reference for benchmarks and differential tests, not for use by nodeos.
+    */
+
+   /// json::from_string parsing through a boost::iostreams stream, one character at a time
+   variant     from_string( const std::string& utf8_str, const json::parse_type ptype = json::parse_type::legacy_parser, uint32_t max_depth = DEFAULT_MAX_RECURSION_DEPTH );
+
+   /// escape_string examining one character at a time
+   std::string escape_string( const std::string_view& str, const json::yield_function_t& yield, bool escape_control_chars = true );
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <fc/log/appender.hpp>
+#include <memory>
+
+namespace fc
+{
+   /**
+    * Moves formatting and output of another appender off the logging thread.
+    *
+    * Each thread that logs through the appender gets its own single producer / single consumer ring of
+    * log_message references, so pushing a message is a few atomic operations and never blocks on the
+    * wrapped appender. A background thread drains all rings and hands the messages to the wrapped appender,
+    * which is where `${}` substitution and the actual write happen. Thread name and timestamp are captured
+    * by log_message at the call site, so deferred output is identical to synchronous output.
+    *
+    * When a thread's ring is full the message is dropped rather than blocking the caller; dropped messages
+    * are counted and reported through the wrapped appender once the backlog clears. Messages from one thread
+    * keep their order; messages from different threads may be interleaved differently than they were logged.
+    *
+    * Enabled per appender with `"async": true` in the logging configuration.
+    */
+   class async_appender final : public appender
+   {
+      public:
+         static constexpr uint32_t default_ring_size = 4096;
+
+         explicit async_appender( appender::ptr inner, uint32_t ring_size = default_ring_size );
+         ~async_appender();
+
+         void initialize() override;
+         void log( const log_message& m ) override;
+
+         /// Blocks until every message pushed before the call has been passed to the wrapped appender
+         void flush();
+
+         /// Total number of messages discarded because a ring was full
+         uint64_t dropped_messages()const;
+
+      private:
+         class impl;
+         std::unique_ptr<impl> my;
+   };
+} // namespace fc
@@ -15,12 +15,15 @@ namespace fc {
         name(name),
         type(type),
         args(fc::move(args)),
-        enabled(true)
+        enabled(true),
+        async(false)
       {}
       string   name;
       string   type;
       variant  args;
       bool     enabled;
+      /// if true, messages are queued per thread and formatted/written by a background thread, see async_appender
+      bool     async;
    };
 
    struct logger_config {
@@ -78,6 +81,6 @@ namespace fc {
 }
 
 #include <fc/reflect/reflect.hpp>
-FC_REFLECT( fc::appender_config, (name)(type)(args)(enabled) )
+FC_REFLECT( fc::appender_config, (name)(type)(args)(enabled)(async) )
 FC_REFLECT( fc::logger_config, (name)(parent)(level)(enabled)(additivity)(appenders) )
 FC_REFLECT( fc::logging_config, (includes)(appenders)(loggers) )
@@ -0,0 +1,358 @@
+#include <fc/crypto/sha256.hpp>
+#include <openssl/sha.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FC_SHA256_X86_KERNELS 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace fc {
+
+namespace {
+
+   constexpr uint32_t k256[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+      0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+      0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+      0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+      0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+   };
+
+   constexpr uint32_t h256[8] = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+   };
+
+   /// number of 64 byte blocks of a padded message of `size` bytes
+   inline size_t padded_blocks( size_t size ) {
+      return (size + 8) / 64 + 1;
+   }
+
+   /**
+    *  Return block `b` of the padded message `msg`. Blocks lying entirely within the message are returned
+    *  in place, the others (holding the 0x80 terminator and/or the bit length) are built in `tmp`.
+    */
+   inline const unsigned char* padded_block( const char* msg, size_t size, size_t b, unsigned char* tmp ) {
+      const size_t off = b * 64;
+      if( off + 64 <= size )
+         return reinterpret_cast<const unsigned char*>(msg + off);
+
+      const size_t n = off < size ? size - off : 0;
+      memcpy( tmp, msg + off, n );
+      memset( tmp + n, 0, 64 - n );
+      if( off <= size )
+         tmp[size - off] = 0x80;
+      if( b + 1 == padded_blocks(size) ) {
+         const uint64_t bits = uint64_t(size) * 8;
+         for( int i = 0; i < 8; ++i )
+            tmp[63 - i] = static_cast<unsigned char>(bits >> (8 * i));
+      }
+      return tmp;
+   }
+
+   inline uint32_t load_be32( const unsigned char* p ) {
+      return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+   }
+
+   inline void store_digest( const uint32_t state[8], sha256& out ) {
+      unsigned char* p = reinterpret_cast<unsigned char*>(out.data());
+      for( int i = 0; i < 8; ++i ) {
+         p[4*i]   = static_cast<unsigned char>(state[i] >> 24);
+         p[4*i+1] = static_cast<unsigned char>(state[i] >> 16);
+         p[4*i+2] = static_cast<unsigned char>(state[i] >> 8);
+         p[4*i+3] = static_cast<unsigned char>(state[i]);
+      }
+   }
+
+   void hash_many_scalar( const char* data, uint32_t size, size_t count, sha256* out ) {
+      for( size_t i = 0; i < count; ++i ) {
+         sha256 h;
+         SHA256( reinterpret_cast<const unsigned char*>(data + i * size), size, reinterpret_cast<unsigned char*>(h.data()) );
+         out[i] = h;
+      }
+   }
+
+#if defined(FC_SHA256_X86_KERNELS)
+
+   // ---- SHA extensions, one message at a time ----
+
+   __attribute__((target("sha,sse4.1,ssse3")))
+   void compress_shani( uint32_t state[8], const unsigned char* block ) {
+      const __m128i mask = _mm_set_epi64x( 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL );
+
+      __m128i tmp    = _mm_loadu_si128( reinterpret_cast<const __m128i*>(&state[0]) );
+      __m128i state1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>(&state[4]) );
+      tmp    = _mm_shuffle_epi32( tmp, 0xB1 );             // CDAB
+      state1 = _mm_shuffle_epi32( state1, 0x1B );          // EFGH
+      __m128i state0 = _mm_alignr_epi8( tmp, state1, 8 );  // ABEF
+      state1 = _mm_blend_epi16( state1, tmp, 0xF0 );       // CDGH
+
+      const __m128i abef_save = state0;
+      const __m128i cdgh_save = state1;
+
+      __m128i m[4];
+#pragma GCC unroll 16
+      for( int g = 0; g < 16; ++g ) {
+         if( g < 4 )
+            m[g] = _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>(block + 16 * g) ), mask );
+         __m128i msg = _mm_add_epi32( m[g % 4], _mm_loadu_si128( reinterpret_cast<const __m128i*>(&k256[4 * g]) ) );
+         state1 = _mm_sha256rnds2_epu32( state1, state0, msg );
+         if( g >= 3 && g <= 14 ) {
+            tmp = _mm_alignr_epi8( m[g % 4], m[(g + 3) % 4], 4 );
+            m[(g + 1) % 4] = _mm_add_epi32( m[(g + 1) % 4], tmp );
+            m[(g + 1) % 4] = _mm_sha256msg2_epu32( m[(g + 1) % 4], m[g % 4] );
+         }
+         msg = _mm_shuffle_epi32( msg, 0x0E );
+         state0 = _mm_sha256rnds2_epu32( state0, state1, msg );
+         if( g >= 1 && g <= 12 )
+            m[(g + 3) % 4] = _mm_sha256msg1_epu32( m[(g + 3) % 4], m[g % 4] );
+      }
+
+      state0 = _mm_add_epi32( state0, abef_save );
+      state1 = _mm_add_epi32( state1, cdgh_save );
+
+      tmp    = _mm_shuffle_epi32( state0, 0x1B );          // FEBA
+      state1 = _mm_shuffle_epi32( state1, 0xB1 );          // DCHG
+      state0 = _mm_blend_epi16( tmp, state1, 0xF0 );       // DCBA
+      state1 = _mm_alignr_epi8( state1, tmp, 8 );          // ABEF
+
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(&state[0]), state0 );
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(&state[4]), state1 );
+   }
+
+   void hash_many_shani( const char* data, uint32_t size, size_t count, sha256* out ) {
+      const size_t blocks = padded_blocks( size );
+      alignas(16) unsigned char tmp[64];
+      for( size_t i = 0; i < count; ++i ) {
+         const char* msg = data + i * size;
+         uint32_t state[8];
+         memcpy( state, h256, sizeof(state) );
+         for( size_t b = 0; b < blocks; ++b )
+            compress_shani( state, padded_block( msg, size, b, tmp ) );
+         store_digest( state, out[i] );
+      }
+   }
+
+   // ---- multi-lane kernels: lane j of every vector belongs to message j of the batch ----
+
+   /**
+    *  Stage block `b` of `lanes` messages transposed into words[16][lanes], so that word t of all lanes can be
+    *  loaded as one vector. Lanes past `n` repeat the last message and their results are discarded.
+    */
+   template<size_t lanes>
+   inline void stage_block( const char* data, uint32_t size, size_t n, size_t b, uint32_t (*words)[lanes] ) {
+      unsigned char tmp[64];
+      for( size_t j = 0; j < lanes; ++j ) {
+         const unsigned char* p = padded_block( data + std::min(j, n - 1) * size, size, b, tmp );
+         for( size_t t = 0; t < 16; ++t )
+            words[t][j] = load_be32( p + 4 * t );
+      }
+   }
+
+   template<size_t lanes>
+   inline void store_lanes( const uint32_t (*state)[lanes], size_t n, sha256* out ) {
+      for( size_t j = 0; j < n; ++j ) {
+         uint32_t s[8];
+         for( size_t i = 0; i < 8; ++i )
+            s[i] = state[i][j];
+         store_digest( s, out[j] );
+      }
+   }
+
+#define FC_SHA256_AVX2 __attribute__((target("avx2"), always_inline)) inline
+
+   FC_SHA256_AVX2 __m256i rotr8( __m256i x, int n ) {
+      return _mm256_or_si256( _mm256_srli_epi32( x, n ), _mm256_slli_epi32( x, 32 - n ) );
+   }
+
+   __attribute__((target("avx2")))
+   void compress_avx2( uint32_t (*state)[8], const uint32_t (*words)[8] ) {
+      __m256i w[16];
+      for( int t = 0; t < 16; ++t )
+         w[t] = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(words[t]) );
+
+      __m256i a = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(state[0]) );
+      __m256i b = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(state[1]) );
+      __m256i c = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(state[2]) );
+      __m256i d = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(state[3]) );
+      __m256i e = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(state[4]) );
+      __m256i f = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(state[5]) );
+      __m256i g = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(state[6]) );
+      __m256i h = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(state[7]) );
+
+      for( int t = 0; t < 64; ++t ) {
+         if( t >= 16 ) {
+            const __m256i w15 = w[(t - 15) & 15], w2 = w[(t - 2) & 15];
+            const __m256i s0 = _mm256_xor_si256( _mm256_xor_si256( rotr8(w15, 7), rotr8(w15, 18) ), _mm256_srli_epi32(w15, 3) );
+            const __m256i s1 = _mm256_xor_si256( _mm256_xor_si256( rotr8(w2, 17), rotr8(w2, 19) ), _mm256_srli_epi32(w2, 10) );
+            w[t & 15] = _mm256_add_epi32( _mm256_add_epi32( w[t & 15], s0 ), _mm256_add_epi32( w[(t - 7) & 15], s1 ) );
+         }
+         const __m256i S1  = _mm256_xor_si256( _mm256_xor_si256( rotr8(e, 6), rotr8(e, 11) ), rotr8(e, 25) );
+         const __m256i ch  = _mm256_xor_si256( _mm256_and_si256( e, f ), _mm256_andnot_si256( e, g ) );
+         const __m256i t1  = _mm256_add_epi32( _mm256_add_epi32( _mm256_add_epi32( h, S1 ), _mm256_add_epi32( ch, w[t & 15] ) ),
+                                               _mm256_set1_epi32( static_cast<int>(k256[t]) ) );
+         const __m256i S0  = _mm256_xor_si256( _mm256_xor_si256( rotr8(a, 2), rotr8(a, 13) ), rotr8(a, 22) );
+         const __m256i maj = _mm256_or_si256( _mm256_and_si256( a, b ), _mm256_and_si256( c, _mm256_or_si256( a, b ) ) );
+         const __m256i t2  = _mm256_add_epi32( S0, maj );
+         h = g; g = f; f = e;
+         e = _mm256_add_epi32( d, t1 );
+         d = c; c = b; b = a;
+         a = _mm256_add_epi32( t1, t2 );
+      }
+
+      const __m256i v[8] = { a, b, c, d, e, f, g, h };
+      for( int i = 0; i < 8; ++i ) {
+         __m256i* s = reinterpret_cast<__m256i*>(state[i]);
+         _mm256_storeu_si256( s, _mm256_add_epi32( _mm256_loadu_si256( s ), v[i] ) );
+      }
+   }
+
+#undef FC_SHA256_AVX2
+
+#define FC_SHA256_AVX512 __attribute__((target("avx512f"), always_inline)) inline
+
+   // ternary logic immediates: 0x96 = x^y^z, 0xca = x?y:z (ch), 0xe8 = majority
+   FC_SHA256_AVX512 __m512i xor3( __m512i x, __m512i y, __m512i z ) { return _mm512_ternarylogic_epi32( x, y, z, 0x96 ); }
+
+   __attribute__((target("avx512f")))
+   void compress_avx512( uint32_t (*state)[16], const uint32_t (*words)[16] ) {
+      __m512i w[16];
+      for( int t = 0; t < 16; ++t )
+         w[t] = _mm512_loadu_si512( words[t] );
+
+      __m512i a = _mm512_loadu_si512( state[0] );
+      __m512i b = _mm512_loadu_si512( state[1] );
+      __m512i c = _mm512_loadu_si512( state[2] );
+      __m512i d = _mm512_loadu_si512( state[3] );
+      __m512i e = _mm512_loadu_si512( state[4] );
+      __m512i f = _mm512_loadu_si512( state[5] );
+      __m512i g = _mm512_loadu_si512( state[6] );
+      __m512i h = _mm512_loadu_si512( state[7] );
+
+      for( int t = 0; t < 64; ++t ) {
+         if( t >= 16 ) {
+            const __m512i w15 = w[(t - 15) & 15], w2 = w[(t - 2) & 15];
+            const __m512i s0 = xor3( _mm512_ror_epi32(w15, 7), _mm512_ror_epi32(w15, 18), _mm512_srli_epi32(w15, 3) );
+            const __m512i s1 = xor3( _mm512_ror_epi32(w2, 17), _mm512_ror_epi32(w2, 19), _mm512_srli_epi32(w2, 10) );
+            w[t & 15] = _mm512_add_epi32( _mm512_add_epi32( w[t & 15], s0 ), _mm512_add_epi32( w[(t - 7) & 15], s1 ) );
+         }
+         const __m512i S1  = xor3( _mm512_ror_epi32(e, 6), _mm512_ror_epi32(e, 11), _mm512_ror_epi32(e, 25) );
+         const __m512i ch  = _mm512_ternarylogic_epi32( e, f, g, 0xca );
+         const __m512i t1  = _mm512_add_epi32( _mm512_add_epi32( _mm512_add_epi32( h, S1 ), _mm512_add_epi32( ch, w[t & 15] ) ),
+                                               _mm512_set1_epi32( static_cast<int>(k256[t]) ) );
+         const __m512i S0  = xor3( _mm512_ror_epi32(a, 2), _mm512_ror_epi32(a, 13), _mm512_ror_epi32(a, 22) );
+         const __m512i maj = _mm512_ternarylogic_epi32( a, b, c, 0xe8 );
+         const __m512i t2  = _mm512_add_epi32( S0, maj );
+         h = g; g = f; f = e;
+         e = _mm512_add_epi32( d, t1 );
+         d = c; c = b; b = a;
+         a = _mm512_add_epi32( t1, t2 );
+      }
+
+      const __m512i v[8] = { a, b, c, d, e, f, g, h };
+      for( int i = 0; i < 8; ++i )
+         _mm512_storeu_si512( state[i], _mm512_add_epi32( _mm512_loadu_si512( state[i] ), v[i] ) );
+   }
+
+#undef FC_SHA256_AVX512
+
+   template<size_t lanes, void (*compress)( uint32_t (*)[lanes], const uint32_t (*)[lanes] )>
+   void hash_many_lanes( const char* data, uint32_t size, size_t count, sha256* out ) {
+      const size_t blocks = padded_blocks( size );
+      alignas(64) uint32_t words[16][lanes];
+      alignas(64) uint32_t state[8][lanes];
+      for( size_t i = 0; i < count; i += lanes ) {
+         const size_t n = std::min( lanes, count - i );
+         const char* batch = data + i * size;
+         for( size_t s = 0; s < 8; ++s )
+            std::fill_n( state[s], lanes, h256[s] );
+         for( size_t b = 0; b < blocks; ++b ) {
+            stage_block<lanes>( batch, size, n, b, words );
+            compress( state, words );
+         }
+         // all input of the batch has been read, so out may alias data
+         store_lanes<lanes>( state, n, out + i );
+      }
+   }
+
+   bool cpu_has_sha_extensions() {
+      unsigned int eax, ebx, ecx, edx;
+      if( !__get_cpuid_count( 7, 0, &eax, &ebx, &ecx, &edx ) )
+         return false;
+      return (ebx & (1u << 29)) && __builtin_cpu_supports( "sse4.1" ) && __builtin_cpu_supports( "ssse3" );
+   }
+
+#endif // FC_SHA256_X86_KERNELS
+
+   using hash_many_fn = void (*)( const char*, uint32_t, size_t, sha256* );
+
+   struct kernel_choice {
+      hash_many_fn fn;
+      size_t       min_count; ///< below this many messages the scalar kernel is used
+   };
+
+   kernel_choice select_hash_many_kernel() {
+#if defined(FC_SHA256_X86_KERNELS)
+      __builtin_cpu_init();
+      if( __builtin_cpu_supports( "avx512f" ) )
+         return { &hash_many_lanes<16, compress_avx512>, 4 };
+      if( cpu_has_sha_extensions() )
+         return { &hash_many_shani, 1 };
+      if( __builtin_cpu_supports( "avx2" ) )
+         return { &hash_many_lanes<8, compress_avx2>, 4 };
+#endif
+      return { &hash_many_scalar, 0 };
+   }
+
+   const kernel_choice& get_hash_many_kernel() {
+      static const kernel_choice kernel = select_hash_many_kernel();
+      return kernel;
+   }
+
+   /// the kernel k if this build and CPU support it, otherwise nullptr
+   hash_many_fn find_hash_many_kernel( sha256::hash_many_kernel k ) {
+      get_hash_many_kernel(); // cpu features are initialized
+      switch( k ) {
+         case sha256::hash_many_kernel::scalar:
+            return &hash_many_scalar;
+#if defined(FC_SHA256_X86_KERNELS)
+         case sha256::hash_many_kernel::shani:
+            return cpu_has_sha_extensions() ? &hash_many_shani : nullptr;
+         case sha256::hash_many_kernel::avx2:
+            return __builtin_cpu_supports( "avx2" ) ? &hash_many_lanes<8, compress_avx2> : nullptr;
+         case sha256::hash_many_kernel::avx512:
+            return __builtin_cpu_supports( "avx512f" ) ? &hash_many_lanes<16, compress_avx512> : nullptr;
+#else
+         case sha256::hash_many_kernel::shani:
+         case sha256::hash_many_kernel::avx2:
+         case sha256::hash_many_kernel::avx512:
+            break;
+#endif
+      }
+      return nullptr;
+   }
+
+} // anonymous namespace
+
+   void sha256::hash_many( const char* data, uint32_t size, size_t count, sha256* out ) {
+      const auto& kernel = get_hash_many_kernel();
+      if( count < kernel.min_count )
+         hash_many_scalar( data, size, count, out );
+      else
+         kernel.fn( data, size, count, out );
+   }
+
+   bool sha256::hash_many( hash_many_kernel k, const char* data, uint32_t size, size_t count, sha256* out ) {
+      const auto fn = find_hash_many_kernel( k );
+      if( !fn )
+         return false;
+      fn( data, size, count, out );
+      return true;
+   }
+
+} // fc
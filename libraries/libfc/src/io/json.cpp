@@ -1,4 +1,5 @@
 #include <fc/io/json.hpp>
+#include <fc/io/json_baseline.hpp>
 //#include <fc/io/fstream.hpp>
 //#include <fc/io/sstream.hpp>
 #include <fc/log/logger.hpp>
@@ -12,8 +13,118 @@
 #include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/stream.hpp>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 namespace fc
 {
+   namespace {
+      /**
+       *  Reader over a contiguous buffer providing the peek/get/eof subset of std::istream used by the parsers,
+       *  with the same EOF semantics, but without the per-character sentry and virtual dispatch of a stream.
+       *  Also allows runs of plain string characters to be located and copied in bulk.
+       */
+      class contiguous_istream {
+      public:
+         contiguous_istream( const char* begin, size_t size )
+         : pos_(begin), end_(begin + size) {}
+
+         int peek() {
+            if( pos_ != end_ ) return static_cast<unsigned char>(*pos_);
+            eof_ = true;
+            return EOF;
+         }
+         int get() {
+            if( pos_ != end_ ) return static_cast<unsigned char>(*pos_++);
+            eof_ = true;
+            return EOF;
+         }
+         bool eof() const { return eof_; }
+
+         const char* pos() const { return pos_; }
+         const char* end() const { return end_; }
+         void skip_to( const char* p ) { pos_ = p; }
+
+      private:
+         const char* pos_;
+         const char* end_;
+         bool        eof_ = false;
+      };
+
+      /// return pointer to first char in [p,end) that is one of the 3 given values, or end
+      inline const char* find_any_of( const char* p, const char* end, char c1, char c2, char c3 ) {
+#if defined(__AVX2__)
+         const __m256i v1 = _mm256_set1_epi8(c1), v2 = _mm256_set1_epi8(c2), v3 = _mm256_set1_epi8(c3);
+         for( ; end - p >= 32; p += 32 ) {
+            const __m256i in = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(p) );
+            const __m256i m = _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi8(in, v1), _mm256_cmpeq_epi8(in, v2) ),
+                                               _mm256_cmpeq_epi8(in, v3) );
+            if( const uint32_t mask = _mm256_movemask_epi8(m) ) return p + __builtin_ctz(mask);
+         }
+#endif
+#if defined(__SSE2__)
+         const __m128i w1 = _mm_set1_epi8(c1), w2 = _mm_set1_epi8(c2), w3 = _mm_set1_epi8(c3);
+         for( ; end - p >= 16; p += 16 ) {
+            const __m128i in = _mm_loadu_si128( reinterpret_cast<const __m128i*>(p) );
+            const __m128i m = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8(in, w1), _mm_cmpeq_epi8(in, w2) ),
+                                            _mm_cmpeq_epi8(in, w3) );
+            if( const uint32_t mask = _mm_movemask_epi8(m) ) return p + __builtin_ctz(mask);
+         }
+#endif
+         for( ; p != end; ++p ) {
+            if( *p == c1 || *p == c2 || *p == c3 ) return p;
+         }
+         return end;
+      }
+
+      /// return pointer to first char in [p,end) that escape_string() may need to escape: < 0x20, '"', '\\' or 0x7f
+      inline const char* find_escape_char( const char* p, const char* end ) {
+#if defined(__AVX2__)
+         const __m256i quote = _mm256_set1_epi8('"'), bslash = _mm256_set1_epi8('\\'), del = _mm256_set1_epi8(0x7f), ctrl = _mm256_set1_epi8(0x1f);
+         for( ; end - p >= 32; p += 32 ) {
+            const __m256i in = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(p) );
+            // unsigned in <= 0x1f  <=>  min(in, 0x1f) == in
+            const __m256i m = _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi8(in, quote), _mm256_cmpeq_epi8(in, bslash) ),
+                                               _mm256_or_si256( _mm256_cmpeq_epi8(in, del), _mm256_cmpeq_epi8(_mm256_min_epu8(in, ctrl), in) ) );
+            if( const uint32_t mask = _mm256_movemask_epi8(m) ) return p + __builtin_ctz(mask);
+         }
+#endif
+#if defined(__SSE2__)
+         const __m128i wquote = _mm_set1_epi8('"'), wbslash = _mm_set1_epi8('\\'), wdel = _mm_set1_epi8(0x7f), wctrl = _mm_set1_epi8(0x1f);
+         for( ; end - p >= 16; p += 16 ) {
+            const __m128i in = _mm_loadu_si128( reinterpret_cast<const __m128i*>(p) );
+            const __m128i m = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8(in, wquote), _mm_cmpeq_epi8(in, wbslash) ),
+                                            _mm_or_si128( _mm_cmpeq_epi8(in, wdel), _mm_cmpeq_epi8(_mm_min_epu8(in, wctrl), in) ) );
+            if( const uint32_t mask = _mm_movemask_epi8(m) ) return p + __builtin_ctz(mask);
+         }
+#endif
+         for( ; p != end; ++p ) {
+            const unsigned char c = *p;
+            if( c < 0x20 || c == '"' || c == '\\' || c == 0x7f ) return p;
+         }
+         return end;
+      }
+
+      /// true if any char in [p,end) has the high bit set, i.e. is not 7-bit ascii
+      inline bool contains_non_ascii( const char* p, const char* end ) {
+#if defined(__AVX2__)
+         for( ; end - p >= 32; p += 32 ) {
+            if( _mm256_movemask_epi8( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(p) ) ) ) return true;
+         }
+#endif
+#if defined(__SSE2__)
+         for( ; end - p >= 16; p += 16 ) {
+            if( _mm_movemask_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>(p) ) ) ) return true;
+         }
+#endif
+         for( ; p != end; ++p ) {
+            if( static_cast<unsigned char>(*p) & 0x80 ) return true;
+         }
+         return false;
+      }
+   }
+
     // forward declarations of provided functions
     template<typename T, json::parse_type parser_type> variant variant_from_stream( T& in, uint32_t max_depth );
     template<typename T> char parseEscape( T& in );
@@ -102,6 +213,12 @@ namespace fc
          in.get();
          while( !in.eof() )
          {
+            if constexpr( std::is_same_v<T, contiguous_istream> ) {
+               // copy everything up to the next char of interest in one step
+               const char* run_end = find_any_of( in.pos(), in.end(), '"', '\\', 0x04 );
+               token.append( in.pos(), run_end );
+               in.skip_to( run_end );
+            }
             switch( c = in.peek() )
             {
                case '\\':
@@ -442,24 +559,31 @@ namespace fc
 	  return variant();
    }
 
+   namespace {
+      template<typename Stream>
+      variant variant_from_string( const std::string& utf8_str, const json::parse_type ptype, const uint32_t max_depth )
+      { try {
+         Stream in(utf8_str.c_str(), utf8_str.size());
+         switch( ptype )
+         {
+             case json::parse_type::legacy_parser:
+                return variant_from_stream<Stream, json::parse_type::legacy_parser>( in, max_depth );
+             case json::parse_type::legacy_parser_with_string_doubles:
+                 return variant_from_stream<Stream, json::parse_type::legacy_parser_with_string_doubles>( in, max_depth );
+             case json::parse_type::strict_parser:
+                 return json_relaxed::variant_from_stream<Stream, true>( in, max_depth );
+             case json::parse_type::relaxed_parser:
+                 return json_relaxed::variant_from_stream<Stream, false>( in, max_depth );
+             default:
+                 FC_ASSERT( false, "Unknown JSON parser type {ptype}", ("ptype", static_cast<int>(ptype)) );
+         }
+      } FC_RETHROW_EXCEPTIONS( warn, "", ("str",utf8_str) ) }
+   }
+
    variant json::from_string( const std::string& utf8_str, const json::parse_type ptype, const uint32_t max_depth )
-   { try {
-      using stream_t = boost::iostreams::stream<boost::iostreams::array_source>;
-      stream_t in(utf8_str.c_str(), utf8_str.size());
-      switch( ptype )
-      {
-          case parse_type::legacy_parser:
-             return variant_from_stream<stream_t, json::parse_type::legacy_parser>( in, max_depth );
-          case parse_type::legacy_parser_with_string_doubles:
-              return variant_from_stream<stream_t, json::parse_type::legacy_parser_with_string_doubles>( in, max_depth );
-          case parse_type::strict_parser:
-              return json_relaxed::variant_from_stream<stream_t, true>( in, max_depth );
-          case parse_type::relaxed_parser:
-              return json_relaxed::variant_from_stream<stream_t, false>( in, max_depth );
-          default:
-              FC_ASSERT( false, "Unknown JSON parser type {ptype}", ("ptype", static_cast<int>(ptype)) );
-      }
-   } FC_RETHROW_EXCEPTIONS( warn, "", ("str",utf8_str) ) }
+   {
+      return variant_from_string<contiguous_istream>( utf8_str, ptype, max_depth );
+   }
 
    /**
     *  Convert '\t', '\r', '\n', '\\' and '"'  to "\t\r\n\\\"" if escape_control_chars == true
@@ -468,16 +592,27 @@ namespace fc
     *  Escapes Control sequence Introducer 0x9b to \u009b
     *  All other characters unmolested.
     */
-   std::string escape_string( const std::string_view& str, const json::yield_function_t& yield, bool escape_control_chars )
+   template<bool scan_runs>
+   std::string escape_string_impl( const std::string_view& str, const json::yield_function_t& yield, bool escape_control_chars )
    {
       string r;
       const auto init_size = str.size();
       r.reserve( init_size + 13 ); // allow for a few escapes
+      const char* const data = str.data();
       size_t i = 0;
-      for( auto itr = str.begin(); itr != str.end(); ++i,++itr )
+      while( i < init_size )
       {
          if( i % json::escape_string_yield_check_count == 0 ) yield( init_size + r.size() );
-         switch( *itr )
+         if constexpr( scan_runs ) {
+            // append the run of chars that need no escaping in one step, stopping at the next yield check
+            const size_t limit = std::min( init_size, (i / json::escape_string_yield_check_count + 1) * json::escape_string_yield_check_count );
+            const char* run_end = find_escape_char( data + i, data + limit );
+            r.append( data + i, run_end );
+            i = run_end - data;
+            if( i == limit ) continue;
+         }
+
+         switch( data[i] )
          {
             case '\x00': r += "\\u0000"; break;
             case '\x01': r += "\\u0001"; break;
@@ -541,13 +676,36 @@ namespace fc
                   break;
                }
             default:
-               r += *itr;
+               r += data[i];
          }
+         ++i;
       }
 
+      if constexpr( scan_runs ) {
+         // pure ascii is always valid utf8
+         if( !contains_non_ascii( r.data(), r.data() + r.size() ) )
+            return r;
+      }
       return is_valid_utf8( r ) ? r : prune_invalid_utf8( r );
    }
 
+   std::string escape_string( const std::string_view& str, const json::yield_function_t& yield, bool escape_control_chars )
+   {
+      return escape_string_impl<true>( str, yield, escape_control_chars );
+   }
+
+   namespace json_baseline {
+      variant from_string( const std::string& utf8_str, const json::parse_type ptype, const uint32_t max_depth )
+      {
+         return variant_from_string<boost::iostreams::stream<boost::iostreams::array_source>>( utf8_str, ptype, max_depth );
+      }
+
+      std::string escape_string( const std::string_view& str, const json::yield_function_t& yield, bool escape_control_chars )
+      {
+         return escape_string_impl<false>( str, yield, escape_control_chars );
+      }
+   }
+
    template<typename T>
    void to_stream( T& os, const variants& a, const json::yield_function_t& yield, const json::output_formatting format )
    {
@@ -655,6 +813,12 @@ namespace fc
       return ss.str();
    }
 
+   void json::to_stream( std::ostream& os, const variant& v, const json::yield_function_t& yield, const json::output_formatting format )
+   {
+      fc::to_stream( os, v, yield, format );
+      yield(os.tellp());
+   }
+
    std::string pretty_print( const std::string& v, const uint8_t indent ) {
       int level = 0;
       std::stringstream ss;
@@ -0,0 +1,236 @@
+#include <fc/log/async_appender.hpp>
+#include <fc/log/logger.hpp>
+#include <fc/log/logger_config.hpp>
+#include <fc/exception/exception.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace fc {
+
+   namespace {
+
+      std::atomic<uint64_t> next_appender_id{1};
+
+      // single producer (the owning thread) / single consumer (the appender thread)
+      struct ring {
+         explicit ring( uint32_t size )
+         :slots(size), mask(size - 1) {}
+
+         std::vector<std::optional<log_message>> slots;
+         const size_t                             mask;
+         alignas(64) std::atomic<size_t>          head{0};
+         alignas(64) std::atomic<size_t>          tail{0};
+         std::atomic<bool>                        producer_exited{false};
+         std::atomic<bool>                        consumer_exited{false};
+
+         bool empty()const { return head.load( std::memory_order_acquire ) == tail.load( std::memory_order_acquire ); }
+      };
+
+      // rings owned by the current thread, one per async_appender it has logged through
+      struct thread_rings {
+         std::vector<std::pair<uint64_t, std::shared_ptr<ring>>> rings;
+
+         ~thread_rings() {
+            for( auto& r : rings )
+               r.second->producer_exited = true;
+         }
+      };
+
+      thread_local thread_rings this_thread_rings;
+
+      uint32_t round_up_pow2( uint32_t v ) {
+         uint32_t r = 1;
+         while( r < v && r < (1u << 31) )
+            r <<= 1;
+         return r;
+      }
+   }
+
+   class async_appender::impl {
+      public:
+         impl( appender::ptr inner, uint32_t ring_size )
+         :inner(std::move(inner)), ring_size(round_up_pow2(std::max<uint32_t>(ring_size, 2))) {}
+
+         ring& this_thread_ring();
+         bool  drain();
+         void  report_dropped();
+         void  deliver( const log_message& m );
+         void  run();
+
+         appender::ptr                       inner;
+         const uint32_t                      ring_size;
+         const uint64_t                      id = next_appender_id++;
+
+         std::mutex                          rings_mtx; // registration of new rings only
+         std::vector<std::shared_ptr<ring>>  rings;
+         std::atomic<uint64_t>               rings_generation{0};
+
+         // consumer thread only
+         std::vector<std::shared_ptr<ring>>  consumer_rings;
+         uint64_t                            consumer_generation = 0;
+         uint64_t                            reported_dropped = 0;
+
+         std::atomic<uint64_t>               dropped{0};
+         std::atomic<bool>                   stopping{false};
+         std::atomic<bool>                   sleeping{false};
+         std::mutex                          wake_mtx;
+         std::condition_variable             wake_cv;
+         std::condition_variable             drained_cv;
+         std::thread                         thread;
+   };
+
+   ring& async_appender::impl::this_thread_ring() {
+      auto& mine = this_thread_rings.rings;
+      for( auto& r : mine ) {
+         if( r.first == id )
+            return *r.second;
+      }
+      // first message from this thread; drop rings left behind by appenders that have since been destroyed
+      mine.erase( std::remove_if( mine.begin(), mine.end(), []( const auto& r ) { return r.second->consumer_exited.load(); } ),
+                  mine.end() );
+
+      auto r = std::make_shared<ring>( ring_size );
+      {
+         std::lock_guard g( rings_mtx );
+         rings.push_back( r );
+         ++rings_generation;
+      }
+      mine.emplace_back( id, r );
+      return *r;
+   }
+
+   void async_appender::impl::deliver( const log_message& m ) {
+      try {
+         inner->log( m );
+      } catch( fc::exception& er ) {
+         std::cerr << "ERROR: async_appender fc::exception: " << er.to_detail_string() << std::endl;
+      } catch( const std::exception& e ) {
+         std::cerr << "ERROR: async_appender std::exception: " << e.what() << std::endl;
+      } catch( ... ) {
+         std::cerr << "ERROR: async_appender unknown exception: " << std::endl;
+      }
+   }
+
+   bool async_appender::impl::drain() {
+      if( consumer_generation != rings_generation.load() ) {
+         std::lock_guard g( rings_mtx );
+         rings.erase( std::remove_if( rings.begin(), rings.end(),
+                                      []( const auto& r ) { return r->producer_exited.load() && r->empty(); } ),
+                      rings.end() );
+         consumer_rings = rings;
+         consumer_generation = rings_generation.load();
+      }
+
+      // bounded batch per ring so one chatty thread cannot starve the others
+      constexpr size_t max_batch = 256;
+      bool consumed = false;
+      bool exited_rings = false;
+      for( auto& r : consumer_rings ) {
+         size_t h = r->head.load( std::memory_order_relaxed );
+         const size_t t = r->tail.load( std::memory_order_acquire );
+         for( size_t n = 0; h != t && n < max_batch; ++n ) {
+            auto& slot = r->slots[h & r->mask];
+            deliver( *slot );
+            slot.reset();
+            r->head.store( ++h, std::memory_order_release );
+            consumed = true;
+         }
+         exited_rings |= r->producer_exited.load( std::memory_order_relaxed );
+      }
+      if( exited_rings )
+         ++rings_generation; // prune on the next pass
+      return consumed;
+   }
+
+   void async_appender::impl::report_dropped() {
+      const uint64_t d = dropped.load( std::memory_order_relaxed );
+      if( d != reported_dropped ) {
+         deliver( FC_LOG_MESSAGE( warn, "async log appender dropped ${n} messages, ${t} in total",
+                                  ("n", d - reported_dropped)("t", d) ) );
+         reported_dropped = d;
+      }
+   }
+
+   void async_appender::impl::run() {
+      set_os_thread_name( "async_log" );
+      while( true ) {
+         const bool stop = stopping.load();
+         const bool consumed = drain();
+         if( !consumed )
+            report_dropped();
+         drained_cv.notify_all();
+         if( !consumed ) {
+            if( stop )
+               break;
+            std::unique_lock g( wake_mtx );
+            sleeping = true;
+            // producers only notify when they see `sleeping`, so a wakeup can be missed; the timeout bounds the latency
+            wake_cv.wait_for( g, std::chrono::milliseconds(5) );
+            sleeping = false;
+         }
+      }
+   }
+
+   async_appender::async_appender( appender::ptr inner, uint32_t ring_size )
+   :my( new impl( std::move(inner), ring_size ) )
+   {
+      my->thread = std::thread( [impl = my.get()]() { impl->run(); } );
+   }
+
+   async_appender::~async_appender() {
+      my->stopping = true;
+      my->wake_cv.notify_one();
+      my->thread.join();
+      std::lock_guard g( my->rings_mtx );
+      for( auto& r : my->rings )
+         r->consumer_exited = true;
+   }
+
+   void async_appender::initialize() {
+      my->inner->initialize();
+   }
+
+   void async_appender::log( const log_message& m ) {
+      ring& r = my->this_thread_ring();
+      const size_t t = r.tail.load( std::memory_order_relaxed );
+      if( t - r.head.load( std::memory_order_acquire ) > r.mask ) {
+         my->dropped.fetch_add( 1, std::memory_order_relaxed );
+         return;
+      }
+      r.slots[t & r.mask].emplace( m );
+      r.tail.store( t + 1, std::memory_order_release );
+      if( my->sleeping.load( std::memory_order_relaxed ) )
+         my->wake_cv.notify_one();
+   }
+
+   void async_appender::flush() {
+      std::vector<std::pair<std::shared_ptr<ring>, size_t>> targets;
+      {
+         std::lock_guard g( my->rings_mtx );
+         for( auto& r : my->rings )
+            targets.emplace_back( r, r->tail.load( std::memory_order_acquire ) );
+      }
+      auto done = [&]() {
+         return std::all_of( targets.begin(), targets.end(), []( const auto& t ) {
+            return t.first->head.load( std::memory_order_acquire ) >= t.second;
+         } );
+      };
+      std::unique_lock g( my->wake_mtx );
+      while( !done() ) {
+         my->wake_cv.notify_one();
+         my->drained_cv.wait_for( g, std::chrono::milliseconds(1) );
+      }
+   }
+
+   uint64_t async_appender::dropped_messages()const {
+      return my->dropped.load( std::memory_order_relaxed );
+   }
+
+} // namespace fc
@@ -7,6 +7,7 @@
 #include <fc/log/console_appender.hpp>
 #include <fc/log/gelf_appender.hpp>
 #include <fc/log/dmlog_appender.hpp>
+#include <fc/log/async_appender.hpp>
 #include <fc/reflect/variant.hpp>
 #include <fc/exception/exception.hpp>
 
@@ -74,6 +75,8 @@ namespace fc {
             continue;
          }
          auto ap = fact_itr->second->create( cfg.appenders[i].args );
+         if( cfg.appenders[i].async )
+            ap = std::make_shared<async_appender>( ap );
          log_config::get().appender_map[cfg.appenders[i].name] = ap;
       }
       for( size_t i = 0; i < cfg.loggers.size(); ++i ) {
@@ -3,8 +3,11 @@
 
 #include <fc/crypto/hex.hpp>
 #include <fc/crypto/sha3.hpp>
+#include <fc/crypto/sha256.hpp>
 #include <fc/utility.hpp>
 
+#include <openssl/sha.h>
+
 using namespace fc;
 
 BOOST_AUTO_TEST_SUITE(hash_functions)
@@ -67,4 +70,69 @@ BOOST_AUTO_TEST_CASE(keccak256) try {
 
 } FC_LOG_AND_RETHROW();
 
+BOOST_AUTO_TEST_CASE(sha256_hash_many) try {
+
+   const std::vector<std::pair<fc::sha256::hash_many_kernel, const char*>> kernels {
+      {fc::sha256::hash_many_kernel::scalar, "scalar"},
+      {fc::sha256::hash_many_kernel::shani,  "sha-ni"},
+      {fc::sha256::hash_many_kernel::avx2,   "avx2"},
+      {fc::sha256::hash_many_kernel::avx512, "avx512"},
+   };
+
+   auto openssl_sha256 = [](const char* data, size_t size) {
+      fc::sha256 h;
+      SHA256(reinterpret_cast<const unsigned char*>(data), size, reinterpret_cast<unsigned char*>(h.data()));
+      return h;
+   };
+
+   // sizes around the padding boundaries, counts around the 8 and 16 lane widths so the tail lanes are partly filled
+   const std::vector<uint32_t> sizes {0, 1, 3, 32, 55, 56, 63, 64, 65, 119, 120, 127, 128, 200};
+   std::vector<size_t> counts {0, 1, 2, 3, 4, 5, 7, 8, 9, 13, 15, 16, 17, 23, 24, 25, 31, 32, 33, 47, 49};
+
+   for(const auto& [kernel, name] : kernels) {
+      if(!fc::sha256::hash_many(kernel, nullptr, 0, 0, nullptr)) {
+         BOOST_TEST_MESSAGE("sha256 hash_many kernel " << name << " not supported here, skipped");
+         continue;
+      }
+      BOOST_TEST_MESSAGE("checking sha256 hash_many kernel " << name);
+      for(uint32_t size : sizes) {
+         for(size_t count : counts) {
+            std::vector<char> data(size * count);
+            for(size_t i = 0; i < data.size(); ++i)
+               data[i] = static_cast<char>(i * 131 + size);
+
+            std::vector<fc::sha256> out(count);
+            BOOST_REQUIRE(fc::sha256::hash_many(kernel, data.data(), size, count, out.data()));
+            for(size_t i = 0; i < count; ++i)
+               BOOST_CHECK_MESSAGE(out[i] == openssl_sha256(data.data() + i * size, size),
+                                   name << " size " << size << " count " << count << " message " << i);
+
+            // output written over the input
+            if(size >= sizeof(fc::sha256)) {
+               BOOST_REQUIRE(fc::sha256::hash_many(kernel, data.data(), size, count,
+                                                   reinterpret_cast<fc::sha256*>(data.data())));
+               for(size_t i = 0; i < count; ++i)
+                  BOOST_CHECK_MESSAGE(reinterpret_cast<const fc::sha256*>(data.data())[i] == out[i],
+                                      name << " in place, size " << size << " count " << count << " message " << i);
+            }
+         }
+      }
+   }
+
+   // the dispatching overload, whichever kernel the cpu selects
+   for(uint32_t size : sizes) {
+      for(size_t count : counts) {
+         std::vector<char> data(size * count);
+         for(size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<char>(i * 131 + size);
+
+         std::vector<fc::sha256> out(count);
+         fc::sha256::hash_many(data.data(), size, count, out.data());
+         for(size_t i = 0; i < count; ++i)
+            BOOST_CHECK(out[i] == openssl_sha256(data.data() + i * size, size));
+      }
+   }
+
+} FC_LOG_AND_RETHROW();
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -2,8 +2,12 @@
 #include <boost/test/included/unit_test.hpp>
 
 #include <fc/io/json.hpp>
+#include <fc/io/json_baseline.hpp>
 #include <fc/exception/exception.hpp>
 
+#include <optional>
+#include <random>
+
 using namespace fc;
 
 BOOST_AUTO_TEST_SUITE(json_test_suite)
@@ -222,4 +226,83 @@ BOOST_AUTO_TEST_CASE(escape_string_test)
    }
 }
 
+BOOST_AUTO_TEST_CASE(escape_string_long_runs_test)
+{
+   // escapes at every offset of strings long enough to use the vectorized scan
+   for( size_t len : {15, 16, 17, 31, 32, 33, 127, 128, 129, 300} ) {
+      for( size_t pos = 0; pos < len; ++pos ) {
+         for( char c : {'"', '\\', '\n', '\x01', '\x1f', '\x7f'} ) {
+            std::string in( len, 'a' );
+            in[pos] = c;
+            std::string escaped = fc::escape_string( in, json_test_util::yield_no_limitation );
+            BOOST_REQUIRE_EQUAL( escaped.substr( 0, pos ), std::string( pos, 'a' ) );
+            BOOST_REQUIRE_EQUAL( escaped.substr( escaped.size() - (len - pos - 1) ), std::string( len - pos - 1, 'a' ) );
+            BOOST_REQUIRE_GT( escaped.size(), len );
+            BOOST_REQUIRE_EQUAL( fc::json::from_string( "\"" + escaped + "\"" ).as_string().size() > 0, true );
+         }
+      }
+   }
+   std::string with_utf8 = std::string( 40, 'a' ) + "\xc3\xa9" + std::string( 40, 'b' );
+   BOOST_CHECK_EQUAL( fc::escape_string( with_utf8, json_test_util::yield_no_limitation ), with_utf8 );
+}
+
+BOOST_AUTO_TEST_CASE(from_string_long_strings_test)
+{
+   std::string s;
+   for( size_t i = 0; i < 1000; ++i )
+      s += std::to_string( i ) + ( i % 7 == 0 ? "\\\"" : "" );
+   std::string json = "{\"k\":\"" + s + "\",\"v\":[\"" + s + "\"]}";
+   auto v = fc::json::from_string( json );
+   std::string expected;
+   for( size_t i = 0; i < 1000; ++i )
+      expected += std::to_string( i ) + ( i % 7 == 0 ? "\"" : "" );
+   BOOST_CHECK_EQUAL( v["k"].as_string(), expected );
+   BOOST_CHECK_EQUAL( v["v"].get_array().at( 0 ).as_string(), expected );
+   BOOST_CHECK_EQUAL( fc::json::to_string( v, fc::time_point::maximum() ), json );
+
+   // unterminated string
+   BOOST_CHECK_THROW( fc::json::from_string( "\"" + std::string( 100, 'a' ) ), fc::parse_error_exception );
+}
+
+BOOST_AUTO_TEST_CASE(matches_baseline_test)
+{
+   std::mt19937 rng( 27 );
+   // biased towards structural characters, escapes and multi-byte utf8 so most inputs reach deep into the parsers
+   const std::string alphabet = "{}[]:,\"\\ \t\nabcdefnrtu0123456789.-+eE\x01\x7f\xc3\xa9\xff";
+   auto random_string = [&]( size_t max_len ) {
+      std::string r( rng() % max_len, ' ' );
+      for( auto& c : r )
+         c = alphabet[rng() % alphabet.size()];
+      return r;
+   };
+   auto parse = []( auto&& from_string, const std::string& in, json::parse_type ptype ) -> std::optional<std::string> {
+      try {
+         return json::to_string( from_string( in, ptype, DEFAULT_MAX_RECURSION_DEPTH ), fc::time_point::maximum() );
+      } catch( const fc::exception& ) {
+         return {};
+      }
+   };
+
+   const std::string valid = "{\"a\":[1,-2.5e3,\"x\\\"y\\u00e9\",true,null,{\"b\":\"" + std::string( 100, 'c' ) + "\"}]}";
+   for( int i = 0; i < 20000; ++i ) {
+      std::string in = i % 2 ? random_string( 200 ) : valid;
+      if( i % 2 == 0 )
+         in[rng() % in.size()] = alphabet[rng() % alphabet.size()];
+      for( auto ptype : {json::parse_type::legacy_parser, json::parse_type::strict_parser, json::parse_type::relaxed_parser,
+                         json::parse_type::legacy_parser_with_string_doubles} ) {
+         const auto expected = parse( json_baseline::from_string, in, ptype );
+         BOOST_REQUIRE( parse( json::from_string, in, ptype ) == expected );
+      }
+
+      const std::string raw = random_string( 400 );
+      for( bool escape_control_chars : {true, false} ) {
+         std::vector<size_t> yields, baseline_yields;
+         const auto escaped = escape_string( raw, [&]( size_t s ) { yields.push_back( s ); }, escape_control_chars );
+         const auto expected = json_baseline::escape_string( raw, [&]( size_t s ) { baseline_yields.push_back( s ); }, escape_control_chars );
+         BOOST_REQUIRE_EQUAL( escaped, expected );
+         BOOST_REQUIRE( yields == baseline_yields );
+      }
+   }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+#define BOOST_TEST_MODULE log
+#include <boost/test/included/unit_test.hpp>
+
+#include <fc/log/async_appender.hpp>
+#include <fc/log/logger.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace fc;
+
+namespace {
+   struct recording_appender : appender {
+      void initialize() override { initialized = true; }
+      void log( const log_message& m ) override {
+         std::lock_guard g( mtx );
+         messages.push_back( m );
+      }
+
+      std::mutex               mtx;
+      std::vector<log_message> messages;
+      bool                     initialized = false;
+   };
+}
+
+BOOST_AUTO_TEST_SUITE(async_appender_test_suite)
+   BOOST_AUTO_TEST_CASE(delivers_in_order_per_thread)
+   {
+      auto rec = std::make_shared<recording_appender>();
+      async_appender app( rec );
+      app.initialize();
+      BOOST_CHECK( rec->initialized );
+
+      constexpr uint64_t per_thread = 1000;
+      std::vector<std::thread> threads;
+      for( uint64_t t = 0; t < 4; ++t ) {
+         threads.emplace_back( [&app, t]() {
+            for( uint64_t i = 0; i < per_thread; ++i ) {
+               app.log( FC_LOG_MESSAGE( info, "msg ${t} ${i}", ("t", t)("i", i) ) );
+               if( i % 64 == 0 )
+                  std::this_thread::yield();
+            }
+         } );
+      }
+      for( auto& t : threads )
+         t.join();
+      app.flush();
+
+      const uint64_t dropped = app.dropped_messages();
+      std::lock_guard g( rec->mtx );
+      std::vector<uint64_t> next( 4, 0 );
+      uint64_t received = 0;
+      for( const auto& m : rec->messages ) {
+         if( m.get_format() != "msg ${t} ${i}" )
+            continue; // drop notice
+         auto t = m.get_data()["t"].as_uint64();
+         auto i = m.get_data()["i"].as_uint64();
+         BOOST_CHECK_GE( i, next[t] );
+         next[t] = i + 1;
+         ++received;
+      }
+      BOOST_CHECK_EQUAL( received + dropped, 4 * per_thread );
+   }
+
+   BOOST_AUTO_TEST_CASE(drops_when_ring_is_full)
+   {
+      struct blocking_appender : recording_appender {
+         void log( const log_message& m ) override {
+            std::unique_lock g( gate_mtx );
+            gate_cv.wait( g, [&]() { return open; } );
+            recording_appender::log( m );
+         }
+         void release() {
+            { std::lock_guard g( gate_mtx ); open = true; }
+            gate_cv.notify_all();
+         }
+         std::mutex              gate_mtx;
+         std::condition_variable gate_cv;
+         bool                    open = false;
+      };
+
+      auto rec = std::make_shared<blocking_appender>();
+      {
+         async_appender app( rec, 8 );
+         // the consumer cannot free a slot while it is blocked in the wrapped appender, so at most 8 are accepted
+         for( int i = 0; i < 100; ++i )
+            app.log( FC_LOG_MESSAGE( info, "msg ${i}", ("i", i) ) );
+         BOOST_CHECK_GE( app.dropped_messages(), 100u - 8u );
+         rec->release();
+         app.flush();
+         const auto delivered = std::count_if( rec->messages.begin(), rec->messages.end(), []( const auto& m ) {
+            return m.get_format() == "msg ${i}";
+         } );
+         BOOST_CHECK_EQUAL( delivered + app.dropped_messages(), 100u );
+      }
+      // destruction reports the drops through the wrapped appender
+      BOOST_REQUIRE( !rec->messages.empty() );
+      BOOST_CHECK( rec->messages.back().get_message().find( "dropped" ) != std::string::npos );
+   }
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,7 @@
 #include <eosio/chain/exceptions.hpp>
 #include <eosio/http_plugin/macros.hpp>
 #include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
 
 namespace eosio {
 
@@ -104,6 +105,38 @@ parse_params<chain_apis::read_only::get_transaction_id_params, http_params_types
           } \
        }}
 
+// Bodies of the application/octet-stream variants of the read endpoints. Responses are fc::raw packed and
+// skip the ABI-to-JSON conversion entirely.
+namespace {
+   std::vector<char> get_block_binary( chain_apis::read_only& ro_api, chain_apis::read_only::get_raw_block_params&& params, const fc::time_point& deadline ) {
+      chain::signed_block_ptr block = ro_api.get_raw_block( params, deadline );
+      return fc::raw::pack( *block );
+   }
+
+   std::vector<char> get_table_rows_binary( chain_apis::read_only& ro_api, chain_apis::read_only::get_table_rows_params&& params, const fc::time_point& deadline ) {
+      return fc::raw::pack( ro_api.get_table_rows_raw( params, deadline ) );
+   }
+
+   std::vector<char> get_account_binary( chain_apis::read_only& ro_api, chain_apis::read_only::get_account_params&& params, const fc::time_point& deadline ) {
+      return fc::raw::pack( ro_api.get_account( params, deadline, false ) );
+   }
+}
+
+#define CALL_BINARY_WITH_400(api_name, api_handle, api_namespace, call_name, params_name, http_response_code, params_type) \
+{std::string("/v1/" #api_name "/" #call_name), \
+   [api_handle](string&&, string&& body, url_response_callback&& cb) mutable { \
+          auto deadline = api_handle.start(); \
+          try { \
+             auto params = parse_params<api_namespace::params_name, params_type>(body);\
+             FC_CHECK_DEADLINE(deadline);\
+             cb(http_response_code, deadline, fc::variant( fc::blob{ call_name ## _binary( api_handle, std::move(params), deadline ) } )); \
+          } catch (...) { \
+             http_plugin::handle_exception(#api_name, #call_name, body, cb); \
+          } \
+       }}
+
+#define CHAIN_RO_BINARY_CALL(call_name, params_name, http_response_code, params_type) CALL_BINARY_WITH_400(chain, ro_api, chain_apis::read_only, call_name, params_name, http_response_code, params_type)
+
 #define CHAIN_RO_CALL(call_name, http_response_code, params_type) CALL_WITH_400(chain, ro_api, chain_apis::read_only, call_name, http_response_code, params_type)
 #define CHAIN_RW_CALL(call_name, http_response_code, params_type) CALL_WITH_400(chain, rw_api, chain_apis::read_write, call_name, http_response_code, params_type)
 #define CHAIN_RO_CALL_ASYNC(call_name, call_result, http_response_code, params_type) CALL_ASYNC_WITH_400(chain, ro_api, chain_apis::read_only, call_name, call_result, http_response_code, params_type)
@@ -193,11 +226,14 @@ void chain_api_plugin::plugin_startup() {
               auto post_time = fc::time_point::now();
               auto remaining_time = max_time - (post_time - start);
               _http_plugin.post_http_thread_pool(
-                    [ro_api, cb, deadline, post_time, remaining_time, abi_cache{std::move(abi_cache)}, block{std::move( block )}]() mutable {
+                    [ro_api, &_http_plugin, cb, deadline, post_time, remaining_time, abi_cache{std::move(abi_cache)}, block{std::move( block )}]() mutable {
                  try {
                     auto new_deadline = deadline + (fc::time_point::now() - post_time);
 
-                    fc::variant result = ro_api.convert_block( block, std::move(abi_cache), remaining_time );
+                    fc::variant result = ro_api.convert_block( block, std::move(abi_cache), remaining_time,
+                                                               [&_http_plugin]( std::function<void()> f ) {
+                                                                  _http_plugin.post_http_thread_pool( std::move( f ) );
+                                                               } );
 
                     cb( 200, new_deadline, std::move( result ) );
                  } catch( ... ) {
@@ -210,6 +246,16 @@ void chain_api_plugin::plugin_startup() {
         }
       }
    }, appbase::exec_queue::read_only);
+
+   // served instead of the handlers above for requests with Accept: application/octet-stream
+   _http_plugin.add_api({
+      CHAIN_RO_BINARY_CALL(get_table_rows, get_table_rows_params, 200, http_params_types::params_required),
+      CHAIN_RO_BINARY_CALL(get_account, get_account_params, 200, http_params_types::params_required)
+   }, appbase::exec_queue::read_only, appbase::priority::medium_low, http_content_type::octet_stream);
+
+   _http_plugin.add_async_api({
+      CHAIN_RO_BINARY_CALL(get_block, get_raw_block_params, 200, http_params_types::params_required)
+   }, http_content_type::octet_stream);
 }
 
 void chain_api_plugin::plugin_shutdown() {}
@@ -3,6 +3,7 @@
 #include <fc/time.hpp>
 
 #include <functional>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -22,6 +23,7 @@ namespace eosio::chain::plugin_interface {
       std::string family;
       std::string label;
       int64_t value = 0;
+      std::map<std::string, std::string> labels; ///< prometheus labels, to tell apart metrics of the same family
    };
 
    using metrics_listener = std::function<void(std::vector<runtime_metric>)>;
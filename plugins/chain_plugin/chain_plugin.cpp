@@ -30,6 +30,8 @@
 #include <fc/io/json.hpp>
 #include <fc/variant.hpp>
 #include <cstdlib>
+#include <condition_variable>
+#include <mutex>
 
 // reflect chainbase::environment for --print-build-info option
 FC_REFLECT_ENUM( chainbase::environment::os_t,
@@ -275,6 +277,9 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
           "print contract's output to console")
          ("deep-mind", bpo::bool_switch()->default_value(false),
           "print deeper information about chain operations")
+         ("deep-mind-binary-output", bpo::value<string>(),
+          "When deep-mind is enabled, write length-prefixed binary records instead of DMLOG text lines to this file or FIFO path, "
+          "or to a listening unix domain socket given as unix:<path>")
          ("actor-whitelist", boost::program_options::value<vector<string>>()->composing()->multitoken(),
           "Account added to actor whitelist (may specify multiple times)")
          ("actor-blacklist", boost::program_options::value<vector<string>>()->composing()->multitoken(),
@@ -346,23 +351,30 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
           "Duration (in seconds) a successful transaction's Finality Status will remain available from being first identified.")
          ("transaction-finality-status-failure-duration-sec", bpo::value<uint64_t>()->default_value(config::default_max_transaction_finality_status_failure_duration_sec),
           "Duration (in seconds) a failed transaction's Finality Status will remain available from being first identified.")
+         ("transaction-finality-status-index-dir", bpo::value<bfs::path>(),
+          "If set, the location (absolute path or relative to application data dir) of a persistent index of the transactions in irreversible\n"
+          "blocks, which get_transaction_status uses once a transaction's Finality Status is no longer held in memory. The index is split in\n"
+          "files of blocks-log-stride blocks (1000000 if not set) and keeps max-retained-block-files completed files (all if not set).\n"
+          "Requires transaction-finality-status-max-storage-size-gb.")
          ("integrity-hash-on-start", bpo::bool_switch(), "Log the state integrity hash on startup")
-         ("integrity-hash-on-stop", bpo::bool_switch(), "Log the state integrity hash on shutdown");
+         ("integrity-hash-on-stop", bpo::bool_switch(), "Log the state integrity hash on shutdown")
+         ("batch-resource-usage", bpo::bool_switch(),
+          "Accumulate account CPU/NET usage in memory for the duration of a block and write it to the chain state once per block "
+          "instead of once per transaction. Limits and resulting state are unchanged. Not compatible with deep-mind.")
+         ("state-commitment", bpo::bool_switch(),
+          "Maintain a commitment to the chain state incrementally as blocks are applied, so it can be queried every block "
+          "without walking the whole database. Persisted across restarts in the state directory.")
+         ("table-cold-after-blocks", bpo::value<uint32_t>()->default_value(0),
+          "Track when contract tables are accessed and report tables not accessed for this many blocks as cold, "
+          "along with the resident and non-resident bytes of the chain state. Only reported, rows of cold tables stay in the "
+          "chain state database. 0 disables tracking.")
+         ("profile-contracts", bpo::value<bool>()->default_value(true),
+          "Aggregate the time spent executing WASM per contract and action across all transactions, "
+          "reported by the producer API get_contract_profile and the contract_cpu_us and contract_calls metrics.");
 
     cfg.add_options()("block-log-retain-blocks", bpo::value<uint32_t>(), "If set to greater than 0, periodically prune the block log to store only configured number of most recent blocks.\n"
         "If set to 0, no blocks are be written to the block log; block log file is removed after startup.");
 
-
-// TODO: rate limiting
-         /*("per-authorized-account-transaction-msg-rate-limit-time-frame-sec", bpo::value<uint32_t>()->default_value(default_per_auth_account_time_frame_seconds),
-          "The time frame, in seconds, that the per-authorized-account-transaction-msg-rate-limit is imposed over.")
-         ("per-authorized-account-transaction-msg-rate-limit", bpo::value<uint32_t>()->default_value(default_per_auth_account),
-          "Limits the maximum rate of transaction messages that an account is allowed each per-authorized-account-transaction-msg-rate-limit-time-frame-sec.")
-          ("per-code-account-transaction-msg-rate-limit-time-frame-sec", bpo::value<uint32_t>()->default_value(default_per_code_account_time_frame_seconds),
-           "The time frame, in seconds, that the per-code-account-transaction-msg-rate-limit is imposed over.")
-          ("per-code-account-transaction-msg-rate-limit", bpo::value<uint32_t>()->default_value(default_per_code_account),
-           "Limits the maximum rate of transaction messages that an account's code is allowed each per-code-account-transaction-msg-rate-limit-time-frame-sec.")*/
-
    cli.add_options()
          ("genesis-json", bpo::value<bfs::path>(), "File to read Genesis State from")
          ("genesis-timestamp", bpo::value<string>(), "override the initial timestamp in the Genesis State file")
@@ -605,10 +617,23 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
          if (max_storage_size > 0) {
             const fc::microseconds success_duration = fc::seconds(options.at( "transaction-finality-status-success-duration-sec" ).as<uint64_t>());
             const fc::microseconds failure_duration = fc::seconds(options.at( "transaction-finality-status-failure-duration-sec" ).as<uint64_t>());
+            chain_apis::trx_id_index_ptr trx_index;
+            if( options.count( "transaction-finality-status-index-dir" )) {
+               auto index_dir = options.at( "transaction-finality-status-index-dir" ).as<bfs::path>();
+               if( index_dir.is_relative() )
+                  index_dir = app().data_dir() / index_dir;
+               const uint32_t stride = options.count( "blocks-log-stride" ) ? options.at( "blocks-log-stride" ).as<uint32_t>()
+                                                                            : chain_apis::trx_id_index::default_stride;
+               const uint32_t max_retained_files = options.count( "max-retained-block-files" ) ? options.at( "max-retained-block-files" ).as<uint32_t>()
+                                                                                               : UINT32_MAX;
+               trx_index = std::make_unique<chain_apis::trx_id_index>( index_dir, stride, max_retained_files );
+            }
             my->_trx_finality_status_processing.reset(
-               new chain_apis::trx_finality_status_processing(max_storage_size, success_duration, failure_duration));
+               new chain_apis::trx_finality_status_processing(max_storage_size, success_duration, failure_duration, std::move(trx_index)));
          }
       }
+      EOS_ASSERT( !options.count( "transaction-finality-status-index-dir" ) || my->_trx_finality_status_processing, plugin_config_exception,
+                  "transaction-finality-status-index-dir requires transaction-finality-status-max-storage-size-gb" );
 
       if( options.count( "chain-threads" )) {
          my->chain_config->thread_pool_size = options.at( "chain-threads" ).as<uint16_t>();
@@ -914,6 +939,10 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
 
       my->chain_config->integrity_hash_on_start = options.at("integrity-hash-on-start").as<bool>();
       my->chain_config->integrity_hash_on_stop = options.at("integrity-hash-on-stop").as<bool>();
+      my->chain_config->batch_resource_usage = options.at("batch-resource-usage").as<bool>();
+      my->chain_config->maintain_state_commitment = options.at("state-commitment").as<bool>();
+      my->chain_config->table_cold_after_blocks = options.at("table-cold-after-blocks").as<uint32_t>();
+      my->chain_config->profile_contracts = options.at("profile-contracts").as<bool>();
 
       my->chain.emplace( *my->chain_config, std::move(pfs), *chain_id );
 
@@ -970,6 +999,13 @@ void chain_plugin::plugin_initialize(const variables_map& options) {
          EOS_ASSERT( options.at("p2p-accept-transactions").as<bool>() == false, plugin_config_exception,
             "p2p-accept-transactions must be set to false in order to enable deep-mind logging.");
 
+         EOS_ASSERT( options.at("batch-resource-usage").as<bool>() == false, plugin_config_exception,
+            "batch-resource-usage must be set to false in order to enable deep-mind logging.");
+
+         if( options.count( "deep-mind-binary-output" ) ) {
+            _deep_mind_log.update_binary_output( options.at( "deep-mind-binary-output" ).as<string>() );
+         }
+
          my->chain->enable_deep_mind( &_deep_mind_log );
       }
 
@@ -1141,6 +1177,7 @@ void chain_plugin::plugin_shutdown() {
    if(app().is_quiting())
       my->chain->get_wasm_interface().indicate_shutting_down();
    my->chain.reset();
+   _deep_mind_log.flush();
 }
 
 void chain_plugin::handle_sighup() {
@@ -1291,16 +1328,42 @@ read_only::get_transaction_status(const read_only::get_transaction_status_params
 
    trx_finality_status_processing::chain_state ch_state = trx_finality_status_proc->get_chain_state();
 
-   const auto trx_st = trx_finality_status_proc->get_trx_state(param.id);
+   auto trx_st = trx_finality_status_proc->get_trx_state(param.id);
+   const auto* trx_index = trx_finality_status_proc->get_trx_id_index();
+   auto block_id_for_num = [&](uint32_t block_num) {
+      try {
+         return db.get_block_id_for_num(block_num);
+      } catch( const fc::exception& ) {
+         // block log may not contain the block anymore
+         return chain::block_id_type{};
+      }
+   };
+   std::optional<uint32_t> indexed_block_num;
+   if (!trx_st && trx_index) {
+      if (const auto e = trx_index->find(param.id)) {
+         indexed_block_num = e->block_num;
+         trx_st = trx_finality_status_processing::trx_state{
+            .block_id = block_id_for_num(e->block_num),
+            .block_timestamp = e->block_timestamp.to_time_point(),
+            .expiration = fc::time_point(e->expiration),
+            .status = e->status == chain::transaction_receipt_header::executed ? "IRREVERSIBLE" : "FAILED" };
+      }
+   }
+   if (trx_index && trx_index->first_block_num() != 0 &&
+       (ch_state.earliest_tracked_block_id == chain::block_id_type{} ||
+        trx_index->first_block_num() < chain::block_header::num_from_id(ch_state.earliest_tracked_block_id))) {
+      if (const auto id = block_id_for_num(trx_index->first_block_num()); id != chain::block_id_type{})
+         ch_state.earliest_tracked_block_id = id;
+   }
    // check if block_id is set to a valid value, since trx_finality_status_proc does not use optionals for the block data
    const auto trx_block_valid = trx_st && trx_st->block_id != chain::block_id_type{};
 
    return {
       trx_st ? trx_st->status : "UNKNOWN",
-      trx_block_valid ? std::optional<uint32_t>(chain::block_header::num_from_id(trx_st->block_id)) : std::optional<uint32_t>{},
+      trx_block_valid ? std::optional<uint32_t>(chain::block_header::num_from_id(trx_st->block_id)) : indexed_block_num,
       trx_block_valid ? std::optional<chain::block_id_type>(trx_st->block_id) : std::optional<chain::block_id_type>{},
-      trx_block_valid ? std::optional<fc::time_point>(trx_st->block_timestamp) : std::optional<fc::time_point>{},
-      trx_st ? std::optional<fc::time_point_sec>(trx_st->expiration) : std::optional<fc::time_point_sec>{},
+      trx_block_valid || indexed_block_num ? std::optional<fc::time_point>(trx_st->block_timestamp) : std::optional<fc::time_point>{},
+      trx_st && trx_st->expiration != fc::time_point{} ? std::optional<fc::time_point_sec>(trx_st->expiration) : std::optional<fc::time_point_sec>{},
       chain::block_header::num_from_id(ch_state.head_id),
       ch_state.head_id,
       ch_state.head_block_timestamp,
@@ -1531,7 +1594,8 @@ string get_table_type( const abi_def& abi, const name& table_name ) {
    EOS_ASSERT( false, chain::contract_table_query_exception, "Table ${table} is not specified in the ABI", ("table",table_name) );
 }
 
-read_only::get_table_rows_result read_only::get_table_rows( const read_only::get_table_rows_params& p, const fc::time_point& deadline )const {
+template<typename Result>
+Result read_only::get_table_rows_impl( const read_only::get_table_rows_params& p, const fc::time_point& deadline )const {
    abi_def abi = eosio::chain_apis::get_abi( db, p.code );
    bool primary = false;
    auto table_with_index = get_table_index_name( p, primary );
@@ -1539,32 +1603,32 @@ read_only::get_table_rows_result read_only::get_table_rows( const read_only::get
       EOS_ASSERT( p.table == table_with_index, chain::contract_table_query_exception, "Invalid table name ${t}", ( "t", p.table ));
       auto table_type = get_table_type( abi, p.table );
       if( table_type == KEYi64 || p.key_type == "i64" || p.key_type == "name" ) {
-         return get_table_rows_ex<key_value_index>(p,std::move(abi),deadline);
+         return get_table_rows_ex<key_value_index, Result>(p,std::move(abi),deadline);
       }
       EOS_ASSERT( false, chain::contract_table_query_exception,  "Invalid table type ${type}", ("type",table_type)("abi",abi));
    } else {
       EOS_ASSERT( !p.key_type.empty(), chain::contract_table_query_exception, "key type required for non-primary index" );
 
       if (p.key_type == chain_apis::i64 || p.key_type == "name") {
-         return get_table_rows_by_seckey<index64_index, uint64_t>(p, std::move(abi), deadline, [](uint64_t v)->uint64_t {
+         return get_table_rows_by_seckey<index64_index, uint64_t, Result>(p, std::move(abi), deadline, [](uint64_t v)->uint64_t {
             return v;
          });
       }
       else if (p.key_type == chain_apis::i128) {
-         return get_table_rows_by_seckey<index128_index, uint128_t>(p, std::move(abi), deadline, [](uint128_t v)->uint128_t {
+         return get_table_rows_by_seckey<index128_index, uint128_t, Result>(p, std::move(abi), deadline, [](uint128_t v)->uint128_t {
             return v;
          });
       }
       else if (p.key_type == chain_apis::i256) {
          if ( p.encode_type == chain_apis::hex) {
             using  conv = keytype_converter<chain_apis::sha256,chain_apis::hex>;
-            return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, std::move(abi), deadline, conv::function());
+            return get_table_rows_by_seckey<conv::index_type, conv::input_type, Result>(p, std::move(abi), deadline, conv::function());
          }
          using  conv = keytype_converter<chain_apis::i256>;
-         return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, std::move(abi), deadline, conv::function());
+         return get_table_rows_by_seckey<conv::index_type, conv::input_type, Result>(p, std::move(abi), deadline, conv::function());
       }
       else if (p.key_type == chain_apis::float64) {
-         return get_table_rows_by_seckey<index_double_index, double>(p, std::move(abi), deadline, [](double v)->float64_t {
+         return get_table_rows_by_seckey<index_double_index, double, Result>(p, std::move(abi), deadline, [](double v)->float64_t {
             float64_t f;
             double_to_float64(v, f);
             return f;
@@ -1572,13 +1636,13 @@ read_only::get_table_rows_result read_only::get_table_rows( const read_only::get
       }
       else if (p.key_type == chain_apis::float128) {
          if ( p.encode_type == chain_apis::hex) {
-            return get_table_rows_by_seckey<index_long_double_index, uint128_t>(p, std::move(abi), deadline, [](uint128_t v)->float128_t{
+            return get_table_rows_by_seckey<index_long_double_index, uint128_t, Result>(p, std::move(abi), deadline, [](uint128_t v)->float128_t{
                float128_t f;
                uint128_to_float128(v, f);
                return f;
             });
          }
-         return get_table_rows_by_seckey<index_long_double_index, double>(p, std::move(abi), deadline, [](double v)->float128_t{
+         return get_table_rows_by_seckey<index_long_double_index, double, Result>(p, std::move(abi), deadline, [](double v)->float128_t{
             float64_t f;
             double_to_float64(v, f);
             float128_t f128;
@@ -1588,16 +1652,26 @@ read_only::get_table_rows_result read_only::get_table_rows( const read_only::get
       }
       else if (p.key_type == chain_apis::sha256) {
          using  conv = keytype_converter<chain_apis::sha256,chain_apis::hex>;
-         return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, std::move(abi), deadline, conv::function());
+         return get_table_rows_by_seckey<conv::index_type, conv::input_type, Result>(p, std::move(abi), deadline, conv::function());
       }
       else if(p.key_type == chain_apis::ripemd160) {
          using  conv = keytype_converter<chain_apis::ripemd160,chain_apis::hex>;
-         return get_table_rows_by_seckey<conv::index_type, conv::input_type>(p, std::move(abi), deadline, conv::function());
+         return get_table_rows_by_seckey<conv::index_type, conv::input_type, Result>(p, std::move(abi), deadline, conv::function());
       }
       EOS_ASSERT(false, chain::contract_table_query_exception,  "Unsupported secondary index type: ${t}", ("t", p.key_type));
    }
 }
 
+read_only::get_table_rows_result read_only::get_table_rows( const read_only::get_table_rows_params& p, const fc::time_point& deadline )const {
+   return get_table_rows_impl<get_table_rows_result>( p, deadline );
+}
+
+read_only::get_table_rows_raw_result read_only::get_table_rows_raw( const read_only::get_table_rows_params& p, const fc::time_point& deadline )const {
+   auto params = p;
+   params.json = false;
+   return get_table_rows_impl<get_table_rows_raw_result>( params, deadline );
+}
+
 read_only::get_table_by_scope_result read_only::get_table_by_scope( const read_only::get_table_by_scope_params& p,
                                                                     const fc::time_point& deadline )const {
 
@@ -1993,25 +2067,99 @@ read_only::get_block_serializers( const chain::signed_block_ptr& block, const fc
    return abi_cache;
 }
 
+namespace {
+   // blocks are split into at most this many chunks of at least min_chunk_transactions each
+   constexpr size_t max_convert_block_tasks      = 16;
+   constexpr size_t min_chunk_transactions       = 8;
+
+   /**
+    * Decodes the transaction receipts of a block in chunks. The calling thread works through the chunks together
+    * with helper tasks handed to post; a helper that starts after all chunks have been claimed does nothing, so the
+    * result never depends on a helper being scheduled and post may use the thread pool the caller runs on.
+    */
+   template<typename Resolver>
+   fc::variants transactions_to_variant( const std::vector<transaction_receipt>& receipts, Resolver resolver,
+                                         const abi_serializer::yield_function_t& yield,
+                                         const std::function<void(std::function<void()>)>& post ) {
+      const size_t chunk_size = std::max( min_chunk_transactions,
+                                          (receipts.size() + max_convert_block_tasks - 1) / max_convert_block_tasks );
+      const size_t num_chunks = (receipts.size() + chunk_size - 1) / chunk_size;
+
+      struct progress {
+         std::atomic<size_t>     next_chunk{0};
+         std::mutex              mtx;
+         std::condition_variable cv;
+         size_t                  done = 0;
+         std::exception_ptr      error;
+      };
+      auto prog = std::make_shared<progress>();
+      fc::variants result( receipts.size() );
+
+      // receipts, result and resolver are only touched for a claimed chunk, which the caller waits for
+      auto work = [prog, num_chunks, chunk_size, &receipts, &result, resolver, yield]() {
+         for( size_t c = prog->next_chunk++; c < num_chunks; c = prog->next_chunk++ ) {
+            std::exception_ptr error;
+            try {
+               const size_t end = std::min( receipts.size(), (c + 1) * chunk_size );
+               for( size_t i = c * chunk_size; i < end; ++i )
+                  abi_serializer::to_variant( receipts[i], result[i], resolver, yield );
+            } catch( ... ) {
+               error = std::current_exception();
+            }
+            std::lock_guard g( prog->mtx );
+            if( error && !prog->error )
+               prog->error = error;
+            if( ++prog->done == num_chunks )
+               prog->cv.notify_all();
+         }
+      };
+
+      for( size_t i = 1; i < num_chunks; ++i ) {
+         post( work );
+      }
+      work();
+
+      std::unique_lock g( prog->mtx );
+      prog->cv.wait( g, [&]() { return prog->done == num_chunks; } );
+      if( prog->error )
+         std::rethrow_exception( prog->error );
+      return result;
+   }
+} // anonymous namespace
+
 fc::variant read_only::convert_block( const chain::signed_block_ptr& block,
                                       std::unordered_map<account_name, std::optional<abi_serializer>> abi_cache,
-                                      const fc::microseconds& max_time ) const {
+                                      const fc::microseconds& max_time,
+                                      const std::function<void(std::function<void()>)>& post ) const {
 
-   auto abi_serializer_resolver = [&abi_cache](const account_name& account) -> std::optional<abi_serializer> {
+   // abi_cache is only read from here on, every action refers to its serializer instead of copying it
+   auto abi_serializer_resolver = [&abi_cache](const account_name& account) -> const abi_serializer* {
       auto it = abi_cache.find( account );
-      if( it != abi_cache.end() )
-         return it->second;
-      return {};
+      if( it != abi_cache.end() && it->second )
+         return &*it->second;
+      return nullptr;
    };
+   // a single deadline for the whole block, however many threads decode it
+   const auto yield = abi_serializer::create_yield_function( max_time );
 
    fc::variant pretty_output;
-   abi_serializer::to_variant( *block, pretty_output, abi_serializer_resolver,
-                               abi_serializer::create_yield_function( max_time ) );
+   std::optional<fc::variants> transactions;
+   if( post && block->transactions.size() > min_chunk_transactions ) {
+      transactions = transactions_to_variant( block->transactions, abi_serializer_resolver, yield, post );
+      signed_block header( static_cast<const signed_block_header&>( *block ) );
+      header.block_extensions = block->block_extensions;
+      abi_serializer::to_variant( header, pretty_output, abi_serializer_resolver, yield );
+   } else {
+      abi_serializer::to_variant( *block, pretty_output, abi_serializer_resolver, yield );
+   }
 
    const auto block_id = block->calculate_id();
    uint32_t ref_block_prefix = block_id._hash[1];
 
-   return fc::mutable_variant_object( pretty_output.get_object() )
+   fc::mutable_variant_object result( pretty_output.get_object() );
+   if( transactions )
+      result( "transactions", std::move( *transactions ) ); // replaces the empty list of the header, keeping its position
+   return result
          ( "id", block_id )
          ( "block_num", block->block_num() )
          ( "ref_block_prefix", ref_block_prefix );
@@ -2367,7 +2515,7 @@ read_only::get_raw_abi_results read_only::get_raw_abi( const get_raw_abi_params&
    return result;
 }
 
-read_only::get_account_results read_only::get_account( const get_account_params& params, const fc::time_point& deadline )const {
+read_only::get_account_results read_only::get_account( const get_account_params& params, const fc::time_point& deadline, bool decode_system_rows )const {
    get_account_results result;
    result.account_name = params.account_name;
 
@@ -2455,7 +2603,14 @@ read_only::get_account_results read_only::get_account( const get_account_params&
    const auto& code_account = db.db().get<account_object,by_name>( config::system_account_name );
 
    if( abi_def abi; abi_serializer::to_abi(code_account.abi, abi) ) {
-      abi_serializer abis( std::move(abi), abi_serializer::create_yield_function( abi_serializer_max_time ) );
+      std::optional<abi_serializer> abis;
+      auto row_to_variant = [&]( const char* type, vector<char>&& data ) {
+         if( !decode_system_rows )
+            return fc::variant( fc::blob{ std::move(data) } );
+         if( !abis )
+            abis.emplace( std::move(abi), abi_serializer::create_yield_function( abi_serializer_max_time ) );
+         return abis->binary_to_variant( type, data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
+      };
 
       const auto token_code = "eosio.token"_n;
 
@@ -2486,7 +2641,7 @@ read_only::get_account_results read_only::get_account( const get_account_params&
          if ( it != idx.end() ) {
             vector<char> data;
             copy_inline_row(*it, data);
-            result.total_resources = abis.binary_to_variant( "user_resources", data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
+            result.total_resources = row_to_variant( "user_resources", std::move(data) );
          }
       }
 
@@ -2497,7 +2652,7 @@ read_only::get_account_results read_only::get_account( const get_account_params&
          if ( it != idx.end() ) {
             vector<char> data;
             copy_inline_row(*it, data);
-            result.self_delegated_bandwidth = abis.binary_to_variant( "delegated_bandwidth", data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
+            result.self_delegated_bandwidth = row_to_variant( "delegated_bandwidth", std::move(data) );
          }
       }
 
@@ -2508,7 +2663,7 @@ read_only::get_account_results read_only::get_account( const get_account_params&
          if ( it != idx.end() ) {
             vector<char> data;
             copy_inline_row(*it, data);
-            result.refund_request = abis.binary_to_variant( "refund_request", data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
+            result.refund_request = row_to_variant( "refund_request", std::move(data) );
          }
       }
 
@@ -2519,7 +2674,7 @@ read_only::get_account_results read_only::get_account( const get_account_params&
          if ( it != idx.end() ) {
             vector<char> data;
             copy_inline_row(*it, data);
-            result.voter_info = abis.binary_to_variant( "voter_info", data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
+            result.voter_info = row_to_variant( "voter_info", std::move(data) );
          }
       }
 
@@ -2530,7 +2685,7 @@ read_only::get_account_results read_only::get_account( const get_account_params&
          if( it != idx.end() ) {
             vector<char> data;
             copy_inline_row(*it, data);
-            result.rex_info = abis.binary_to_variant( "rex_balance", data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
+            result.rex_info = row_to_variant( "rex_balance", std::move(data) );
          }
       }
    }
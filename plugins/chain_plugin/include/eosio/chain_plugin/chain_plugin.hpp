@@ -246,7 +246,8 @@ public:
       name                  account_name;
       std::optional<symbol> expected_core_symbol;
    };
-   get_account_results get_account( const get_account_params& params, const fc::time_point& deadline )const;
+   /// @param decode_system_rows when false, the eosio system table rows (total_resources, ...) are returned as packed blobs without ABI decoding
+   get_account_results get_account( const get_account_params& params, const fc::time_point& deadline, bool decode_system_rows = true )const;
 
 
    struct get_code_results {
@@ -333,10 +334,12 @@ public:
    // call from app() thread
    std::unordered_map<account_name, std::optional<abi_serializer>>
      get_block_serializers( const chain::signed_block_ptr& block, const fc::microseconds& max_time ) const;
-   // call from any thread
+   // call from any thread; when post is given, the transactions of larger blocks are decoded concurrently
+   // by the calling thread and tasks handed to post, max_time applies to the block as a whole
    fc::variant convert_block( const chain::signed_block_ptr& block,
                               std::unordered_map<account_name, std::optional<abi_serializer>> abi_cache,
-                              const fc::microseconds& max_time ) const;
+                              const fc::microseconds& max_time,
+                              const std::function<void(std::function<void()>)>& post = {} ) const;
 
    struct get_block_header_params {
       string block_num_or_id;
@@ -388,6 +391,20 @@ public:
 
    get_table_rows_result get_table_rows( const get_table_rows_params& params, const fc::time_point& deadline )const;
 
+   /// get_table_rows_result as returned to application/octet-stream requests, rows are the packed table data
+   struct get_table_rows_raw_row {
+      bytes               data;
+      name                payer; ///< empty unless show_payer was requested
+   };
+   struct get_table_rows_raw_result {
+      vector<get_table_rows_raw_row> rows;
+      bool                           more = false;
+      string                         next_key;
+   };
+
+   /// get_table_rows, with rows copied from the table as they are stored; params.json is ignored
+   get_table_rows_raw_result get_table_rows_raw( const get_table_rows_params& params, const fc::time_point& deadline )const;
+
    struct get_table_by_scope_params {
       name                 code; // mandatory
       name                 table; // optional, act as filter
@@ -518,22 +535,48 @@ public:
 
    static uint64_t get_table_index_name(const read_only::get_table_rows_params& p, bool& primary);
 
-   template <typename IndexType, typename SecKeyType, typename ConvFn>
-   read_only::get_table_rows_result get_table_rows_by_seckey( const read_only::get_table_rows_params& p,
-                                                              abi_def&& abi,
-                                                              const fc::time_point& deadline,
-                                                              ConvFn conv )const {
+   template<typename Result>
+   Result get_table_rows_impl( const get_table_rows_params& p, const fc::time_point& deadline )const;
+
+   // abis is only set when p.json
+   void add_table_row( get_table_rows_result& result, const get_table_rows_params& p, const abi_serializer& abis,
+                       vector<char>& data, name payer )const {
+      fc::variant data_var;
+      if( p.json ) {
+         data_var = abis.binary_to_variant( abis.get_table_type(p.table), data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
+      } else {
+         data_var = fc::variant( data );
+      }
+
+      if( p.show_payer && *p.show_payer ) {
+         result.rows.emplace_back( fc::mutable_variant_object("data", std::move(data_var))("payer", payer) );
+      } else {
+         result.rows.emplace_back( std::move(data_var) );
+      }
+   }
+
+   void add_table_row( get_table_rows_raw_result& result, const get_table_rows_params& p, const abi_serializer&,
+                       vector<char>& data, name payer )const {
+      result.rows.push_back( { std::move(data), p.show_payer && *p.show_payer ? payer : name() } );
+   }
+
+   template <typename IndexType, typename SecKeyType, typename Result = read_only::get_table_rows_result, typename ConvFn>
+   Result get_table_rows_by_seckey( const read_only::get_table_rows_params& p,
+                                    abi_def&& abi,
+                                    const fc::time_point& deadline,
+                                    ConvFn conv )const {
 
       fc::microseconds params_time_limit = p.time_limit_ms ? fc::milliseconds(*p.time_limit_ms) : fc::milliseconds(10);
       fc::time_point params_deadline = fc::time_point::now() + params_time_limit;
 
-      read_only::get_table_rows_result result;
+      Result result;
       const auto& d = db.db();
 
       name scope{ convert_to_type<uint64_t>(p.scope, "scope") };
 
       abi_serializer abis;
-      abis.set_abi(std::move(abi), abi_serializer::create_yield_function( abi_serializer_max_time ) );
+      if( p.json )
+         abis.set_abi(std::move(abi), abi_serializer::create_yield_function( abi_serializer_max_time ) );
       bool primary = false;
       const uint64_t table_with_index = get_table_index_name(p, primary);
       const auto* t_id = d.find<chain::table_id_object, chain::by_code_scope_table>(boost::make_tuple(p.code, scope, p.table));
@@ -589,19 +632,7 @@ public:
                const auto* itr2 = d.find<chain::key_value_object, chain::by_scope_primary>( boost::make_tuple(t_id->id, itr->primary_key) );
                if( itr2 == nullptr ) continue;
                copy_inline_row(*itr2, data);
-
-               fc::variant data_var;
-               if( p.json ) {
-                  data_var = abis.binary_to_variant( abis.get_table_type(p.table), data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
-               } else {
-                  data_var = fc::variant( data );
-               }
-
-               if( p.show_payer && *p.show_payer ) {
-                  result.rows.emplace_back( fc::mutable_variant_object("data", std::move(data_var))("payer", itr->payer) );
-               } else {
-                  result.rows.emplace_back( std::move(data_var) );
-               }
+               add_table_row( result, p, abis, data, itr->payer );
 
                ++count;
             }
@@ -622,21 +653,22 @@ public:
       return result;
    }
 
-   template <typename IndexType>
-   read_only::get_table_rows_result get_table_rows_ex( const read_only::get_table_rows_params& p,
-                                                       abi_def&& abi,
-                                                       const fc::time_point& deadline )const {
+   template <typename IndexType, typename Result = read_only::get_table_rows_result>
+   Result get_table_rows_ex( const read_only::get_table_rows_params& p,
+                             abi_def&& abi,
+                             const fc::time_point& deadline )const {
 
       fc::microseconds params_time_limit = p.time_limit_ms ? fc::milliseconds(*p.time_limit_ms) : fc::milliseconds(10);
       fc::time_point params_deadline = fc::time_point::now() + params_time_limit;
 
-      read_only::get_table_rows_result result;
+      Result result;
       const auto& d = db.db();
 
       uint64_t scope = convert_to_type<uint64_t>(p.scope, "scope");
 
       abi_serializer abis;
-      abis.set_abi(std::move(abi), abi_serializer::create_yield_function( abi_serializer_max_time ));
+      if( p.json )
+         abis.set_abi(std::move(abi), abi_serializer::create_yield_function( abi_serializer_max_time ));
       const auto* t_id = d.find<chain::table_id_object, chain::by_code_scope_table>(boost::make_tuple(p.code, name(scope), p.table));
       if( t_id != nullptr ) {
          const auto& idx = d.get_index<IndexType, chain::by_scope_primary>();
@@ -672,19 +704,7 @@ public:
             for( unsigned int count = 0; cur_time <= params_deadline && count < p.limit && itr != end_itr; ++count, ++itr, cur_time = fc::time_point::now() ) {
                FC_CHECK_DEADLINE(deadline);
                copy_inline_row(*itr, data);
-
-               fc::variant data_var;
-               if( p.json ) {
-                  data_var = abis.binary_to_variant( abis.get_table_type(p.table), data, abi_serializer::create_yield_function( abi_serializer_max_time ), shorten_abi_errors );
-               } else {
-                  data_var = fc::variant( data );
-               }
-
-               if( p.show_payer && *p.show_payer ) {
-                  result.rows.emplace_back( fc::mutable_variant_object("data", std::move(data_var))("payer", itr->payer) );
-               } else {
-                  result.rows.emplace_back( std::move(data_var) );
-               }
+               add_table_row( result, p, abis, data, itr->payer );
             }
             if( itr != end_itr ) {
                result.more = true;
@@ -921,6 +941,8 @@ FC_REFLECT( eosio::chain_apis::read_write::send_transaction2_params, (return_fai
 
 FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_params, (json)(code)(scope)(table)(table_key)(lower_bound)(upper_bound)(limit)(key_type)(index_position)(encode_type)(reverse)(show_payer)(time_limit_ms) )
 FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_result, (rows)(more)(next_key) );
+FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_raw_row, (data)(payer) );
+FC_REFLECT( eosio::chain_apis::read_only::get_table_rows_raw_result, (rows)(more)(next_key) );
 
 FC_REFLECT( eosio::chain_apis::read_only::get_table_by_scope_params, (code)(table)(lower_bound)(upper_bound)(limit)(reverse)(time_limit_ms) )
 FC_REFLECT( eosio::chain_apis::read_only::get_table_by_scope_result_row, (code)(scope)(table)(payer)(count));
@@ -2,6 +2,7 @@
 #include <eosio/chain/types.hpp>
 #include <eosio/chain/block_state.hpp>
 #include <eosio/chain/trace.hpp>
+#include <eosio/chain_plugin/trx_id_index.hpp>
 
 #include <fc/container/tracked_storage.hpp>
 #include <memory>
@@ -35,8 +36,10 @@ namespace eosio::chain_apis {
       /**
        * Instantiate a new transaction retry processor
        * @param max_storage - the maximum storage allotted to this feature
+       * @param trx_index - optional persistent index that irreversible blocks are added to
        */
-      trx_finality_status_processing( uint64_t max_storage, const fc::microseconds& success_duration, const fc::microseconds& failure_duration );
+      trx_finality_status_processing( uint64_t max_storage, const fc::microseconds& success_duration, const fc::microseconds& failure_duration,
+                                      trx_id_index_ptr trx_index = {} );
 
       ~trx_finality_status_processing();
 
@@ -54,6 +57,9 @@ namespace eosio::chain_apis {
 
       size_t get_storage_memory_size() const;
 
+      /// nullptr unless a persistent transaction id index was provided
+      const trx_id_index* get_trx_id_index() const;
+
    private:
       trx_finality_status_processing_impl_ptr _my;
    };
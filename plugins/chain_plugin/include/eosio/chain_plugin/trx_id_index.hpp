@@ -0,0 +1,60 @@
+#pragma once
+#include <eosio/chain/block.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <memory>
+#include <optional>
+
+namespace eosio::chain_apis {
+
+   struct trx_id_index_impl;
+
+   /**
+    * Persistent index of transaction id -> (block number, receipt status) for irreversible blocks, so transaction
+    * status can be answered long after trx_finality_status_processing has dropped it from memory.
+    *
+    * Blocks are grouped into partitions of `stride` blocks, one file each. A file is a header followed by a power of
+    * two number of fixed width slots holding the first 16 bytes of a transaction id, addressed by open addressing
+    * with linear probing, and is memory mapped so a lookup touches one or two pages per partition. The partition
+    * being filled is doubled when half full; files of completed partitions are never modified. When more than
+    * max_retained_files completed partitions exist the oldest file is deleted, so configured like the block log the
+    * index covers the same blocks as the retained block log files.
+    */
+   class trx_id_index {
+   public:
+      static constexpr uint32_t default_stride = 1'000'000;
+
+      struct entry {
+         uint32_t                                        block_num = 0;
+         chain::block_timestamp_type                     block_timestamp;
+         fc::time_point_sec                              expiration; ///< zero for receipts of deferred transactions
+         chain::transaction_receipt_header::status_enum  status = chain::transaction_receipt_header::executed;
+      };
+
+      /**
+       * Opens or creates the index in dir
+       * @param stride - number of blocks per partition file
+       * @param max_retained_files - number of completed partition files to keep
+       */
+      trx_id_index( const fc::path& dir, uint32_t stride, uint32_t max_retained_files );
+
+      ~trx_id_index();
+
+      /// index the receipts of an irreversible block, blocks not after last_block_num() are ignored
+      void add_block( const chain::signed_block& block );
+
+      std::optional<entry> find( const chain::transaction_id_type& id ) const;
+
+      /// the range of indexed blocks, both 0 when empty; blocks missed while the index was not running are not indexed
+      uint32_t first_block_num() const;
+      uint32_t last_block_num() const;
+
+      size_t num_partitions() const;
+
+   private:
+      std::unique_ptr<trx_id_index_impl> _my;
+   };
+
+   using trx_id_index_ptr = std::unique_ptr<trx_id_index>;
+} // namespace eosio::chain_apis
@@ -0,0 +1,169 @@
+#define BOOST_TEST_MODULE trx_id_index
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/chain_plugin/trx_id_index.hpp>
+
+#include <eosio/chain/block.hpp>
+#include <eosio/chain/config.hpp>
+
+#include <fc/bitutil.hpp>
+#include <fc/filesystem.hpp>
+
+namespace {
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::chain::literals;
+using namespace eosio::chain_apis;
+
+chain::block_id_type make_block_id( uint32_t block_num ) {
+   chain::block_id_type block_id;
+   block_id._hash[0] &= 0xffffffff00000000;
+   block_id._hash[0] += fc::endian_reverse_u32(block_num);
+   return block_id;
+}
+
+packed_transaction make_unique_trx() {
+   static uint32_t unique_id = 0;
+   signed_transaction trx;
+   trx.expiration = fc::time_point_sec( 1'700'000'000 );
+   trx.ref_block_prefix = ++unique_id;
+   trx.actions.emplace_back( vector<permission_level>{{config::system_account_name, config::active_name}},
+                             config::system_account_name, "nonce"_n, fc::raw::pack( unique_id ) );
+   return packed_transaction( std::move(trx), packed_transaction::compression_type::none );
+}
+
+/// block with num_trxs executed transactions and, if deferred_id is given, a hard failed deferred transaction
+signed_block make_block( uint32_t block_num, size_t num_trxs, std::optional<transaction_id_type> deferred_id = {} ) {
+   signed_block b;
+   b.previous = make_block_id( block_num - 1 );
+   b.timestamp = block_timestamp_type( block_num );
+   for( size_t i = 0; i < num_trxs; ++i ) {
+      auto& r = b.transactions.emplace_back( make_unique_trx() );
+      r.status = transaction_receipt_header::executed;
+   }
+   if( deferred_id ) {
+      auto& r = b.transactions.emplace_back( *deferred_id );
+      r.status = transaction_receipt_header::hard_fail;
+   }
+   return b;
+}
+
+transaction_id_type id_of( const transaction_receipt& r ) {
+   return std::get<packed_transaction>( r.trx ).id();
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(trx_id_index_test)
+
+BOOST_AUTO_TEST_CASE(trx_id_index_lookup) { try {
+   fc::temp_directory tempdir;
+   trx_id_index index( tempdir.path(), trx_id_index::default_stride, UINT32_MAX );
+   BOOST_CHECK_EQUAL( index.first_block_num(), 0u );
+   BOOST_CHECK_EQUAL( index.last_block_num(), 0u );
+
+   const auto deferred_id = transaction_id_type::hash( std::string( "deferred" ) );
+   std::vector<signed_block> blocks;
+   for( uint32_t n = 2; n <= 6; ++n ) {
+      blocks.push_back( make_block( n, 3, n == 4 ? deferred_id : std::optional<transaction_id_type>{} ) );
+      index.add_block( blocks.back() );
+   }
+   BOOST_CHECK_EQUAL( index.first_block_num(), 2u );
+   BOOST_CHECK_EQUAL( index.last_block_num(), 6u );
+   BOOST_CHECK_EQUAL( index.num_partitions(), 1u );
+
+   for( const auto& b : blocks ) {
+      for( const auto& r : b.transactions ) {
+         if( !std::holds_alternative<packed_transaction>( r.trx ) )
+            continue;
+         const auto e = index.find( id_of( r ) );
+         BOOST_REQUIRE( e );
+         BOOST_CHECK_EQUAL( e->block_num, b.block_num() );
+         BOOST_CHECK( e->block_timestamp == b.timestamp );
+         BOOST_CHECK( e->expiration == fc::time_point_sec( 1'700'000'000 ) );
+         BOOST_CHECK( e->status == transaction_receipt_header::executed );
+      }
+   }
+
+   const auto deferred = index.find( deferred_id );
+   BOOST_REQUIRE( deferred );
+   BOOST_CHECK_EQUAL( deferred->block_num, 4u );
+   BOOST_CHECK( deferred->status == transaction_receipt_header::hard_fail );
+   BOOST_CHECK( deferred->expiration == fc::time_point_sec() );
+
+   BOOST_CHECK( !index.find( transaction_id_type::hash( std::string( "unknown" ) ) ) );
+
+   // blocks already indexed are ignored
+   auto replayed = make_block( 5, 2 );
+   index.add_block( replayed );
+   BOOST_CHECK( !index.find( id_of( replayed.transactions.front() ) ) );
+   BOOST_CHECK_EQUAL( index.last_block_num(), 6u );
+
+   // a partition grows past its initial size
+   auto big = make_block( 7, 5000 );
+   index.add_block( big );
+   for( const auto& r : big.transactions ) {
+      const auto e = index.find( id_of( r ) );
+      BOOST_REQUIRE( e );
+      BOOST_CHECK_EQUAL( e->block_num, 7u );
+   }
+   BOOST_CHECK( index.find( id_of( blocks.front().transactions.front() ) ) );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE(trx_id_index_partitions) { try {
+   fc::temp_directory tempdir;
+   const uint32_t stride = 10;
+   const uint32_t max_retained_files = 2;
+   std::vector<signed_block> blocks;
+   {
+      trx_id_index index( tempdir.path(), stride, max_retained_files );
+      for( uint32_t n = 2; n <= 45; ++n ) {
+         blocks.push_back( make_block( n, 2 ) );
+         index.add_block( blocks.back() );
+      }
+      // 41-45 being filled, 21-30 and 31-40 retained
+      BOOST_CHECK_EQUAL( index.num_partitions(), 3u );
+      BOOST_CHECK_EQUAL( index.first_block_num(), 21u );
+      BOOST_CHECK_EQUAL( index.last_block_num(), 45u );
+   }
+
+   auto check = [&]( const trx_id_index& index ) {
+      for( const auto& b : blocks ) {
+         for( const auto& r : b.transactions ) {
+            const auto e = index.find( id_of( r ) );
+            if( b.block_num() < 21 ) {
+               BOOST_CHECK( !e );
+            } else {
+               BOOST_REQUIRE( e );
+               BOOST_CHECK_EQUAL( e->block_num, b.block_num() );
+            }
+         }
+      }
+   };
+
+   // reopened index continues where it left off
+   trx_id_index index( tempdir.path(), stride, max_retained_files );
+   BOOST_CHECK_EQUAL( index.num_partitions(), 3u );
+   BOOST_CHECK_EQUAL( index.first_block_num(), 21u );
+   BOOST_CHECK_EQUAL( index.last_block_num(), 45u );
+   check( index );
+
+   for( uint32_t n = 46; n <= 52; ++n ) {
+      blocks.push_back( make_block( n, 2 ) );
+      index.add_block( blocks.back() );
+   }
+   BOOST_CHECK_EQUAL( index.num_partitions(), 3u );
+   BOOST_CHECK_EQUAL( index.first_block_num(), 31u );
+   BOOST_CHECK( !index.find( id_of( blocks[25].transactions.front() ) ) ); // block 27
+   BOOST_CHECK( index.find( id_of( blocks[35].transactions.front() ) ) );  // block 37
+   BOOST_CHECK( index.find( id_of( blocks.back().transactions.front() ) ) );
+
+   // missed blocks leave a gap
+   auto later = make_block( 60, 1 );
+   index.add_block( later );
+   BOOST_CHECK_EQUAL( index.last_block_num(), 60u );
+   BOOST_CHECK( index.find( id_of( later.transactions.front() ) ) );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
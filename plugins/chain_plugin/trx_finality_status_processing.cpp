@@ -8,10 +8,12 @@ using namespace eosio::finality_status;
 namespace eosio::chain_apis {
 
    struct trx_finality_status_processing_impl {
-      trx_finality_status_processing_impl( uint64_t max_storage, const fc::microseconds& success_duration, const fc::microseconds& failure_duration )
+      trx_finality_status_processing_impl( uint64_t max_storage, const fc::microseconds& success_duration, const fc::microseconds& failure_duration,
+                                           trx_id_index_ptr trx_index )
       : _max_storage(max_storage),
         _success_duration(success_duration),
-        _failure_duration(failure_duration) {}
+        _failure_duration(failure_duration),
+        _trx_id_index(std::move(trx_index)) {}
 
       void signal_applied_transaction( const chain::transaction_trace_ptr& trace, const chain::packed_transaction_ptr& ptrx );
 
@@ -38,10 +40,12 @@ namespace eosio::chain_apis {
       const fc::microseconds                           _success_duration;
       const fc::microseconds                           _failure_duration;
       std::deque<chain::transaction_id_type>           _speculative_trxs;
+      trx_id_index_ptr                                 _trx_id_index;
    };
 
-   trx_finality_status_processing::trx_finality_status_processing( uint64_t max_storage, const fc::microseconds& success_duration, const fc::microseconds& failure_duration )
-   : _my(new trx_finality_status_processing_impl(max_storage, success_duration, failure_duration))
+   trx_finality_status_processing::trx_finality_status_processing( uint64_t max_storage, const fc::microseconds& success_duration, const fc::microseconds& failure_duration,
+                                                                   trx_id_index_ptr trx_index )
+   : _my(new trx_finality_status_processing_impl(max_storage, success_duration, failure_duration, std::move(trx_index)))
    {
    }
 
@@ -51,6 +55,9 @@ namespace eosio::chain_apis {
       try {
          _my->_irr_block_id = bsp->id;
          _my->_irr_block_timestamp = bsp->block->timestamp;
+         if (_my->_trx_id_index) {
+            _my->_trx_id_index->add_block(*bsp->block);
+         }
       } FC_LOG_AND_DROP(("Failed to signal irreversible block for finality status"));
    }
 
@@ -334,6 +341,10 @@ namespace eosio::chain_apis {
       return _my->_storage.memory_size();
    }
 
+   const trx_id_index* trx_finality_status_processing::get_trx_id_index() const {
+      return _my->_trx_id_index.get();
+   }
+
    void trx_finality_status_processing_impl::determine_earliest_tracked_block_id() {
       const auto& indx = _storage.index().get<by_status_expiry>();
 
@@ -0,0 +1,313 @@
+#include <eosio/chain_plugin/trx_id_index.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <fc/log/logger.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <vector>
+
+namespace bfs = boost::filesystem;
+namespace bip = boost::interprocess;
+
+namespace eosio::chain_apis {
+
+   namespace {
+      constexpr uint64_t index_magic     = 0x3130584449585254; // "TRXIDX01"
+      constexpr uint32_t index_version   = 1;
+      constexpr uint64_t min_num_buckets = 1024;
+      const std::string  file_prefix     = "trx-index-";
+      const std::string  file_suffix     = ".idx";
+
+      struct index_header {
+         uint64_t magic           = index_magic;
+         uint32_t version         = index_version;
+         uint32_t partition_start = 0; // first block of the partition
+         uint32_t first_block_num = 0; // first block indexed, 0 if none
+         uint32_t last_block_num  = 0; // last block indexed, 0 if none
+         uint64_t num_buckets     = 0; // power of two
+         uint64_t size            = 0;
+         uint64_t reserved[3]     = {};
+      };
+      static_assert( sizeof(index_header) == 64 );
+
+      struct index_slot {
+         uint64_t key[2];          // first 16 bytes of the transaction id
+         uint32_t block_num;       // 0 marks an empty slot
+         uint32_t block_timestamp; // block_timestamp_type slot
+         uint32_t expiration;      // seconds since epoch
+         uint8_t  status;
+         uint8_t  reserved[3];
+      };
+      static_assert( sizeof(index_slot) == 32 );
+
+      uint64_t next_pow2( uint64_t v ) {
+         uint64_t r = min_num_buckets;
+         while( r < v ) r <<= 1;
+         return r;
+      }
+
+      bfs::path partition_path( const bfs::path& dir, uint32_t partition_start ) {
+         return dir / ( file_prefix + std::to_string( partition_start ) + file_suffix );
+      }
+
+      /// a memory mapped partition file
+      class partition {
+      public:
+         partition( const bfs::path& path, bip::mode_t mode )
+         : _path( path )
+         , _file( path.generic_string().c_str(), mode )
+         , _region( _file, mode ) {
+            FC_ASSERT( _region.get_size() >= sizeof(index_header), "Transaction id index file ${f} is truncated", ("f", _path.generic_string()) );
+            FC_ASSERT( header().magic == index_magic && header().version == index_version,
+                       "Transaction id index file ${f} has an unknown format", ("f", _path.generic_string()) );
+            FC_ASSERT( _region.get_size() == sizeof(index_header) + header().num_buckets * sizeof(index_slot) &&
+                       header().num_buckets && !( header().num_buckets & ( header().num_buckets - 1 ) ),
+                       "Transaction id index file ${f} is corrupt", ("f", _path.generic_string()) );
+         }
+
+         static void create( const bfs::path& path, uint32_t partition_start, uint64_t num_buckets ) {
+            index_header h;
+            h.partition_start = partition_start;
+            h.num_buckets = num_buckets;
+            {
+               std::ofstream out( path.generic_string(), std::ios::binary | std::ios::trunc );
+               out.write( reinterpret_cast<const char*>( &h ), sizeof(h) );
+               FC_ASSERT( out.good(), "Unable to create transaction id index file ${f}", ("f", path.generic_string()) );
+            }
+            // slots are all zero, i.e. empty; the file is sparse until they are filled
+            bfs::resize_file( path, sizeof(index_header) + num_buckets * sizeof(index_slot) );
+         }
+
+         const bfs::path&    path() const   { return _path; }
+         index_header&       header()       { return *static_cast<index_header*>( _region.get_address() ); }
+         const index_header& header() const { return *static_cast<const index_header*>( _region.get_address() ); }
+
+         const index_slot* find( const uint64_t (&key)[2] ) const {
+            const auto* s = slots();
+            const uint64_t mask = header().num_buckets - 1;
+            for( uint64_t i = key[0] & mask;; i = ( i + 1 ) & mask ) {
+               if( s[i].block_num == 0 )
+                  return nullptr;
+               if( s[i].key[0] == key[0] && s[i].key[1] == key[1] )
+                  return &s[i];
+            }
+         }
+
+         /// caller ensures there is a free slot; an existing slot for the same id is overwritten
+         void insert( const index_slot& n ) {
+            auto* s = const_cast<index_slot*>( slots() );
+            const uint64_t mask = header().num_buckets - 1;
+            for( uint64_t i = n.key[0] & mask;; i = ( i + 1 ) & mask ) {
+               if( s[i].block_num == 0 ) {
+                  s[i] = n;
+                  ++header().size;
+                  return;
+               }
+               if( s[i].key[0] == n.key[0] && s[i].key[1] == n.key[1] ) {
+                  s[i] = n;
+                  return;
+               }
+            }
+         }
+
+         template<typename F>
+         void for_each( F&& f ) const {
+            const auto* s = slots();
+            for( uint64_t i = 0; i < header().num_buckets; ++i ) {
+               if( s[i].block_num != 0 )
+                  f( s[i] );
+            }
+         }
+
+         void flush() { _region.flush(); }
+
+      private:
+         const index_slot* slots() const {
+            return reinterpret_cast<const index_slot*>( static_cast<const char*>( _region.get_address() ) + sizeof(index_header) );
+         }
+
+         bfs::path          _path;
+         bip::file_mapping  _file;
+         bip::mapped_region _region;
+      };
+
+      using partition_ptr = std::unique_ptr<partition>;
+   } // namespace
+
+   struct trx_id_index_impl {
+      trx_id_index_impl( const bfs::path& dir, uint32_t stride, uint32_t max_retained_files );
+
+      void start_partition( uint32_t partition_start );
+      void reserve( uint64_t size );
+      void remove_old_partitions();
+
+      const bfs::path            _dir;
+      const uint32_t             _stride;
+      const uint32_t             _max_retained_files;
+      /// oldest first, the last one is the partition being filled
+      std::deque<partition_ptr>  _partitions;
+   };
+
+   trx_id_index_impl::trx_id_index_impl( const bfs::path& dir, uint32_t stride, uint32_t max_retained_files )
+   : _dir( dir )
+   , _stride( stride )
+   , _max_retained_files( max_retained_files ) {
+      FC_ASSERT( _stride > 0, "Transaction id index stride must be greater than 0" );
+      if( !bfs::exists( _dir ) )
+         bfs::create_directories( _dir );
+
+      std::vector<std::pair<uint32_t, bfs::path>> files;
+      for( const auto& e : bfs::directory_iterator( _dir ) ) {
+         const auto name = e.path().filename().string();
+         if( name.size() <= file_prefix.size() + file_suffix.size() || name.compare( 0, file_prefix.size(), file_prefix ) != 0 ||
+             name.compare( name.size() - file_suffix.size(), file_suffix.size(), file_suffix ) != 0 )
+            continue;
+         const auto num = name.substr( file_prefix.size(), name.size() - file_prefix.size() - file_suffix.size() );
+         if( num.find_first_not_of( "0123456789" ) != std::string::npos )
+            continue;
+         files.emplace_back( std::stoul( num ), e.path() );
+      }
+      std::sort( files.begin(), files.end() );
+
+      for( size_t i = 0; i < files.size(); ++i ) {
+         const bool last = i + 1 == files.size();
+         _partitions.emplace_back( std::make_unique<partition>( files[i].second, last ? bip::read_write : bip::read_only ) );
+      }
+      remove_old_partitions();
+
+      if( !_partitions.empty() ) {
+         ilog( "Transaction id index in ${d} covers blocks ${f} to ${l} in ${n} files",
+               ("d", _dir.generic_string())("f", _partitions.front()->header().first_block_num)
+               ("l", _partitions.back()->header().last_block_num)("n", _partitions.size()) );
+      }
+   }
+
+   void trx_id_index_impl::start_partition( uint32_t partition_start ) {
+      // size the new partition like the previous one so that it rarely needs to grow
+      uint64_t num_buckets = min_num_buckets;
+      if( !_partitions.empty() ) {
+         auto& prev = *_partitions.back();
+         num_buckets = next_pow2( prev.header().size * 2 );
+         prev.flush();
+         const auto prev_path = prev.path();
+         _partitions.back() = std::make_unique<partition>( prev_path, bip::read_only );
+      }
+      const auto path = partition_path( _dir, partition_start );
+      partition::create( path, partition_start, num_buckets );
+      _partitions.emplace_back( std::make_unique<partition>( path, bip::read_write ) );
+      remove_old_partitions();
+   }
+
+   void trx_id_index_impl::reserve( uint64_t size ) {
+      auto& cur = *_partitions.back();
+      // keep the load factor at most 1/2
+      if( size * 2 <= cur.header().num_buckets )
+         return;
+
+      const auto path = cur.path();
+      const auto tmp_path = bfs::path( path ).concat( ".tmp" );
+      partition::create( tmp_path, cur.header().partition_start, next_pow2( size * 2 ) );
+      auto grown = std::make_unique<partition>( tmp_path, bip::read_write );
+      cur.for_each( [&]( const index_slot& s ) { grown->insert( s ); } );
+      grown->header().first_block_num = cur.header().first_block_num;
+      grown->header().last_block_num = cur.header().last_block_num;
+      grown->flush();
+
+      _partitions.back().reset();
+      bfs::rename( tmp_path, path );
+      _partitions.back() = std::make_unique<partition>( path, bip::read_write );
+   }
+
+   void trx_id_index_impl::remove_old_partitions() {
+      // the partition being filled does not count against max_retained_files, as with the block log
+      while( _partitions.size() > 1 && _partitions.size() - 1 > _max_retained_files ) {
+         const auto path = _partitions.front()->path();
+         _partitions.pop_front();
+         bfs::remove( path );
+         ilog( "Removed transaction id index file ${f}", ("f", path.generic_string()) );
+      }
+   }
+
+   trx_id_index::trx_id_index( const fc::path& dir, uint32_t stride, uint32_t max_retained_files )
+   : _my( new trx_id_index_impl( bfs::path( dir.generic_string() ), stride, max_retained_files ) )
+   {
+   }
+
+   trx_id_index::~trx_id_index() = default;
+
+   void trx_id_index::add_block( const chain::signed_block& block ) {
+      const uint32_t block_num = block.block_num();
+      const uint32_t last = last_block_num();
+      if( block_num <= last )
+         return;
+      if( last != 0 && block_num != last + 1 )
+         wlog( "Transaction id index does not contain blocks ${f} to ${l}", ("f", last + 1)("l", block_num - 1) );
+
+      const uint32_t partition_start = static_cast<uint32_t>( ( block_num - 1ull ) / _my->_stride * _my->_stride + 1 );
+      // a partition may start before the one being filled if the stride was increased, keep filling it then
+      if( _my->_partitions.empty() || partition_start > _my->_partitions.back()->header().partition_start )
+         _my->start_partition( partition_start );
+
+      _my->reserve( _my->_partitions.back()->header().size + block.transactions.size() );
+      auto& cur = *_my->_partitions.back();
+
+      for( const auto& r : block.transactions ) {
+         index_slot s{};
+         chain::transaction_id_type id;
+         if( std::holds_alternative<chain::packed_transaction>( r.trx ) ) {
+            const auto& pt = std::get<chain::packed_transaction>( r.trx );
+            id = pt.id();
+            s.expiration = pt.get_transaction().expiration.sec_since_epoch();
+         } else {
+            id = std::get<chain::transaction_id_type>( r.trx );
+         }
+         std::memcpy( s.key, id.data(), sizeof(s.key) );
+         s.block_num = block_num;
+         s.block_timestamp = block.timestamp.slot;
+         s.status = r.status;
+         cur.insert( s );
+      }
+
+      // only once all receipts are in, so a block partially indexed before a crash is indexed again
+      if( cur.header().first_block_num == 0 )
+         cur.header().first_block_num = block_num;
+      cur.header().last_block_num = block_num;
+   }
+
+   std::optional<trx_id_index::entry> trx_id_index::find( const chain::transaction_id_type& id ) const {
+      uint64_t key[2];
+      std::memcpy( key, id.data(), sizeof(key) );
+      // most lookups are for recent transactions
+      for( auto itr = _my->_partitions.rbegin(); itr != _my->_partitions.rend(); ++itr ) {
+         if( const auto* s = ( *itr )->find( key ) ) {
+            return entry{ .block_num       = s->block_num,
+                          .block_timestamp = chain::block_timestamp_type( s->block_timestamp ),
+                          .expiration      = fc::time_point_sec( s->expiration ),
+                          .status          = static_cast<chain::transaction_receipt_header::status_enum>( s->status ) };
+         }
+      }
+      return {};
+   }
+
+   uint32_t trx_id_index::first_block_num() const {
+      for( const auto& p : _my->_partitions ) {
+         if( p->header().first_block_num != 0 )
+            return p->header().first_block_num;
+      }
+      return 0;
+   }
+
+   uint32_t trx_id_index::last_block_num() const {
+      return _my->_partitions.empty() ? 0 : _my->_partitions.back()->header().last_block_num;
+   }
+
+   size_t trx_id_index::num_partitions() const {
+      return _my->_partitions.size();
+   }
+}
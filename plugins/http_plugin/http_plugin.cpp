@@ -91,7 +91,7 @@ namespace eosio {
                // post to the app thread taking shared ownership of next (via std::shared_ptr),
                // sole ownership of the tracked body and the passed in parameters
                // we can't std::move() next_ptr because we post a new lambda for each http request and we need to keep the original
-               app().executor().post( priority, to_queue, [next_ptr, conn=std::move(conn), r=std::move(r), b = std::move(b), wrapped_then=std::move(wrapped_then)]() mutable {
+               auto run = [next_ptr, conn, r=std::move(r), b = std::move(b), wrapped_then=std::move(wrapped_then)]() mutable {
                   try {
                      if( app().is_quiting() ) return; // http_plugin shutting down, do not call callback
                      // call the `next` url_handler and wrap the response handler
@@ -99,7 +99,19 @@ namespace eosio {
                   } catch( ... ) {
                      conn->handle_exception();
                   }
-               } );
+               };
+               if( !my->plugin_state->max_queue_time ) {
+                  app().executor().post( priority, to_queue, std::move(run) );
+               } else {
+                  // requests still queued after max_queue_time are answered busy instead of occupying the app thread
+                  auto deadline = std::chrono::steady_clock::now() + *my->plugin_state->max_queue_time;
+                  app().executor().post( priority, to_queue, deadline, std::move(run), [my, conn=std::move(conn)]() {
+                     if( app().is_quiting() ) return;
+                     boost::asio::post( my->plugin_state->thread_pool.get_executor(), [conn]() {
+                        conn->send_busy_response("Request expired while queued for execution");
+                     } );
+                  } );
+               }
             };
             return handler;
          }
@@ -201,6 +213,8 @@ namespace eosio {
              "Maximum number of requests http_plugin should use for processing http requests. 429 error response when exceeded." )
             ("http-max-response-time-ms", bpo::value<int64_t>()->default_value(30),
              "Maximum time for processing a request, -1 for unlimited")
+            ("http-max-queue-time-ms", bpo::value<int64_t>()->default_value(-1),
+             "Maximum time a request may wait for the app thread or read-only threads before a 429 error response is sent instead of processing it, -1 for unlimited")
             ("verbose-http-errors", bpo::bool_switch()->default_value(false),
              "Append the error log to HTTP responses")
             ("http-validate-host", boost::program_options::value<bool>()->default_value(true),
@@ -211,6 +225,9 @@ namespace eosio {
              "Number of worker threads in http thread pool")
             ("http-keep-alive", bpo::value<bool>()->default_value(true),
              "If set to false, do not keep HTTP connections alive, even if client requests.")
+            ("http-chunked-response-threshold-kb", bpo::value<uint32_t>()->default_value(0),
+             "JSON responses estimated larger than this many kilobytes are streamed to the client using chunked transfer-encoding "
+             "as they are generated instead of being fully materialized first. 0 to disable.")
             ;
    }
 
@@ -239,6 +256,11 @@ namespace eosio {
          // set to one year for -1, unlimited, since this is added to fc::time_point::now() for a deadline
          my->plugin_state->max_response_time = max_reponse_time_ms == -1 ?
                fc::days(365) : fc::microseconds( max_reponse_time_ms * 1000 );
+         int64_t max_queue_time_ms = options.at("http-max-queue-time-ms").as<int64_t>();
+         EOS_ASSERT( max_queue_time_ms == -1 || max_queue_time_ms >= 0, chain::plugin_config_exception,
+                     "http-max-queue-time-ms must be -1, or non-negative: ${m}", ("m", max_queue_time_ms) );
+         if( max_queue_time_ms >= 0 )
+            my->plugin_state->max_queue_time = std::chrono::milliseconds( max_queue_time_ms );
 
          my->plugin_state->validate_host = options.at("http-validate-host").as<bool>();
          if( options.count( "http-alias" )) {
@@ -247,6 +269,7 @@ namespace eosio {
          }
 
          my->plugin_state->keep_alive = options.at("http-keep-alive").as<bool>();
+         my->plugin_state->chunked_response_threshold = options.at("http-chunked-response-threshold-kb").as<uint32_t>() * 1024ull;
 
          tcp::resolver resolver( app().get_io_service());
          if( options.count( "http-server-address" ) && options.at( "http-server-address" ).as<string>().length()) {
@@ -364,19 +387,22 @@ namespace eosio {
 
       // release http_plugin_impl_ptr shared_ptrs captured in url handlers
       my->plugin_state->url_handlers.clear();
+      my->plugin_state->binary_url_handlers.clear();
 
       fc_ilog( logger(), "exit shutdown");
    }
 
    void http_plugin::add_handler(const string& url, const url_handler& handler, appbase::exec_queue q, int priority, http_content_type content_type) {
       fc_ilog( logger(), "add api url: ${c}", ("c", url) );
-      auto p = my->plugin_state->url_handlers.emplace(url, my->make_app_thread_url_handler(url, q, priority, handler, my, content_type));
+      auto& handlers = content_type == http_content_type::octet_stream ? my->plugin_state->binary_url_handlers : my->plugin_state->url_handlers;
+      auto p = handlers.emplace(url, my->make_app_thread_url_handler(url, q, priority, handler, my, content_type));
       EOS_ASSERT( p.second, chain::plugin_config_exception, "http url ${u} is not unique", ("u", url) );
    }
 
    void http_plugin::add_async_handler(const string& url, const url_handler& handler, http_content_type content_type) {
       fc_ilog( logger(), "add api url: ${c}", ("c", url) );
-      auto p = my->plugin_state->url_handlers.emplace(url, my->make_http_thread_url_handler(url, handler, content_type));
+      auto& handlers = content_type == http_content_type::octet_stream ? my->plugin_state->binary_url_handlers : my->plugin_state->url_handlers;
+      auto p = handlers.emplace(url, my->make_http_thread_url_handler(url, handler, content_type));
       EOS_ASSERT( p.second, chain::plugin_config_exception, "http url ${u} is not unique", ("u", url) );
    }
 
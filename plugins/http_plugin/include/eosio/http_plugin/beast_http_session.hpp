@@ -7,8 +7,13 @@
 #include <boost/iostreams/stream.hpp>
 
 #include <memory>
+#include <mutex>
+#include <deque>
 #include <string>
 #include <charconv>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
 
 namespace eosio {
 
@@ -120,18 +125,84 @@ protected:
    // whether response should be sent back to client when an exception occurs
    bool is_send_exception_response_ = true;
 
+   // state of an in progress chunked response. Chunks are queued by the thread generating the response
+   // and written by whichever thread initiates or completes a write, at most one write is outstanding.
+   struct chunked_response_state {
+      std::mutex                                                 mtx;
+      http::response<http::empty_body>                           res;
+      std::optional<http::response_serializer<http::empty_body>> sr;
+      std::deque<std::string>                                    chunks;
+      bool                                                       writing = false;
+      bool                                                       header_sent = false;
+      bool                                                       complete = false;
+      bool                                                       success = true;
+      bool                                                       failed = false;
+      bool                                                       close = false;
+   };
+   std::shared_ptr<chunked_response_state> chunked_;
+
    void set_content_type_header(http_content_type content_type) {
       switch (content_type) {
          case http_content_type::plaintext:
             res_->set(http::field::content_type, "text/plain");
             break;
 
+         case http_content_type::octet_stream:
+            res_->set(http::field::content_type, "application/octet-stream");
+            break;
+
          case http_content_type::json:
          default:
             res_->set(http::field::content_type, "application/json");
       }
    }
 
+   static std::string_view trim_ows(std::string_view s) {
+      while(!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+         s.remove_prefix(1);
+      while(!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+         s.remove_suffix(1);
+      return s;
+   }
+
+   // true if the Accept header lists application/octet-stream with a q-value not below that of application/json,
+   // wildcards only stand for json so clients have to ask for binary explicitly
+   template<class Body, class Allocator>
+   static bool accepts_octet_stream(const http::request<Body, http::basic_fields<Allocator>>& req) {
+      const auto header = req[http::field::accept];
+      std::string_view accept(header.data(), header.size());
+      std::optional<double> octet_q, json_q, wildcard_q;
+      while(!accept.empty()) {
+         const auto comma = accept.find(',');
+         std::string_view range = accept.substr(0, comma);
+         accept = comma == std::string_view::npos ? std::string_view{} : accept.substr(comma + 1);
+
+         const auto semi = range.find(';');
+         const std::string_view media = trim_ows(range.substr(0, semi));
+         double q = 1;
+         for(auto params = semi == std::string_view::npos ? std::string_view{} : range.substr(semi + 1); !params.empty(); ) {
+            const auto next = params.find(';');
+            const std::string_view param = trim_ows(params.substr(0, next));
+            params = next == std::string_view::npos ? std::string_view{} : params.substr(next + 1);
+            if(param.size() > 2 && beast::iequals(param.substr(0, 2), "q=")) {
+               const std::string value(param.substr(2));
+               char* end = nullptr;
+               q = std::strtod(value.c_str(), &end);
+               if(end != value.c_str() + value.size())
+                  q = 0;
+            }
+         }
+
+         if(beast::iequals(media, "application/octet-stream"))
+            octet_q = q;
+         else if(beast::iequals(media, "application/json"))
+            json_q = q;
+         else if(beast::iequals(media, "application/*") || beast::iequals(media, "*/*"))
+            wildcard_q = std::max(wildcard_q.value_or(0), q);
+      }
+      return octet_q && *octet_q > 0 && *octet_q >= json_q.value_or(wildcard_q.value_or(0));
+   }
+
    enum class continue_state_t { none, read_body, reject };
    continue_state_t continue_state_ { continue_state_t::none };
 
@@ -184,20 +255,28 @@ protected:
                   ("ep", remote_endpoint_)("r", to_log_string(req)) );
 
          std::string resource = std::string(req.target());
-         // look for the URL handler to handle this resource
-         auto handler_itr = plugin_state_->url_handlers.find(resource);
-         if(handler_itr != plugin_state_->url_handlers.end()) {
+         // look for the URL handler to handle this resource, preferring a binary handler when the client accepts one
+         detail::internal_url_handler* handler = nullptr;
+         if(accepts_octet_stream(req)) {
+            if(auto itr = plugin_state_->binary_url_handlers.find(resource); itr != plugin_state_->binary_url_handlers.end())
+               handler = &itr->second;
+         }
+         if(!handler) {
+            if(auto itr = plugin_state_->url_handlers.find(resource); itr != plugin_state_->url_handlers.end())
+               handler = &itr->second;
+         }
+         if(handler) {
             if(plugin_state_->logger.is_enabled(fc::log_level::all))
                plugin_state_->logger.log(FC_LOG_MESSAGE(all, "resource: ${ep}", ("ep", resource)));
             std::string body = req.body();
-            auto content_type = handler_itr->second.content_type;
+            auto content_type = handler->content_type;
             set_content_type_header(content_type);
-            handler_itr->second.call_count.value++;
+            handler->call_count.value++;
             plugin_state_->metrics.post_metrics();
-            handler_itr->second.fn(derived().shared_from_this(),
-                                std::move(resource),
-                                std::move(body),
-                                make_http_response_handler(plugin_state_, derived().shared_from_this(), content_type));
+            handler->fn(derived().shared_from_this(),
+                        std::move(resource),
+                        std::move(body),
+                        make_http_response_handler(plugin_state_, derived().shared_from_this(), content_type));
          } else {
             fc_dlog( plugin_state_->logger, "404 - not found: ${ep}", ("ep", resource) );
             error_results results{static_cast<uint16_t>(http::status::not_found), "Not Found",
@@ -486,6 +565,10 @@ public:
       plugin_state_->bytes_in_flight -= sz;
    }
 
+   virtual void set_content_type(http_content_type content_type) final {
+      set_content_type_header(content_type);
+   }
+
    virtual void send_response(std::string&& json, unsigned int code) final {
       auto payload_size = json.size();
       increment_bytes_in_flight(payload_size);
@@ -513,6 +596,119 @@ public:
          });
    }
 
+   virtual bool supports_chunked_response() const final {
+      return res_->version() >= 11;
+   }
+
+   virtual void begin_chunked_response(unsigned int code) final {
+      write_begin_ = steady_clock::now();
+      auto dt = write_begin_ - handle_begin_;
+      handle_time_us_ += std::chrono::duration_cast<std::chrono::microseconds>(dt).count();
+
+      auto state = std::make_shared<chunked_response_state>();
+      res_->result(code);
+      state->res = http::response<http::empty_body>{std::move(res_->base())};
+      state->res.chunked(true);
+      state->close = !(plugin_state_->keep_alive) || state->res.need_eof();
+      state->sr.emplace(state->res);
+
+      fc_dlog( plugin_state_->logger, "Response: ${ep} ${b}",
+               ("ep", remote_endpoint_)("b", to_log_string(state->res)) );
+
+      chunked_ = state;
+      std::lock_guard g(state->mtx);
+      do_chunked_write(state);
+   }
+
+   virtual std::string send_chunk(std::string&& chunk) final {
+      auto& state = chunked_;
+      std::lock_guard g(state->mtx);
+      if(state->failed)
+         return "Connection closed";
+      if(auto error_str = verify_max_bytes_in_flight(chunk.size()); !error_str.empty())
+         return error_str;
+      increment_bytes_in_flight(chunk.size());
+      state->chunks.emplace_back(std::move(chunk));
+      if(!state->writing)
+         do_chunked_write(state);
+      return {};
+   }
+
+   virtual void end_chunked_response(bool success) final {
+      auto state = chunked_;
+      std::lock_guard g(state->mtx);
+      state->complete = true;
+      state->success = success;
+      if(!state->writing && !state->failed)
+         do_chunked_write(state);
+   }
+
+private:
+   // must be called with state->mtx locked and no write outstanding
+   void do_chunked_write(const std::shared_ptr<chunked_response_state>& state) {
+      if(!state->header_sent) {
+         state->writing = true;
+         http::async_write_header(
+            derived().stream(),
+            *state->sr,
+            [self = derived().shared_from_this(), state](beast::error_code ec, std::size_t) {
+               self->on_chunked_write(ec, state, 0, false);
+            });
+      } else if(!state->chunks.empty()) {
+         state->writing = true;
+         const auto& chunk = state->chunks.front();
+         asio::async_write(
+            derived().stream(),
+            http::make_chunk(asio::const_buffer(chunk.data(), chunk.size())),
+            [self = derived().shared_from_this(), state, chunk_size = chunk.size()](beast::error_code ec, std::size_t) {
+               self->on_chunked_write(ec, state, chunk_size, false);
+            });
+      } else if(state->complete) {
+         if(state->success) {
+            state->writing = true;
+            asio::async_write(
+               derived().stream(),
+               http::make_chunk_last(),
+               [self = derived().shared_from_this(), state](beast::error_code ec, std::size_t) {
+                  self->on_chunked_write(ec, state, 0, true);
+               });
+         } else {
+            // status already sent, no way to report the failure other than closing the connection
+            state->failed = true;
+            derived().do_eof();
+         }
+      }
+   }
+
+   void on_chunked_write(beast::error_code ec, const std::shared_ptr<chunked_response_state>& state, size_t chunk_size, bool last) {
+      std::unique_lock g(state->mtx);
+      state->writing = false;
+      if(!state->header_sent) {
+         state->header_sent = true;
+      } else if(!last) {
+         state->chunks.pop_front();
+         decrement_bytes_in_flight(chunk_size);
+      }
+
+      if(ec) {
+         state->failed = true;
+         for(const auto& c : state->chunks)
+            decrement_bytes_in_flight(c.size());
+         state->chunks.clear();
+         return fail(ec, "write", plugin_state_->logger, "closing connection");
+      }
+
+      if(last) {
+         bool close = state->close;
+         g.unlock();
+         chunked_.reset();
+         return on_write(ec, 0, close);
+      }
+
+      do_chunked_write(state);
+   }
+
+public:
    void run_session() {
       if(auto error_str = verify_max_requests_in_flight(); !error_str.empty()) {
          send_busy_response(std::move(error_str));
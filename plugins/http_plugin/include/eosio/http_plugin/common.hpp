@@ -8,8 +8,11 @@
 #include <atomic>
 #include <map>
 #include <optional>
+#include <ostream>
 #include <regex>
 #include <set>
+#include <stdexcept>
+#include <streambuf>
 #include <string>
 
 #include <fc/io/raw.hpp>
@@ -61,6 +64,20 @@ struct abstract_conn {
    virtual void handle_exception() = 0;
 
    virtual void send_response(std::string&& json_body, unsigned int code) = 0;
+   virtual void set_content_type(http_content_type content_type) = 0;
+
+   /**
+    * Chunked (Transfer-Encoding: chunked) responses. begin_chunked_response() is followed by any number of
+    * send_chunk() calls and then exactly one end_chunked_response(). All three must be called from the same thread.
+    * end_chunked_response(false) closes the connection once queued chunks are written, since the status code
+    * has already been sent and an error response is no longer possible.
+    * Queued chunks count against max-bytes-in-flight. send_chunk() returns an error, and does not queue the chunk,
+    * if it would exceed the limit or the connection failed; the response should then be ended unsuccessfully.
+    */
+   virtual bool supports_chunked_response() const = 0;
+   virtual void begin_chunked_response(unsigned int code) = 0;
+   virtual std::string send_chunk(std::string&& chunk) = 0;
+   virtual void end_chunked_response(bool success) = 0;
 };
 
 using abstract_conn_ptr = std::shared_ptr<abstract_conn>;
@@ -105,6 +122,64 @@ static size_t in_flight_sizeof(const std::optional<T>& o) {
    return 0;
 }
 
+/**
+* std::streambuf that hands its contents off in chunks of chunk_size bytes as they fill up,
+* allowing a response to be written to the connection while it is still being generated
+*/
+class chunked_streambuf : public std::streambuf {
+public:
+   using chunk_callback = std::function<void(std::string&&)>;
+
+   chunked_streambuf(size_t chunk_size, chunk_callback cb)
+   : chunk_size_(chunk_size), cb_(std::move(cb)) {
+      reset_buffer();
+   }
+
+   /// total number of bytes written so far, including those not yet handed off
+   size_t total_size() const { return flushed_size_ + (pptr() - pbase()); }
+
+   /// hand off any partially filled chunk
+   void finish() { flush_chunk(); }
+
+protected:
+   int_type overflow(int_type ch) override {
+      flush_chunk();
+      if(!traits_type::eq_int_type(ch, traits_type::eof())) {
+         *pptr() = traits_type::to_char_type(ch);
+         pbump(1);
+      }
+      return traits_type::not_eof(ch);
+   }
+
+   // only support tellp(), used by fc::json::to_stream for yield
+   pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+      if(off == 0 && dir == std::ios_base::cur && (which & std::ios_base::out))
+         return pos_type(off_type(total_size()));
+      return pos_type(off_type(-1));
+   }
+
+private:
+   void flush_chunk() {
+      size_t sz = pptr() - pbase();
+      if(sz == 0)
+         return;
+      buffer_.resize(sz);
+      flushed_size_ += sz;
+      cb_(std::move(buffer_));
+      reset_buffer();
+   }
+
+   void reset_buffer() {
+      buffer_ = std::string(chunk_size_, '\0');
+      setp(buffer_.data(), buffer_.data() + buffer_.size());
+   }
+
+   size_t         chunk_size_;
+   chunk_callback cb_;
+   std::string    buffer_;
+   size_t         flushed_size_ = 0;
+};
+
 }// namespace detail
 
 // key -> priority, url_handler
@@ -140,6 +215,11 @@ struct http_plugin_state {
    size_t max_bytes_in_flight = 0;
    int32_t max_requests_in_flight = -1;
    fc::microseconds max_response_time{30 * 1000};
+   // requests for the app thread not started within this time get a busy response, unlimited when unset
+   std::optional<std::chrono::microseconds> max_queue_time;
+   // json responses estimated larger than this are streamed with chunked transfer-encoding, 0 to disable
+   size_t chunked_response_threshold = 0;
+   static constexpr size_t response_chunk_size = 64 * 1024;
 
    bool validate_host = true;
    set<string> valid_hosts;
@@ -147,6 +227,8 @@ struct http_plugin_state {
    string server_header;
 
    url_handlers_type url_handlers;
+   // handlers selected instead of url_handlers when the request has Accept: application/octet-stream
+   url_handlers_type binary_url_handlers;
    bool keep_alive = false;
 
    uint16_t thread_pool_size = 2;
@@ -160,6 +242,41 @@ struct http_plugin_state {
        : logger(log) {}
 };
 
+namespace detail {
+/**
+* Stream the JSON representation of response to the connection in chunks of http_plugin_state::response_chunk_size
+* so the full JSON string is never materialized and the client receives the first bytes while the rest is generated.
+*/
+static void send_chunked_json_response(http_plugin_state& plugin_state, const abstract_conn_ptr& session_ptr,
+                                       unsigned int code, const fc::variant& response, const fc::time_point& deadline) {
+   session_ptr->begin_chunked_response(code);
+   try {
+      chunked_streambuf buf(http_plugin_state::response_chunk_size, [&session_ptr](std::string&& chunk) {
+         // a client reading slower than the response is generated would otherwise queue all of it
+         if(auto error_str = session_ptr->send_chunk(std::move(chunk)); !error_str.empty())
+            throw std::runtime_error(error_str);
+      });
+      std::ostream os(&buf);
+      os.exceptions(std::ios_base::badbit | std::ios_base::failbit);
+      const auto yield = [&](size_t) {
+         FC_CHECK_DEADLINE(deadline);
+      };
+      fc::json::to_stream(os, response, yield);
+      buf.finish();
+      session_ptr->end_chunked_response(true);
+   } catch(const fc::exception& e) {
+      fc_elog(plugin_state.logger, "Aborting chunked response: ${e}", ("e", e.to_detail_string()));
+      session_ptr->end_chunked_response(false);
+   } catch(const std::exception& e) {
+      fc_elog(plugin_state.logger, "Aborting chunked response: ${e}", ("e", e.what()));
+      session_ptr->end_chunked_response(false);
+   } catch(...) {
+      fc_elog(plugin_state.logger, "Aborting chunked response: unknown exception");
+      session_ptr->end_chunked_response(false);
+   }
+}
+}// namespace detail
+
 /**
 * Construct a lambda appropriate for url_response_callback that will
 * JSON-stringify the provided response
@@ -189,13 +306,27 @@ auto make_http_response_handler(std::shared_ptr<http_plugin_state> plugin_state,
                         [plugin_state, session_ptr, code, deadline, start, payload_size, response = std::move(response), content_type]() {
                            try {
                               plugin_state->bytes_in_flight -= payload_size;
-                              if (response.has_value()) {
+                              if (response.has_value() && content_type == http_content_type::json &&
+                                  plugin_state->chunked_response_threshold > 0 && payload_size >= plugin_state->chunked_response_threshold &&
+                                  session_ptr->supports_chunked_response()) {
+                                 detail::send_chunked_json_response(*plugin_state, session_ptr, code, *response, deadline + (fc::time_point::now() - start));
+                              } else if (response.has_value() && content_type == http_content_type::octet_stream && response->is_blob()) {
+                                 const auto& data = response->get_blob().data;
+                                 if (auto error_str = session_ptr->verify_max_bytes_in_flight(data.size()); error_str.empty())
+                                    session_ptr->send_response(std::string(data.data(), data.size()), code);
+                                 else
+                                    session_ptr->send_busy_response(std::move(error_str));
+                              } else if (response.has_value()) {
+                                 if (content_type == http_content_type::octet_stream) // errors are always reported as json
+                                    session_ptr->set_content_type(http_content_type::json);
                                  std::string json = (content_type == http_content_type::plaintext) ? response->as_string() : fc::json::to_string(*response, deadline + (fc::time_point::now() - start));
                                  if (auto error_str = session_ptr->verify_max_bytes_in_flight(json.size()); error_str.empty())
                                     session_ptr->send_response(std::move(json), code);
                                  else
                                     session_ptr->send_busy_response(std::move(error_str));
                               } else {
+                                 if (content_type == http_content_type::octet_stream)
+                                    session_ptr->set_content_type(http_content_type::json);
                                  session_ptr->send_response("{}", code);
                               }
                            } catch (...) {
@@ -41,7 +41,9 @@ namespace eosio {
 
    enum class http_content_type {
       json = 1,
-      plaintext = 2
+      plaintext = 2,
+      /// handler responds with an fc::blob which is sent as-is; selected by requests with Accept: application/octet-stream
+      octet_stream = 3
    };
 
    struct http_plugin_defaults {
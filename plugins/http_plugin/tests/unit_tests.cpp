@@ -52,7 +52,28 @@ public:
                   cb(200, fc::time_point::maximum(), fc::variant(ok ? string("yes") : string("no")));
                }
             },
+            {  std::string("/large"), // response larger than --http-chunked-response-threshold-kb, sent chunked
+               [&](string&&, string&& body, url_response_callback&& cb) {
+                  cb(200, fc::time_point::maximum(), fc::variant(large_response()));
+               }
+            },
          }, appbase::exec_queue::read_write);
+
+      // served instead of /hello above to clients sending Accept: application/octet-stream
+      p.add_api({
+            {  std::string("/hello"),
+               [&](string&&, string&& body, url_response_callback&& cb) {
+                  cb(200, fc::time_point::maximum(), fc::variant(fc::blob{{'\x01', '\x00', '\x02'}}));
+               }
+            },
+         }, appbase::exec_queue::read_write, appbase::priority::medium_low, http_content_type::octet_stream);
+   }
+
+   static string large_response() {
+      string r;
+      for (size_t i = 0; r.size() < 200 * 1024; ++i)
+         r += std::to_string(i);
+      return r;
    }
 
 private:
@@ -204,6 +225,12 @@ void run_test(Protocol& p, size_t max_body_size)
    // check ones with small body
    check_request(p, "/check_ones", "111111111111111111111111", {"yes"});
 
+   // large response streamed with chunked transfer-encoding
+   {
+      string expected = Db::large_response();
+      check_request(p, "/large", nullptr, {expected.c_str()});
+   }
+
    // check ones with long body exactly max_req_size - should work and return yes
    {
       string test_str;
@@ -239,7 +266,8 @@ BOOST_AUTO_TEST_CASE(http_plugin_unit_tests)
    const char* argv[] = { bu::framework::current_test_case().p_name->c_str(),
                           "--http-validate-host", "false",
                           "--http-threads", "4", 
-                          "--http-max-response-time-ms", "50" };
+                          "--http-max-response-time-ms", "50",
+                          "--http-chunked-response-threshold-kb", "1" };
    
    BOOST_CHECK(app->initialize<http_plugin>(sizeof(argv) / sizeof(char*), const_cast<char**>(argv)));
 
@@ -283,6 +311,39 @@ BOOST_AUTO_TEST_CASE(http_plugin_unit_tests)
          run_test(p, max_body_size);
       }
 
+      // binary response negotiated with the Accept header
+      {
+         http::request<http::string_body> req{http::verb::post, "/hello", 11};
+         req.set(http::field::host, host);
+         req.set(http::field::accept, "application/octet-stream");
+         http::write(stream, req);
+
+         beast::flat_buffer buffer;
+         http::response<http::string_body> res;
+         http::read(stream, buffer, res);
+         BOOST_CHECK(res[http::field::content_type] == "application/octet-stream");
+         BOOST_CHECK(res.body() == string("\x01\x00\x02", 3));
+      }
+
+      // the Accept header is parsed as media ranges with q-values
+      auto content_type_for = [&](const char* accept) {
+         http::request<http::string_body> req{http::verb::post, "/hello", 11};
+         req.set(http::field::host, host);
+         req.set(http::field::accept, accept);
+         http::write(stream, req);
+
+         beast::flat_buffer buffer;
+         http::response<http::string_body> res;
+         http::read(stream, buffer, res);
+         return std::string(res[http::field::content_type]);
+      };
+      BOOST_CHECK_EQUAL(content_type_for("application/json, application/octet-stream;q=0.5"), "application/json");
+      BOOST_CHECK_EQUAL(content_type_for("application/octet-stream;q=0"), "application/json");
+      BOOST_CHECK_EQUAL(content_type_for("application/octet-stream-x"), "application/json");
+      BOOST_CHECK_EQUAL(content_type_for("*/*"), "application/json");
+      BOOST_CHECK_EQUAL(content_type_for("Application/Octet-Stream ; q=0.8, */*;q=0.1"), "application/octet-stream");
+      BOOST_CHECK_EQUAL(content_type_for("text/html, application/octet-stream"), "application/octet-stream");
+
       // Gracefully close the socket
       beast::error_code ec;
       stream.socket().shutdown(tcp::socket::shutdown_both, ec);
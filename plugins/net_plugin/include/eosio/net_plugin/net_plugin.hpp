@@ -12,12 +12,17 @@ namespace eosio {
       chain::plugin_interface::runtime_metric num_peers{ chain::plugin_interface::metric_type::gauge, "num_peers", "num_peers", 0 };
       chain::plugin_interface::runtime_metric num_clients{ chain::plugin_interface::metric_type::gauge, "num_clients", "num_clients", 0 };
       chain::plugin_interface::runtime_metric dropped_trxs{ chain::plugin_interface::metric_type::counter, "dropped_trxs", "dropped_trxs", 0 };
+      // time connection strands spent unpacking, including decompression and transaction id computation
+      chain::plugin_interface::runtime_metric block_unpack_us{ chain::plugin_interface::metric_type::counter, "block_unpack_us", "block_unpack_us", 0 };
+      chain::plugin_interface::runtime_metric trx_unpack_us{ chain::plugin_interface::metric_type::counter, "trx_unpack_us", "trx_unpack_us", 0 };
 
       vector<chain::plugin_interface::runtime_metric> metrics() final {
          vector<chain::plugin_interface::runtime_metric> metrics {
             num_peers,
             num_clients,
-            dropped_trxs
+            dropped_trxs,
+            block_unpack_us,
+            trx_unpack_us
          };
 
          return metrics;
@@ -281,6 +281,8 @@ namespace eosio {
       unique_ptr<boost::asio::steady_timer> keepalive_timer;
 
       std::atomic<bool>                     in_shutdown{false};
+      std::atomic<uint64_t>                 block_unpack_us{0}; // see net_plugin_metrics
+      std::atomic<uint64_t>                 trx_unpack_us{0};
 
       compat::channels::transaction_ack::channel_type::handle  incoming_transaction_ack_subscription;
 
@@ -2673,7 +2675,9 @@ namespace eosio {
       auto ds = pending_message_buffer.create_datastream();
       fc::raw::unpack( ds, which );
       shared_ptr<signed_block> ptr = std::make_shared<signed_block>();
-      fc::raw::unpack( ds, *ptr );
+      const auto unpack_start = fc::time_point::now();
+      fc::raw::unpack( ds, *ptr ); // decompresses and computes the id of every packed transaction
+      my_impl->block_unpack_us += (fc::time_point::now() - unpack_start).count();
 
       auto is_webauthn_sig = []( const fc::crypto::signature& s ) {
          return s.which() == fc::get_index<fc::crypto::signature::storage_type, fc::crypto::webauthn::signature>();
@@ -2711,7 +2715,9 @@ namespace eosio {
       unsigned_int which{};
       fc::raw::unpack( ds, which );
       shared_ptr<packed_transaction> ptr = std::make_shared<packed_transaction>();
-      fc::raw::unpack( ds, *ptr );
+      const auto unpack_start = fc::time_point::now();
+      fc::raw::unpack( ds, *ptr ); // decompresses and computes the id
+      my_impl->trx_unpack_us += (fc::time_point::now() - unpack_start).count();
       if( trx_in_progress_sz > def_max_trx_in_progress_size) {
          ++my_impl->metrics.dropped_trxs.value;
          char reason[72];
@@ -3500,6 +3506,8 @@ namespace eosio {
 
       metrics.num_clients.value = num_clients;
       metrics.num_peers.value = num_peers;
+      metrics.block_unpack_us.value = block_unpack_us.load();
+      metrics.trx_unpack_us.value = trx_unpack_us.load();
       metrics.post_metrics();
 
       if( num_clients > 0 || num_peers > 0 )
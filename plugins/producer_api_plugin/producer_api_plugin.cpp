@@ -116,6 +116,8 @@ void producer_api_plugin::plugin_startup() {
                                  producer_plugin::get_supported_protocol_features_params), 201),
        CALL_WITH_400(producer, producer, get_account_ram_corrections,
             INVOKE_R_R(producer, get_account_ram_corrections, producer_plugin::get_account_ram_corrections_params), 201),
+       CALL_WITH_400(producer, producer, get_contract_profile,
+            INVOKE_R_R_II(producer, get_contract_profile, producer_plugin::get_contract_profile_params), 201),
        CALL_WITH_400(producer, producer, get_unapplied_transactions,
                      INVOKE_R_R_D(producer, get_unapplied_transactions, producer_plugin::get_unapplied_transactions_params), 200),
        CALL_WITH_400(producer, producer, get_snapshot_requests,
@@ -144,6 +146,8 @@ void producer_api_plugin::plugin_startup() {
             INVOKE_R_R(producer, unschedule_snapshot, producer_plugin::snapshot_request_id_information), 201),
        CALL_WITH_400(producer, producer, get_integrity_hash,
             INVOKE_R_V(producer, get_integrity_hash), 201),
+       CALL_WITH_400(producer, producer, get_state_commitment,
+            INVOKE_R_V(producer, get_state_commitment), 201),
        CALL_WITH_400(producer, producer, schedule_protocol_feature_activations,
             INVOKE_V_R(producer, schedule_protocol_feature_activations, producer_plugin::scheduled_protocol_feature_activations), 201),
    }, appbase::exec_queue::read_write, appbase::priority::medium_high);
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <eosio/chain/unapplied_transaction_queue.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+namespace eosio {
+
+/**
+ * Schedules incoming transactions fairly between their first authorizers (start-time fair queueing, the
+ * continuous form of deficit round robin). Every account advances its own virtual clock by the cost of each
+ * transaction it sends; a transaction is ordered by the virtual time it starts at, which is never earlier than
+ * the virtual time of the queue. An account flooding the node therefore only queues behind itself, while an
+ * account that sends one transaction is served after at most one transaction of every other account.
+ *
+ * The cost of a transaction is supplied by the producer, e.g. from subjective billing history and staked CPU.
+ * Scheduling is an amortized O(1) hash lookup; accounts whose clock fell behind the queue's are pruned in bulk.
+ */
+class fair_trx_scheduler : public chain::incoming_trx_scheduler {
+public:
+   static constexpr size_t min_prune_size = 1024;
+
+   /// cost of the next transaction of an account in virtual time, at least 1
+   using cost_func_t = std::function<uint64_t( const chain::account_name& )>;
+
+   explicit fair_trx_scheduler( cost_func_t cost )
+   : _cost( std::move( cost ) ) {}
+
+   uint64_t schedule( const chain::transaction_metadata& trx ) override {
+      const auto account = trx.packed_trx()->get_transaction().first_authorizer();
+      auto& finish = _finish[account];
+      const uint64_t start = std::max( finish, _virtual_time );
+      finish = start + std::max<uint64_t>( _cost( account ), 1 );
+      if( _finish.size() >= _prune_size )
+         prune();
+      return start;
+   }
+
+   void processed( uint64_t order ) override {
+      _virtual_time = std::max( _virtual_time, order );
+   }
+
+   void clear() override {
+      _finish.clear();
+      _virtual_time = 0;
+      _prune_size = min_prune_size;
+   }
+
+   uint64_t virtual_time() const { return _virtual_time; }
+   size_t tracked_accounts() const { return _finish.size(); }
+
+private:
+   void prune() {
+      // an account with nothing scheduled past the queue's virtual time starts there anyway
+      for( auto itr = _finish.begin(); itr != _finish.end(); ) {
+         if( itr->second <= _virtual_time )
+            itr = _finish.erase( itr );
+         else
+            ++itr;
+      }
+      _prune_size = std::max( min_prune_size, _finish.size() * 2 );
+   }
+
+   cost_func_t                                             _cost;
+   std::unordered_map<chain::account_name, uint64_t>       _finish;
+   uint64_t                                                _virtual_time = 0;
+   size_t                                                  _prune_size = min_prune_size;
+};
+
+} // namespace eosio
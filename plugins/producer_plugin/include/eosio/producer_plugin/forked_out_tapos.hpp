@@ -0,0 +1,49 @@
+#pragma once
+
+#include <eosio/chain/controller.hpp>
+#include <eosio/chain/unapplied_transaction_queue.hpp>
+
+#include <map>
+#include <vector>
+
+namespace eosio {
+
+/**
+ * Drops queued transactions whose TaPoS references a block of forked_out that is not back on the branch of the
+ * chain head. validate_tapos rejects them on every block built on the new head, so they are not worth re-applying on
+ * the main thread. Covers forked, aborted and incoming transactions alike.
+ *
+ * @param on_drop - called with the unapplied_transaction and the id of its forked out reference block before the
+ *                  transaction is erased
+ * @return the number of dropped transactions
+ */
+template<typename OnDrop>
+size_t drop_forked_out_tapos_trxs( chain::unapplied_transaction_queue& queue, const chain::controller& chain,
+                                   const std::vector<chain::block_id_type>& forked_out, OnDrop&& on_drop ) {
+   const auto head_num = chain.head_block_num();
+   std::map<uint16_t, chain::block_id_type> ref_blocks; // forked out block by ref_block_num
+   for( const auto& id : forked_out ) {
+      const auto num = chain::block_header::num_from_id( id );
+      if( num <= head_num && chain.get_block_id_for_num( num ) == id )
+         continue; // switched back to it
+      ref_blocks[static_cast<uint16_t>( num )] = id;
+   }
+   if( ref_blocks.empty() )
+      return 0;
+
+   size_t dropped = 0;
+   for( auto itr = queue.begin(); itr != queue.end(); ) {
+      const auto& trx = itr->trx_meta->packed_trx()->get_transaction();
+      auto ref = ref_blocks.find( trx.ref_block_num );
+      if( ref == ref_blocks.end() || !trx.verify_reference_block( ref->second ) ) {
+         ++itr;
+         continue;
+      }
+      on_drop( *itr, ref->second );
+      itr = queue.erase( itr );
+      ++dropped;
+   }
+   return dropped;
+}
+
+} // namespace eosio
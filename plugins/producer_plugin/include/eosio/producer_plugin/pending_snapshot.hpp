@@ -37,6 +37,7 @@ public:
    next_t                   next;
    std::string              pending_path;
    std::string              final_path;
+   bool                     in_progress = false; ///< still being written by a background snapshot process
 };
 
 } // namespace eosio
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <eosio/chain/contract_profiler.hpp>
 #include <eosio/chain/plugin_metrics.hpp>
 #include <eosio/chain_plugin/chain_plugin.hpp>
 #include <eosio/signature_provider_plugin/signature_provider_plugin.hpp>
@@ -24,6 +25,35 @@ struct producer_plugin_metrics : public plugin_metrics {
    runtime_metric head_block_num{metric_type::gauge, "head_block_num", "head_block_num", 0};
    runtime_metric subjective_bill_account_size{metric_type::gauge, "subjective_bill_account_size", "subjective_bill_account_size", 0};
    runtime_metric scheduled_trxs{metric_type::gauge, "scheduled_trxs", "scheduled_trxs", 0};
+   runtime_metric trxs_rate_limited_by_authorizer{metric_type::counter, "trxs_rate_limited_by_authorizer", "trxs_rate_limited_by_authorizer", 0};
+   runtime_metric trxs_rate_limited_by_contract{metric_type::counter, "trxs_rate_limited_by_contract", "trxs_rate_limited_by_contract", 0};
+   runtime_metric hot_contract_tables{metric_type::gauge, "hot_contract_tables", "hot_contract_tables", 0};
+   runtime_metric cold_contract_tables{metric_type::gauge, "cold_contract_tables", "cold_contract_tables", 0};
+   runtime_metric hot_contract_rows{metric_type::gauge, "hot_contract_rows", "hot_contract_rows", 0};
+   runtime_metric cold_contract_rows{metric_type::gauge, "cold_contract_rows", "cold_contract_rows", 0};
+   runtime_metric state_resident_bytes{metric_type::gauge, "state_resident_bytes", "state_resident_bytes", 0};
+   runtime_metric state_nonresident_bytes{metric_type::gauge, "state_nonresident_bytes", "state_nonresident_bytes", 0};
+
+   // app executor queue, values cover the interval since the previous post
+   struct exec_queue_metrics {
+      runtime_metric executed;
+      runtime_metric expired;
+      runtime_metric max_depth;
+      runtime_metric max_wait_us;
+      runtime_metric avg_wait_us;
+
+      explicit exec_queue_metrics(const std::string& q)
+      : executed{metric_type::gauge, q + "_executed", q + "_executed", 0}
+      , expired{metric_type::gauge, q + "_expired", q + "_expired", 0}
+      , max_depth{metric_type::gauge, q + "_max_depth", q + "_max_depth", 0}
+      , max_wait_us{metric_type::gauge, q + "_max_wait_us", q + "_max_wait_us", 0}
+      , avg_wait_us{metric_type::gauge, q + "_avg_wait_us", q + "_avg_wait_us", 0} {}
+   };
+   exec_queue_metrics read_write_queue{"read_write_queue"};
+   exec_queue_metrics read_only_queue{"read_only_queue"};
+
+   // contract actions with the most WASM execution time, labeled by contract and action
+   vector<runtime_metric> contract_cpu;
 
    vector<runtime_metric> metrics() final {
       vector<runtime_metric> metrics{
@@ -34,8 +64,20 @@ struct producer_plugin_metrics : public plugin_metrics {
             last_irreversible,
             head_block_num,
             subjective_bill_account_size,
-            scheduled_trxs
+            scheduled_trxs,
+            trxs_rate_limited_by_authorizer,
+            trxs_rate_limited_by_contract,
+            hot_contract_tables,
+            cold_contract_tables,
+            hot_contract_rows,
+            cold_contract_rows,
+            state_resident_bytes,
+            state_nonresident_bytes
       };
+      for (const auto* q : {&read_write_queue, &read_only_queue}) {
+         metrics.insert(metrics.end(), {q->executed, q->expired, q->max_depth, q->max_wait_us, q->avg_wait_us});
+      }
+      metrics.insert(metrics.end(), contract_cpu.begin(), contract_cpu.end());
 
       return metrics;
    }
@@ -74,6 +116,17 @@ public:
       chain::digest_type   integrity_hash;
    };
 
+   struct index_commitment {
+      std::string          index;
+      chain::digest_type   commitment;
+   };
+
+   struct state_commitment_information {
+      chain::block_id_type          head_block_id;
+      chain::digest_type            state_commitment;
+      std::vector<index_commitment> indices;
+   };
+
    struct snapshot_information {
       chain::block_id_type head_block_id;
       uint32_t             head_block_num;
@@ -160,6 +213,7 @@ public:
    void set_whitelist_blacklist(const whitelist_blacklist& params);
 
    integrity_hash_information get_integrity_hash() const;
+   state_commitment_information get_state_commitment() const;
 
    void create_snapshot(next_function<snapshot_information> next);
    snapshot_schedule_result schedule_snapshot(const snapshot_request_information& schedule);
@@ -173,6 +227,20 @@ public:
 
    get_account_ram_corrections_result  get_account_ram_corrections( const get_account_ram_corrections_params& params ) const;
 
+   struct get_contract_profile_params {
+      uint32_t                     limit = 20;
+      bool                         clear = false; ///< restart aggregation after reading
+   };
+
+   struct get_contract_profile_result {
+      fc::time_point                                 since;
+      uint64_t                                       untracked_us = 0;
+      std::vector<chain::contract_profiler::entry>   rows; ///< by total_us, descending
+   };
+
+   /// requires chain_plugin profile-contracts
+   get_contract_profile_result get_contract_profile( const get_contract_profile_params& params ) const;
+
    struct get_unapplied_transactions_params {
       string      lower_bound;  /// transaction id
       std::optional<uint32_t>    limit = 100;
@@ -222,6 +290,8 @@ FC_REFLECT(eosio::producer_plugin::runtime_options, (max_transaction_time)(max_i
 FC_REFLECT(eosio::producer_plugin::greylist_params, (accounts));
 FC_REFLECT(eosio::producer_plugin::whitelist_blacklist, (actor_whitelist)(actor_blacklist)(contract_whitelist)(contract_blacklist)(action_blacklist)(key_blacklist) )
 FC_REFLECT(eosio::producer_plugin::integrity_hash_information, (head_block_id)(integrity_hash))
+FC_REFLECT(eosio::producer_plugin::index_commitment, (index)(commitment))
+FC_REFLECT(eosio::producer_plugin::state_commitment_information, (head_block_id)(state_commitment)(indices))
 FC_REFLECT(eosio::producer_plugin::snapshot_information, (head_block_id)(head_block_num)(head_block_time)(version)(snapshot_name))
 FC_REFLECT(eosio::producer_plugin::snapshot_request_information, (block_spacing)(start_block_num)(end_block_num)(snapshot_description))
 FC_REFLECT(eosio::producer_plugin::snapshot_request_id_information, (snapshot_request_id))
@@ -232,6 +302,8 @@ FC_REFLECT(eosio::producer_plugin::scheduled_protocol_feature_activations, (prot
 FC_REFLECT(eosio::producer_plugin::get_supported_protocol_features_params, (exclude_disabled)(exclude_unactivatable))
 FC_REFLECT(eosio::producer_plugin::get_account_ram_corrections_params, (lower_bound)(upper_bound)(limit)(reverse))
 FC_REFLECT(eosio::producer_plugin::get_account_ram_corrections_result, (rows)(more))
+FC_REFLECT(eosio::producer_plugin::get_contract_profile_params, (limit)(clear))
+FC_REFLECT(eosio::producer_plugin::get_contract_profile_result, (since)(untracked_us)(rows))
 FC_REFLECT(eosio::producer_plugin::get_unapplied_transactions_params, (lower_bound)(limit)(time_limit_ms))
 FC_REFLECT(eosio::producer_plugin::unapplied_trx, (trx_id)(expiration)(trx_type)(first_auth)(first_receiver)(first_action)(total_actions)(billed_cpu_time_us)(size))
 FC_REFLECT(eosio::producer_plugin::get_unapplied_transactions_result, (size)(incoming_size)(trxs)(more))
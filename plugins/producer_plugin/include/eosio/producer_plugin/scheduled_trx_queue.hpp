@@ -0,0 +1,140 @@
+#pragma once
+
+#include <eosio/chain/controller.hpp>
+#include <eosio/chain/generated_transaction_object.hpp>
+
+#include <optional>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace eosio {
+
+/**
+ * Scheduled (deferred) transactions of the chain state ordered by when they become due, without the ones the
+ * producer blacklisted, so starting a block pops only the transactions it can execute instead of walking the
+ * generated_transaction_multi_index from its oldest delay.
+ *
+ * The queue is maintained incrementally. chainbase assigns increasing ids to generated transactions, and sending,
+ * replacing or re-sending one always creates a new object, so refresh() only visits objects with ids past the last
+ * one it visited. Objects published in the pending block are left for the next refresh since aborting the block
+ * undoes them and their ids are reused. Canceled transactions and ones executed in received blocks stay queued
+ * until they become due and are then dropped by pop_due(); the queue is rebuilt when too many accumulated, or when
+ * the chain switched forks since the last refresh. Entries popped while building a block are remembered until the
+ * block is committed, since aborting it restores their objects under the same ids, which refresh() does not revisit.
+ */
+class scheduled_trx_queue {
+public:
+   struct entry {
+      fc::time_point                                   delay_until;
+      chain::generated_transaction_object::id_type     id;
+      chain::transaction_id_type                       trx_id;
+      fc::time_point                                   expiration;
+
+      friend bool operator<( const entry& a, const entry& b ) {
+         return std::tie( a.delay_until, a.id ) < std::tie( b.delay_until, b.id );
+      }
+   };
+
+   /// bring the queue up to date with the state of the pending block, is_blacklisted(trx_id) entries are skipped
+   template<typename Blacklisted>
+   void refresh( const chain::controller& chain, Blacklisted&& is_blacklisted ) {
+      const auto& db = chain.db();
+      const auto& idx = db.get_index<chain::generated_transaction_multi_index, chain::by_id>();
+      if( switched_forks( chain ) || _ready.size() > 2 * idx.size() + min_rebuild_size ) {
+         _ready.clear();
+         _next_id = chain::generated_transaction_object::id_type( 0 );
+      }
+      _head_num = chain.head_block_num();
+      _head_id = chain.head_block_id();
+
+      const auto pending_block_time = chain.pending_block_time();
+      for( auto itr = idx.lower_bound( _next_id ); itr != idx.end(); ++itr ) {
+         // objects of the pending block have the highest ids
+         if( itr->published >= pending_block_time )
+            break;
+         _next_id = chain::generated_transaction_object::id_type( itr->id._id + 1 );
+         if( !is_blacklisted( itr->trx_id ) )
+            push( to_entry( *itr ) );
+      }
+   }
+
+   /// pops the next entry due at pending_block_time that is still in the chain state
+   std::optional<entry> pop_due( const chainbase::database& db, const fc::time_point& pending_block_time ) {
+      while( !_ready.empty() && _ready.begin()->delay_until <= pending_block_time ) {
+         const entry e = *_ready.begin();
+         _ready.erase( _ready.begin() );
+         const auto* gto = db.find<chain::generated_transaction_object, chain::by_id>( e.id );
+         if( gto && gto->trx_id == e.trx_id ) {
+            _popped.push_back( e );
+            return e;
+         }
+      }
+      return {};
+   }
+
+   /// requeue a popped entry that was not executed
+   void push( const entry& e ) {
+      _ready.insert( e );
+   }
+
+   /// requeue a transaction that was skipped by refresh() because it was blacklisted
+   void release( const chainbase::database& db, const chain::transaction_id_type& trx_id ) {
+      const auto* gto = db.find<chain::generated_transaction_object, chain::by_trx_id>( trx_id );
+      // objects not visited yet are queued by the next refresh()
+      if( gto && gto->id < _next_id )
+         push( to_entry( *gto ) );
+   }
+
+   /// the pending block was aborted, requeue what was popped for it unless is_blacklisted(trx_id)
+   template<typename Blacklisted>
+   void abort_block( Blacklisted&& is_blacklisted ) {
+      for( const auto& e : _popped ) {
+         if( !is_blacklisted( e.trx_id ) )
+            push( e );
+      }
+      _popped.clear();
+   }
+
+   /// the pending block was committed, what was popped for it is gone or blacklisted
+   void commit_block() {
+      _popped.clear();
+   }
+
+   void clear() {
+      _ready.clear();
+      _popped.clear();
+      _next_id = chain::generated_transaction_object::id_type( 0 );
+      _head_num = 0;
+      _head_id = {};
+   }
+
+   size_t size() const { return _ready.size(); }
+
+private:
+   static constexpr size_t min_rebuild_size = 1024;
+
+   static entry to_entry( const chain::generated_transaction_object& gto ) {
+      return entry{ gto.delay_until, gto.id, gto.trx_id, gto.expiration };
+   }
+
+   bool switched_forks( const chain::controller& chain ) const {
+      if( _head_num == 0 )
+         return false;
+      try {
+         return chain.head_block_num() < _head_num || chain.get_block_id_for_num( _head_num ) != _head_id;
+      } catch( const fc::exception& ) {
+         // the previous head is no longer available, e.g. the block log is not kept
+         return true;
+      }
+   }
+
+   std::set<entry>                                  _ready;
+   /// popped since the last commit_block() or abort_block()
+   std::vector<entry>                               _popped;
+   chain::generated_transaction_object::id_type     _next_id = chain::generated_transaction_object::id_type( 0 );
+   uint32_t                                         _head_num = 0;
+   chain::block_id_type                             _head_id;
+};
+
+} // namespace eosio
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <eosio/chain/exceptions.hpp>
+#include <eosio/chain/transaction.hpp>
+#include <eosio/chain/types.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace eosio {
+
+/**
+ * Admission control for incoming transactions, applied before execution. Transactions are rate limited by their
+ * first authorizer and by the contract of their first action. Both are stated by the sender, so the caller checks
+ * a transaction only once its authorizations have been verified, see controller::push_transaction's on_authorized;
+ * otherwise anyone could use up the limits of a victim account or contract.
+ *
+ * Each limit is a token bucket, kept as the theoretical arrival time of the next transaction (GCRA): a key may
+ * burst up to max_transactions at once and is then held to max_transactions per window. Buckets live in a fixed
+ * table of atomics indexed by a hash of the account, so checking and charging a bucket is a single CAS and no
+ * lock is taken. Accounts that collide in the table share a bucket; the table is large enough that this is rare.
+ */
+class transaction_admission {
+public:
+   static constexpr size_t default_table_bits = 16;
+
+   class rate_table {
+   public:
+      /// max_transactions == 0 disables the limit
+      void configure( uint32_t max_transactions, fc::microseconds window, size_t table_bits = default_table_bits ) {
+         if( max_transactions == 0 || window.count() <= 0 ) {
+            _slots.reset();
+            return;
+         }
+         _shift    = 64 - table_bits;
+         _interval = std::max<int64_t>( window.count() / max_transactions, 1 );
+         _burst    = window.count() - _interval;
+         _slots    = std::make_unique<std::atomic<int64_t>[]>( size_t(1) << table_bits );
+      }
+
+      bool enabled() const { return _slots != nullptr; }
+
+      /// thread safe; true if one more transaction of account would be admitted, nothing is charged
+      bool has_room( chain::account_name account, fc::time_point now ) const {
+         if( !_slots )
+            return true;
+         const int64_t t = now.time_since_epoch().count();
+         return std::max( slot( account ).load( std::memory_order_relaxed ), t ) - t <= _burst;
+      }
+
+      /// thread safe; charges one transaction to account and returns false if that exceeds its rate
+      bool admit( chain::account_name account, fc::time_point now ) {
+         if( !_slots )
+            return true;
+         auto& slot = this->slot( account );
+         const int64_t t = now.time_since_epoch().count();
+         int64_t tat = slot.load( std::memory_order_relaxed );
+         while( true ) {
+            const int64_t start = std::max( tat, t );
+            if( start - t > _burst )
+               return false;
+            if( slot.compare_exchange_weak( tat, start + _interval, std::memory_order_relaxed ) )
+               return true;
+         }
+      }
+
+      /// thread safe; gives back one transaction charged by admit()
+      void refund( chain::account_name account ) {
+         if( _slots )
+            slot( account ).fetch_sub( _interval, std::memory_order_relaxed );
+      }
+
+   private:
+      std::atomic<int64_t>& slot( chain::account_name account ) const {
+         return _slots[( account.to_uint64_t() * 0x9E3779B97F4A7C15ull ) >> _shift];
+      }
+
+      std::unique_ptr<std::atomic<int64_t>[]> _slots;
+      uint32_t                                _shift = 64;
+      int64_t                                 _interval = 0; ///< microseconds per transaction
+      int64_t                                 _burst = 0;    ///< how far ahead of now a bucket may be charged
+   };
+
+   void configure_authorizer_limit( uint32_t max_transactions, fc::microseconds window ) {
+      _by_authorizer.configure( max_transactions, window );
+   }
+   void configure_contract_limit( uint32_t max_transactions, fc::microseconds window ) {
+      _by_contract.configure( max_transactions, window );
+   }
+
+   bool enabled() const { return _by_authorizer.enabled() || _by_contract.enabled(); }
+
+   /**
+    * thread safe; throws tx_rate_limited if trx is over either limit, a transaction is charged to both limits or
+    * to neither. The caller has verified the authorizations of trx.
+    */
+   void check( const chain::packed_transaction& trx, fc::time_point now = fc::time_point::now() ) {
+      const auto& actions = trx.get_transaction().actions;
+      if( actions.empty() )
+         return; // rejected by validation later
+      const auto& act = actions.front();
+      const std::optional<chain::account_name> authorizer =
+            act.authorization.empty() ? std::optional<chain::account_name>{} : act.authorization.front().actor;
+
+      auto reject_by_authorizer = [&]() {
+         ++_dropped_by_authorizer;
+         EOS_THROW( chain::tx_rate_limited, "transaction rate of authorizer ${a} exceeded", ("a", *authorizer) );
+      };
+      auto reject_by_contract = [&]() {
+         ++_dropped_by_contract;
+         EOS_THROW( chain::tx_rate_limited, "transaction rate of contract ${c} exceeded", ("c", act.account) );
+      };
+
+      if( authorizer && !_by_authorizer.has_room( *authorizer, now ) )
+         reject_by_authorizer();
+      if( !_by_contract.has_room( act.account, now ) )
+         reject_by_contract();
+
+      // either bucket may have filled up on another thread since
+      if( authorizer && !_by_authorizer.admit( *authorizer, now ) )
+         reject_by_authorizer();
+      if( !_by_contract.admit( act.account, now ) ) {
+         if( authorizer )
+            _by_authorizer.refund( *authorizer );
+         reject_by_contract();
+      }
+   }
+
+   /// thread safe; gives back the charge of a trx admitted by check() that was not applied, e.g. did not fit a block
+   void refund( const chain::packed_transaction& trx ) {
+      const auto& actions = trx.get_transaction().actions;
+      if( actions.empty() )
+         return;
+      const auto& act = actions.front();
+      if( !act.authorization.empty() )
+         _by_authorizer.refund( act.authorization.front().actor );
+      _by_contract.refund( act.account );
+   }
+
+   uint64_t dropped_by_authorizer() const { return _dropped_by_authorizer.load( std::memory_order_relaxed ); }
+   uint64_t dropped_by_contract() const { return _dropped_by_contract.load( std::memory_order_relaxed ); }
+
+private:
+   rate_table             _by_authorizer;
+   rate_table             _by_contract;
+   std::atomic<uint64_t>  _dropped_by_authorizer{0};
+   std::atomic<uint64_t>  _dropped_by_contract{0};
+};
+
+} // namespace eosio
@@ -1,11 +1,19 @@
 #include <eosio/producer_plugin/producer_plugin.hpp>
 #include <eosio/producer_plugin/pending_snapshot.hpp>
+#include <eosio/producer_plugin/fair_trx_scheduler.hpp>
+#include <eosio/producer_plugin/forked_out_tapos.hpp>
+#include <eosio/producer_plugin/scheduled_trx_queue.hpp>
 #include <eosio/producer_plugin/subjective_billing.hpp>
 #include <eosio/producer_plugin/snapshot_scheduler.hpp>
+#include <eosio/producer_plugin/transaction_admission.hpp>
 #include <eosio/chain/plugin_interface.hpp>
+#include <eosio/chain/account_object.hpp>
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/generated_transaction_object.hpp>
 #include <eosio/chain/snapshot.hpp>
+#include <eosio/chain/state_commitment.hpp>
+#include <eosio/chain/table_temperature.hpp>
+#include <eosio/chain/contract_profiler.hpp>
 #include <eosio/chain/transaction_object.hpp>
 #include <eosio/chain/thread_utils.hpp>
 #include <eosio/chain/unapplied_transaction_queue.hpp>
@@ -22,6 +30,11 @@
 #include <iostream>
 #include <algorithm>
 #include <mutex>
+#include <thread>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/multi_index_container.hpp>
@@ -410,6 +423,8 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
       void produce_block();
       bool maybe_produce_block();
       bool block_is_exhausted() const;
+      uint64_t fair_scheduling_cost( const account_name& a ) const;
+      void drop_forked_out_tapos_trxs( const std::vector<block_id_type>& forked_out );
       bool remove_expired_trxs( const fc::time_point& deadline );
       bool remove_expired_blacklisted_trxs( const fc::time_point& deadline );
       bool process_unapplied_trxs( const fc::time_point& deadline );
@@ -425,7 +440,8 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
                                     const transaction_metadata_ptr& trx,
                                     bool api_trx, bool return_failure_trace,
                                     block_time_tracker::trx_time_tracker& trx_tracker,
-                                    const next_function<transaction_trace_ptr>& next );
+                                    const next_function<transaction_trace_ptr>& next,
+                                    bool admit );
       push_result handle_push_result( const transaction_metadata_ptr& trx,
                                       const next_function<transaction_trace_ptr>& next,
                                       const fc::time_point& start,
@@ -479,6 +495,7 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
       incoming::methods::transaction_async::method_type::handle _incoming_transaction_async_provider;
 
       transaction_id_with_expiry_index                         _blacklisted_transactions;
+      scheduled_trx_queue                                      _scheduled_trxs;
       pending_snapshot_index                                   _pending_snapshot_index;
       subjective_billing                                       _subjective_billing;
       account_failures                                         _account_fails{_subjective_billing};
@@ -505,13 +522,26 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
 
       // keep a expected ratio between defer txn and incoming txn
       double _incoming_defer_ratio = 1.0; // 1:1
+      bool _prevalidate_unapplied_trxs = false;
+      uint32_t _contract_profile_metrics = 10;
 
       // path to write the snapshots to
       bfs::path _snapshots_dir;
 
+      // rate limits checked on the receiving thread before a transaction enters the unapplied queue
+      transaction_admission _transaction_admission;
+
       // async snapshot scheduler
       snapshot_scheduler _snapshot_scheduler;
 
+      // write snapshots from a forked copy of the process, see start_background_snapshot
+      bool _background_snapshots = false;
+      struct background_snapshot_writer {
+         pid_t       pid;
+         std::thread waiter;
+      };
+      std::map<block_id_type, background_snapshot_writer> _background_snapshot_writers;
+
       // ro for read-only
       struct ro_trx_t {
          transaction_metadata_ptr trx;
@@ -607,11 +637,16 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
          EOS_ASSERT(chain.is_write_window(), producer_exception, "write window is expected for on_irreversible_block signal");
          _irreversible_block_time = lib->timestamp.to_time_point();
 
-         // promote any pending snapshots
+         promote_pending_snapshots(lib->block_num());
+      }
+
+      void promote_pending_snapshots(uint32_t lib_height) {
+         const chain::controller& chain = chain_plug->chain();
          auto& snapshots_by_height = _pending_snapshot_index.get<by_height>();
-         uint32_t lib_height = lib->block_num();
 
-         while (!snapshots_by_height.empty() && snapshots_by_height.begin()->get_height() <= lib_height) {
+         // a snapshot still being written in the background holds back the ones after it until it completes
+         while (!snapshots_by_height.empty() && snapshots_by_height.begin()->get_height() <= lib_height &&
+                !snapshots_by_height.begin()->in_progress) {
             const auto& pending = snapshots_by_height.begin();
             auto next = pending->next;
 
@@ -623,6 +658,123 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
          }
       }
 
+      /**
+       * Writes a snapshot of the current state to temp_path from a forked child process. The chainbase memory of the
+       * child is a copy-on-write image of this process at the fork, so this process continues applying blocks while
+       * the child serializes the frozen state. Requires a database-map-mode in which the state lives in private
+       * memory; a file mapping is shared with the child and would change underneath it.
+       *
+       * fork() copies the page tables of the whole process, stalling this thread for around 10ms per GiB of resident
+       * memory, more on some virtualized hosts. Every page this process modifies while the child runs is copied, so chainbase
+       * memory can grow up to twice its size while the snapshot is written.
+       */
+      void start_background_snapshot(const block_id_type& block_id, const bfs::path& temp_path) {
+         chain::controller& chain = chain_plug->chain();
+         const std::string temp_file = temp_path.generic_string();
+
+         pid_t pid = fork();
+         EOS_ASSERT(pid >= 0, snapshot_exception, "Unable to fork background snapshot process: ${e}", ("e", strerror(errno)));
+         if (pid == 0) {
+            // only this thread exists in the child, nothing may log or take locks other threads could have held at the fork
+            //
+            // the child inherited every descriptor of nodeos: listening and peer sockets, http connections, the block
+            // log, eos-vm-oc's compile monitor sockets... Holding them would keep ports bound and connections open
+            // after nodeos closes its copies, so close all of them before opening the snapshot file.
+            close_all_fds();
+            int rc = 1;
+            try {
+               auto snap_out = std::ofstream(temp_file, (std::ios::out | std::ios::binary));
+               auto writer = std::make_shared<ostream_snapshot_writer>(snap_out);
+               chain.write_snapshot(writer);
+               writer->finalize();
+               snap_out.flush();
+               snap_out.close();
+               rc = snap_out.fail() ? 1 : 0;
+            } catch (...) {
+            }
+            _exit(rc);
+         }
+
+         fc_ilog(_log, "Writing snapshot of block ${bn} in background process ${pid}", ("bn", block_header::num_from_id(block_id))("pid", pid));
+         std::thread waiter([pid, block_id, self = shared_from_this()]() {
+            fc::set_os_thread_name("snapshot");
+            int status = 0;
+            pid_t r;
+            while ((r = waitpid(pid, &status, 0)) < 0 && errno == EINTR) {}
+            const bool ok = r == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+            app().executor().post(priority::medium, exec_queue::read_write, [self, block_id, ok]() {
+               self->on_background_snapshot_written(block_id, ok);
+            });
+         });
+         _background_snapshot_writers.emplace(block_id, background_snapshot_writer{pid, std::move(waiter)});
+      }
+
+      // for the child of a fork, takes no locks and allocates nothing
+      static void close_all_fds() {
+#ifdef SYS_close_range
+         if (syscall(SYS_close_range, 0u, ~0u, 0u) == 0)
+            return;
+#endif
+         // kernel before 5.9
+         for (long fd = sysconf(_SC_OPEN_MAX) - 1; fd >= 0; --fd)
+            close(fd);
+      }
+
+      void on_background_snapshot_written(const block_id_type& block_id, bool ok) {
+         auto writer = _background_snapshot_writers.find(block_id);
+         if (writer == _background_snapshot_writers.end())
+            return; // shut down meanwhile
+         writer->second.waiter.join();
+         _background_snapshot_writers.erase(writer);
+
+         auto& pending_by_id = _pending_snapshot_index.get<by_id>();
+         auto pending = pending_by_id.find(block_id);
+         if (pending == pending_by_id.end())
+            return;
+
+         const auto temp_path = pending_snapshot::get_temp_path(block_id, _snapshots_dir);
+         auto next = pending->next;
+         try {
+            EOS_ASSERT(ok, snapshot_finalization_exception,
+                       "Background snapshot process for block number ${bn} failed", ("bn", pending->get_height()));
+
+            boost::system::error_code ec;
+            bfs::rename(temp_path, bfs::path(pending->pending_path), ec);
+            EOS_ASSERT(!ec, snapshot_finalization_exception,
+                  "Unable to promote temp snapshot to pending for block number ${bn}: [code: ${ec}] ${message}",
+                  ("bn", pending->get_height())
+                  ("ec", ec.value())
+                  ("message", ec.message()));
+
+            fc_ilog(_log, "Background snapshot of block ${bn} written", ("bn", pending->get_height()));
+            pending_by_id.modify(pending, [](auto& entry) { entry.in_progress = false; });
+            promote_pending_snapshots(chain_plug->chain().last_irreversible_block_num());
+            return;
+         } CATCH_AND_CALL(next);
+
+         boost::system::error_code ec;
+         bfs::remove(temp_path, ec);
+         pending_by_id.erase(pending);
+      }
+
+      void stop_background_snapshots() {
+         for (auto& [block_id, writer] : _background_snapshot_writers) {
+            kill(writer.pid, SIGKILL);
+            writer.waiter.join();
+            boost::system::error_code ec;
+            bfs::remove(pending_snapshot::get_temp_path(block_id, _snapshots_dir), ec);
+         }
+         _background_snapshot_writers.clear();
+      }
+
+      static constexpr size_t table_temperature_tables_per_block = 10'000;
+      static constexpr fc::microseconds state_residency_report_interval = fc::seconds( 60 );
+      fc::time_point _next_state_residency_report;
+      std::atomic<uint64_t> _state_resident_bytes{0};
+      std::atomic<uint64_t> _state_nonresident_bytes{0};
+      static constexpr fc::microseconds contract_profile_report_interval = fc::seconds( 10 );
+      fc::time_point _next_contract_profile_report;
+
       void update_block_metrics() {
          if (_metrics.should_post()) {
             _metrics.unapplied_transactions.value = _unapplied_transactions.size();
@@ -636,6 +788,54 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
 
             const auto& sch_idx = chain.db().get_index<generated_transaction_multi_index, by_delay>();
             _metrics.scheduled_trxs.value = sch_idx.size();
+            _metrics.trxs_rate_limited_by_authorizer.value = _transaction_admission.dropped_by_authorizer();
+            _metrics.trxs_rate_limited_by_contract.value = _transaction_admission.dropped_by_contract();
+
+            // a bounded part of the contract tables each block, table counts are updated when a walk completes
+            if( auto* temp = chain.get_table_temperature() ) {
+               if( const auto r = temp->walk_tables( chain.db(), table_temperature_tables_per_block ) ) {
+                  _metrics.hot_contract_tables.value = r->hot_tables;
+                  _metrics.cold_contract_tables.value = r->cold_tables;
+                  _metrics.hot_contract_rows.value = r->hot_rows;
+                  _metrics.cold_contract_rows.value = r->cold_rows;
+               }
+
+               // mincore over the whole state, off the main thread and not every block
+               if( fc::time_point::now() >= _next_state_residency_report ) {
+                  _next_state_residency_report = fc::time_point::now() + state_residency_report_interval;
+                  boost::asio::post( _thread_pool.get_executor(), [this, &db = chain.db()]() {
+                     const auto r = table_temperature::state_residency( db );
+                     _state_resident_bytes = r.resident_bytes;
+                     _state_nonresident_bytes = r.nonresident_bytes;
+                  } );
+               }
+               _metrics.state_resident_bytes.value = _state_resident_bytes.load();
+               _metrics.state_nonresident_bytes.value = _state_nonresident_bytes.load();
+            }
+
+            // sorts every profiled contract action, so not every block
+            if( const auto* prof = chain.get_contract_profiler();
+                prof && _contract_profile_metrics > 0 && fc::time_point::now() >= _next_contract_profile_report ) {
+               _next_contract_profile_report = fc::time_point::now() + contract_profile_report_interval;
+               // gauges, the totals go back to zero when the profile is cleared and actions leave the top
+               _metrics.contract_cpu.clear();
+               for( const auto& e : prof->top( _contract_profile_metrics ) ) {
+                  std::map<std::string, std::string> labels{ {"contract", e.contract.to_string()}, {"action", e.action.to_string()} };
+                  _metrics.contract_cpu.push_back( {metric_type::gauge, "contract_cpu_us", "contract_cpu_us", (int64_t)e.total_us, labels} );
+                  _metrics.contract_cpu.push_back( {metric_type::gauge, "contract_calls", "contract_calls", (int64_t)e.calls, std::move(labels)} );
+               }
+            }
+
+            auto update_queue_metrics = [](auto& m, const appbase::exec_pri_queue::stats& s) {
+               m.executed.value = s.executed;
+               m.expired.value = s.expired;
+               m.max_depth.value = s.max_depth;
+               m.max_wait_us.value = s.max_wait_us;
+               const uint64_t dequeued = s.executed + s.expired;
+               m.avg_wait_us.value = dequeued ? s.total_wait_us / dequeued : 0;
+            };
+            update_queue_metrics(_metrics.read_write_queue, app().executor().take_stats(exec_queue::read_write));
+            update_queue_metrics(_metrics.read_only_queue, app().executor().take_stats(exec_queue::read_only));
 
             _metrics.post_metrics();
          }
@@ -650,6 +850,8 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
          }
          _unapplied_transactions.add_aborted( chain.abort_block() );
          _subjective_billing.abort_block();
+         auto& blacklist_by_id = _blacklisted_transactions.get<by_id>();
+         _scheduled_trxs.abort_block( [&]( const transaction_id_type& id ) { return blacklist_by_id.find( id ) != blacklist_by_id.end(); } );
          _time_tracker.add_other_time();
 
          if (block_info) {
@@ -706,10 +908,15 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
          };
 
          controller::block_report br;
+         std::vector<block_id_type> forked_out;
          try {
             const block_state_ptr& bspr = bsp ? bsp : bsf.get();
-            chain.push_block( br, bspr, [this]( const branch_type& forked_branch ) {
+            chain.push_block( br, bspr, [this, &forked_out]( const branch_type& forked_branch ) {
                _unapplied_transactions.add_forked( forked_branch );
+               if( _prevalidate_unapplied_trxs ) {
+                  for( const auto& b : forked_branch )
+                     forked_out.push_back( b->id );
+               }
             }, [this]( const transaction_id_type& id ) {
                return _unapplied_transactions.get_trx( id );
             } );
@@ -730,6 +937,9 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
             handle_error(fc::std_exception_wrapper::from_current_exception(e));
          }
 
+         if( !forked_out.empty() )
+            drop_forked_out_tapos_trxs( forked_out );
+
          const auto& hbs = chain.head_block_state();
          now = fc::time_point::now();
          if( hbs->header.timestamp.next().to_time_point() >= now ) {
@@ -738,11 +948,13 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
 
          if( now - block->timestamp < fc::minutes(5) || (blk_num % 1000 == 0) ) {
             ilog("Received block ${id}... #${n} @ ${t} signed by ${p} "
-                 "[trxs: ${count}, lib: ${lib}, confirmed: ${confs}, net: ${net}, cpu: ${cpu}, elapsed: ${elapsed}, time: ${time}, latency: ${latency} ms]",
+                 "[trxs: ${count}, lib: ${lib}, confirmed: ${confs}, net: ${net}, cpu: ${cpu}, elapsed: ${elapsed}, time: ${time}, "
+                 "recover: ${recover}, recover wait: ${wait}, latency: ${latency} ms]",
                  ("p",block->producer)("id",id.str().substr(8,16))("n",blk_num)("t",block->timestamp)
                  ("count",block->transactions.size())("lib",chain.last_irreversible_block_num())
                  ("confs", block->confirmed)("net", br.total_net_usage)("cpu", br.total_cpu_usage_us)
                  ("elapsed", br.total_elapsed_time)("time", br.total_time)
+                 ("recover", br.recover_keys_time)("wait", br.recover_keys_wait_time)
                  ("latency", (now - block->timestamp).count()/1000 ) );
             if( chain.get_read_mode() != db_read_mode::IRREVERSIBLE && hbs->id != id && hbs->block != nullptr ) { // not applied to head
                ilog("Block not applied to head ${id}... #${n} @ ${t} signed by ${p} "
@@ -781,15 +993,6 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
             return;
          }
 
-         chain::controller& chain = chain_plug->chain();
-         const auto max_trx_time_ms = ( trx_type == transaction_metadata::trx_type::read_only ) ? -1 : _max_transaction_time_ms.load();
-         fc::microseconds max_trx_cpu_usage = max_trx_time_ms < 0 ? fc::microseconds::maximum() : fc::milliseconds( max_trx_time_ms );
-
-         auto future = transaction_metadata::start_recover_keys( trx, _thread_pool.get_executor(),
-                                                                 chain.get_chain_id(), fc::microseconds( max_trx_cpu_usage ),
-                                                                 trx_type,
-                                                                 chain.configured_subjective_signature_length_limit() );
-
          auto is_transient = (trx_type == transaction_metadata::trx_type::read_only || trx_type == transaction_metadata::trx_type::dry_run);
          if( !is_transient ) {
             next = [this, trx, next{std::move(next)}]( const std::variant<fc::exception_ptr, transaction_trace_ptr>& response ) {
@@ -806,6 +1009,15 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
             };
          }
 
+         chain::controller& chain = chain_plug->chain();
+         const auto max_trx_time_ms = ( trx_type == transaction_metadata::trx_type::read_only ) ? -1 : _max_transaction_time_ms.load();
+         fc::microseconds max_trx_cpu_usage = max_trx_time_ms < 0 ? fc::microseconds::maximum() : fc::milliseconds( max_trx_time_ms );
+
+         auto future = transaction_metadata::start_recover_keys( trx, _thread_pool.get_executor(),
+                                                                 chain.get_chain_id(), fc::microseconds( max_trx_cpu_usage ),
+                                                                 trx_type,
+                                                                 chain.configured_subjective_signature_length_limit() );
+
          boost::asio::post(_thread_pool.get_executor(), [self = this, future{std::move(future)}, api_trx, is_transient, return_failure_traces,
                                                           next{std::move(next)}, trx=trx]() mutable {
             if( future.valid() ) {
@@ -871,7 +1083,7 @@ class producer_plugin_impl : public std::enable_shared_from_this<producer_plugin
             }
 
             const auto block_deadline = calculate_block_deadline( chain.pending_block_time() );
-            push_result pr = push_transaction( block_deadline, trx, api_trx, return_failure_trace, trx_tracker, next );
+            push_result pr = push_transaction( block_deadline, trx, api_trx, return_failure_trace, trx_tracker, next, true );
 
             if( pr.trx_exhausted ) {
                _unapplied_transactions.add_incoming( trx, api_trx, return_failure_trace, next );
@@ -1018,6 +1230,15 @@ void producer_plugin::set_program_options(
           "ratio between incoming transactions and deferred transactions when both are queued for execution")
          ("incoming-transaction-queue-size-mb", bpo::value<uint16_t>()->default_value( 1024 ),
           "Maximum size (in MiB) of the incoming transaction queue. Exceeding this value will subjectively drop transaction with resource exhaustion.")
+         ("prevalidate-unapplied-trxs", bpo::bool_switch()->default_value(false),
+          "After a fork switch, drop queued transactions whose TaPoS references a forked out block instead of re-applying them.")
+         ("incoming-transaction-scheduling", bpo::value<string>()->default_value("fifo"),
+          "Order in which queued incoming transactions are applied:\n"
+          "fifo - in order of arrival\n"
+          "fair - round robin between first authorizers, weighted by staked CPU and recent subjective CPU billing")
+         ("contract-profile-metrics", bpo::value<uint32_t>()->default_value(my->_contract_profile_metrics),
+          "Number of contract actions with the most WASM execution time reported as contract_cpu_us and contract_calls metrics, "
+          "when chain_plugin profile-contracts is enabled. 0 disables the metrics.")
          ("disable-subjective-billing", bpo::value<bool>()->default_value(true),
           "Disable subjective CPU billing for API/P2P transactions")
          ("disable-subjective-account-billing", boost::program_options::value<vector<string>>()->composing()->multitoken(),
@@ -1028,14 +1249,33 @@ void producer_plugin::set_program_options(
           "Disable subjective CPU billing for API transactions")
          ("producer-threads", bpo::value<uint16_t>()->default_value(my->_thread_pool_size),
           "Number of worker threads in producer thread pool")
+         ("per-authorized-account-transaction-msg-rate-limit", bpo::value<uint32_t>()->default_value(0),
+          "Limits the maximum rate of incoming transactions, by first authorizer, to this many each per-authorized-account-transaction-msg-rate-limit-time-frame-sec. "
+          "Transactions are counted once their authorizations are verified, ones above the rate are rejected before execution. 0 disables the limit.")
+         ("per-authorized-account-transaction-msg-rate-limit-time-frame-sec", bpo::value<uint32_t>()->default_value(1),
+          "The time frame, in seconds, that the per-authorized-account-transaction-msg-rate-limit is imposed over.")
+         ("per-code-account-transaction-msg-rate-limit", bpo::value<uint32_t>()->default_value(0),
+          "Limits the maximum rate of incoming transactions, by contract of the first action, to this many each per-code-account-transaction-msg-rate-limit-time-frame-sec. "
+          "Transactions are counted once their authorizations are verified, ones above the rate are rejected before execution. 0 disables the limit.")
+         ("per-code-account-transaction-msg-rate-limit-time-frame-sec", bpo::value<uint32_t>()->default_value(1),
+          "The time frame, in seconds, that the per-code-account-transaction-msg-rate-limit is imposed over.")
          ("snapshots-dir", bpo::value<bfs::path>()->default_value("snapshots"),
           "the location of the snapshots directory (absolute path or relative to application data dir)")
+         ("background-snapshots", bpo::bool_switch()->default_value(false),
+          "Write snapshots from a forked copy-on-write image of the process so block processing continues meanwhile. "
+          "Requires database-map-mode heap or locked. The fork stalls the main thread while the page tables are copied "
+          "(around 10ms per GiB of resident memory), and pages modified while the snapshot is written are copied, "
+          "so chainbase memory use can grow up to double until the snapshot completes.")
          ("read-only-threads", bpo::value<uint32_t>(),
           "Number of worker threads in read-only execution thread pool. Max 8.")
          ("read-only-write-window-time-us", bpo::value<uint32_t>()->default_value(my->_ro_write_window_time_us.count()),
           "Time in microseconds the write window lasts.")
          ("read-only-read-window-time-us", bpo::value<uint32_t>()->default_value(my->_ro_read_window_time_us.count()),
           "Time in microseconds the read window lasts.")
+         ("read-only-tasks-on-app-thread", bpo::value<bool>()->default_value(true),
+          "If false, read-only tasks such as read-only API requests and read-only transactions are not executed on the app thread "
+          "during the write window; they wait for the read window and the read-only thread pool, so they never delay blocks and transactions. "
+          "Requires read-only-threads > 0.")
          ;
    config_file_options.add(producer_options);
 }
@@ -1166,7 +1406,17 @@ void producer_plugin::plugin_initialize(const boost::program_options::variables_
 
    my->_unapplied_transactions.set_max_transaction_queue_size( max_incoming_transaction_queue_size );
 
+   const auto incoming_scheduling = options.at("incoming-transaction-scheduling").as<string>();
+   EOS_ASSERT( incoming_scheduling == "fifo" || incoming_scheduling == "fair", plugin_config_exception,
+               "incoming-transaction-scheduling must be fifo or fair, not ${s}", ("s", incoming_scheduling) );
+   if( incoming_scheduling == "fair" ) {
+      my->_unapplied_transactions.set_incoming_scheduler( std::make_unique<fair_trx_scheduler>(
+            [my = my.get()]( const account_name& a ) { return my->fair_scheduling_cost( a ); } ) );
+   }
+
    my->_incoming_defer_ratio = options.at("incoming-defer-ratio").as<double>();
+   my->_prevalidate_unapplied_trxs = options.at("prevalidate-unapplied-trxs").as<bool>();
+   my->_contract_profile_metrics = options.at("contract-profile-metrics").as<uint32_t>();
 
    bool disable_subjective_billing = options.at("disable-subjective-billing").as<bool>();
    my->_disable_subjective_p2p_billing = options.at("disable-subjective-p2p-billing").as<bool>();
@@ -1211,6 +1461,18 @@ void producer_plugin::plugin_initialize(const boost::program_options::variables_
       }
    }
 
+   my->_transaction_admission.configure_authorizer_limit(
+         options.at( "per-authorized-account-transaction-msg-rate-limit" ).as<uint32_t>(),
+         fc::seconds( options.at( "per-authorized-account-transaction-msg-rate-limit-time-frame-sec" ).as<uint32_t>() ) );
+   my->_transaction_admission.configure_contract_limit(
+         options.at( "per-code-account-transaction-msg-rate-limit" ).as<uint32_t>(),
+         fc::seconds( options.at( "per-code-account-transaction-msg-rate-limit-time-frame-sec" ).as<uint32_t>() ) );
+
+   my->_background_snapshots = options.at( "background-snapshots" ).as<bool>();
+   EOS_ASSERT( !my->_background_snapshots || my->chain_plug->chain_config().db_map_mode != pinnable_mapped_file::map_mode::mapped,
+               plugin_config_exception,
+               "background-snapshots requires database-map-mode heap or locked, a mapped database file is shared with the snapshot process" );
+
    if ( options.count( "read-only-threads" ) ) {
       my->_ro_thread_pool_size = options.at( "read-only-threads" ).as<uint32_t>();
    } else if ( my->_producers.empty() ) {
@@ -1273,6 +1535,15 @@ void producer_plugin::plugin_initialize(const boost::program_options::variables_
       }
       ilog("read-only-write-window-time-us: ${ww} us, read-only-read-window-time-us: ${rw} us, effective read window time to be used: ${w} us",
            ("ww", my->_ro_write_window_time_us)("rw", my->_ro_read_window_time_us)("w", my->_ro_read_window_effective_time_us));
+
+      if ( !options.at( "read-only-tasks-on-app-thread" ).as<bool>() ) {
+         // window switching and other control tasks are posted at priority::high and must stay on the app thread
+         app().executor().set_app_thread_min_read_only_priority( priority::high );
+         ilog("read-only tasks below priority high are left to the read-only thread pool during the write window");
+      }
+   } else {
+      EOS_ASSERT( options.at( "read-only-tasks-on-app-thread" ).as<bool>(), plugin_config_exception,
+                  "read-only-tasks-on-app-thread=false requires read-only-threads > 0" );
    }
 
    // Make sure _ro_max_trx_time_us is alwasys set.
@@ -1392,6 +1663,7 @@ void producer_plugin::plugin_shutdown() {
    boost::system::error_code ec;
    my->_timer.cancel(ec);
    my->_ro_timer.cancel(ec);
+   my->stop_background_snapshots();
    app().executor().stop();
    my->_ro_thread_pool.stop();
    my->_thread_pool.stop();
@@ -1566,6 +1838,27 @@ producer_plugin::integrity_hash_information producer_plugin::get_integrity_hash(
    return {chain.head_block_id(), chain.calculate_integrity_hash()};
 }
 
+producer_plugin::state_commitment_information producer_plugin::get_state_commitment() const {
+   chain::controller& chain = my->chain_plug->chain();
+
+   auto reschedule = fc::make_scoped_exit([this](){
+      my->schedule_production_loop();
+   });
+
+   if (chain.is_building_block()) {
+      // abort the pending block, the commitment covers the state at head
+      my->abort_block();
+   } else {
+      reschedule.cancel();
+   }
+
+   const chain::state_commitment& commitment = chain.calculate_state_commitment();
+   state_commitment_information result{chain.head_block_id(), commitment.digest(), {}};
+   for (auto& [index, digest] : commitment.index_digests())
+      result.indices.push_back({std::move(index), digest});
+   return result;
+}
+
 void producer_plugin::create_snapshot(producer_plugin::next_function<producer_plugin::snapshot_information> next) {
    chain::controller& chain = my->chain_plug->chain();
 
@@ -1606,7 +1899,7 @@ void producer_plugin::create_snapshot(producer_plugin::next_function<producer_pl
    };
 
    // If in irreversible mode, create snapshot and return path to snapshot immediately.
-   if( chain.get_read_mode() == db_read_mode::IRREVERSIBLE ) {
+   if( chain.get_read_mode() == db_read_mode::IRREVERSIBLE && !my->_background_snapshots ) {
       try {
          write_snapshot( temp_path );
 
@@ -1639,6 +1932,29 @@ void producer_plugin::create_snapshot(producer_plugin::next_function<producer_pl
    } else {
       const auto& pending_path = pending_snapshot::get_pending_path(head_id, my->_snapshots_dir);
 
+      if( my->_background_snapshots ) {
+         // pending until the background process has written it, then promoted as usual once irreversible
+         try {
+            auto reschedule = fc::make_scoped_exit([this](){
+               my->schedule_production_loop();
+            });
+
+            if (chain.is_building_block()) {
+               // abort the pending block
+               my->abort_block();
+            } else {
+               reschedule.cancel();
+            }
+
+            bfs::create_directory( temp_path.parent_path() );
+            my->start_background_snapshot( head_id, temp_path );
+            auto pending = my->_pending_snapshot_index.emplace(head_id, next, pending_path.generic_string(), snapshot_path.generic_string()).first;
+            my->_pending_snapshot_index.modify(pending, [](auto& entry) { entry.in_progress = true; });
+            my->_snapshot_scheduler.add_pending_snapshot_info( producer_plugin::snapshot_information{head_id, head_block_num, head_block_time, chain_snapshot_header::current_version, pending_path.generic_string()} );
+         } CATCH_AND_CALL (next);
+         return;
+      }
+
       try {
          write_snapshot( temp_path ); // create a new pending snapshot
 
@@ -1775,6 +2091,20 @@ producer_plugin::get_account_ram_corrections( const get_account_ram_corrections_
    return result;
 }
 
+producer_plugin::get_contract_profile_result
+producer_plugin::get_contract_profile( const get_contract_profile_params& params ) const {
+   auto* prof = my->chain_plug->chain().get_contract_profiler();
+   EOS_ASSERT( prof, plugin_config_exception, "Contract profiling is disabled, enable profile-contracts" );
+
+   get_contract_profile_result result;
+   result.since = prof->since();
+   result.untracked_us = prof->untracked_us();
+   result.rows = prof->top( params.limit );
+   if( params.clear )
+      prof->clear();
+   return result;
+}
+
 producer_plugin::get_unapplied_transactions_result
 producer_plugin::get_unapplied_transactions( const get_unapplied_transactions_params& p, const fc::time_point& deadline ) const {
 
@@ -2212,6 +2542,8 @@ bool producer_plugin_impl::remove_expired_blacklisted_trxs( const fc::time_point
             exhausted = true;
             break;
          }
+         // its expired transaction is removed from the chain state once it is pushed again
+         _scheduled_trxs.release(chain.db(), blacklist_by_expiry.begin()->trx_id);
          blacklist_by_expiry.erase(blacklist_by_expiry.begin());
          num_expired++;
       }
@@ -2348,7 +2680,8 @@ producer_plugin_impl::push_transaction( const fc::time_point& block_deadline,
                                         bool api_trx,
                                         bool return_failure_trace,
                                         block_time_tracker::trx_time_tracker& trx_tracker,
-                                        const next_function<transaction_trace_ptr>& next )
+                                        const next_function<transaction_trace_ptr>& next,
+                                        bool admit )
 {
    auto start = fc::time_point::now();
    EOS_ASSERT(!trx->is_read_only(), producer_exception, "Unexpected read-only trx");
@@ -2387,7 +2720,21 @@ producer_plugin_impl::push_transaction( const fc::time_point& block_deadline,
       }
    }
 
-   auto trace = chain.push_transaction( trx, block_deadline, max_trx_time, prev_billed_cpu_time_us, false, sub_bill );
+   // The admission limits are keyed on accounts the sender names, so a transaction is charged only once the
+   // controller has verified its authorizations, before it executes. A transaction that does not fit is given its
+   // charge back, it is charged again when retried.
+   bool admitted = false;
+   std::function<void()> on_authorized;
+   if( admit && !trx->is_transient() && _transaction_admission.enabled() ) {
+      on_authorized = [&]() {
+         _transaction_admission.check( *trx->packed_trx() );
+         admitted = true;
+      };
+   }
+
+   auto trace = chain.push_transaction( trx, block_deadline, max_trx_time, prev_billed_cpu_time_us, false, sub_bill, on_authorized );
+   if( admitted && trace->except && exception_is_exhausted( *trace->except ) )
+      _transaction_admission.refund( *trx->packed_trx() );
 
    auto pr = handle_push_result(trx, next, start, chain, trace, return_failure_trace, disable_subjective_enforcement, first_auth, sub_bill, prev_billed_cpu_time_us);
 
@@ -2480,7 +2827,7 @@ bool producer_plugin_impl::process_unapplied_trxs( const fc::time_point& deadlin
          ++num_processed;
          try {
             auto trx_tracker = _time_tracker.start_trx(itr->trx_meta->is_transient());
-            push_result pr = push_transaction( deadline, itr->trx_meta, false, itr->return_failure_trace, trx_tracker, itr->next );
+            push_result pr = push_transaction( deadline, itr->trx_meta, false, itr->return_failure_trace, trx_tracker, itr->next, false );
 
             exhausted = pr.block_exhausted;
             if( exhausted ) {
@@ -2524,29 +2871,18 @@ void producer_plugin_impl::process_scheduled_and_incoming_trxs( const fc::time_p
    auto end = _unapplied_transactions.incoming_end();
    const auto& sch_idx = chain.db().get_index<generated_transaction_multi_index,by_delay>();
    const auto scheduled_trxs_size = sch_idx.size();
-   auto sch_itr = sch_idx.begin();
-   while( sch_itr != sch_idx.end() ) {
-      if( sch_itr->delay_until > pending_block_time) break;    // not scheduled yet
+   _scheduled_trxs.refresh( chain, [&]( const transaction_id_type& id ) { return blacklist_by_id.find( id ) != blacklist_by_id.end(); } );
+   // popped but neither executed nor blacklisted, e.g. because of a subjective failure, queued again for the next block
+   std::vector<scheduled_trx_queue::entry> not_processed;
+   while( auto sch = _scheduled_trxs.pop_due( chain.db(), pending_block_time ) ) {
+      not_processed.push_back( *sch );
       if( exhausted || deadline <= fc::time_point::now() ) {
          exhausted = true;
          break;
       }
-      if( sch_itr->published >= pending_block_time ) {
-         ++sch_itr;
-         continue; // do not allow schedule and execute in same block
-      }
 
-      if (blacklist_by_id.find(sch_itr->trx_id) != blacklist_by_id.end()) {
-         ++sch_itr;
-         continue;
-      }
-
-      const transaction_id_type trx_id = sch_itr->trx_id; // make copy since reference could be invalidated
-      const auto sch_expiration = sch_itr->expiration;
-      auto sch_itr_next = sch_itr; // save off next since sch_itr may be invalidated by loop
-      ++sch_itr_next;
-      const auto next_delay_until = sch_itr_next != sch_idx.end() ? sch_itr_next->delay_until : sch_itr->delay_until;
-      const auto next_id = sch_itr_next != sch_idx.end() ? sch_itr_next->id : sch_itr->id;
+      const transaction_id_type trx_id = sch->trx_id;
+      const auto sch_expiration = sch->expiration;
 
       num_processed++;
 
@@ -2563,7 +2899,7 @@ void producer_plugin_impl::process_scheduled_and_incoming_trxs( const fc::time_p
          bool api_trx = itr->trx_type == trx_enum_type::incoming_api;
 
          auto trx_tracker = _time_tracker.start_trx(trx_meta->is_transient());
-         push_result pr = push_transaction( deadline, trx_meta, api_trx, itr->return_failure_trace, trx_tracker, itr->next );
+         push_result pr = push_transaction( deadline, trx_meta, api_trx, itr->return_failure_trace, trx_tracker, itr->next, true );
 
          exhausted = pr.block_exhausted;
          if( pr.trx_exhausted ) {
@@ -2613,6 +2949,7 @@ void producer_plugin_impl::process_scheduled_and_incoming_trxs( const fc::time_p
                        ("entire_trace", chain_plug->get_log_trx_trace(trace)));
                // this failed our configured maximum transaction time, we don't want to replay it add it to a blacklist
                _blacklisted_transactions.insert(transaction_id_with_expiry{trx_id, sch_expiration});
+               not_processed.pop_back();
                num_failed++;
             }
          } else {
@@ -2625,16 +2962,17 @@ void producer_plugin_impl::process_scheduled_and_incoming_trxs( const fc::time_p
             fc_dlog(_trx_trace_success_log, "[TRX_TRACE] Block ${block_num} for producer ${prod} is ACCEPTING scheduled tx: ${entire_trace}",
                     ("block_num", chain.head_block_num() + 1)("prod", get_pending_block_producer())
                     ("entire_trace", chain_plug->get_log_trx_trace(trace)));
+            not_processed.pop_back();
             num_applied++;
          }
       } LOG_AND_DROP();
 
       incoming_trx_weight += _incoming_defer_ratio;
-
-      if( sch_itr_next == sch_idx.end() ) break;
-      sch_itr = sch_idx.lower_bound( boost::make_tuple( next_delay_until, next_id ) );
    }
 
+   for( const auto& e : not_processed )
+      _scheduled_trxs.push( e );
+
    if( scheduled_trxs_size > 0 ) {
       fc_dlog( _log,
                "Processed ${m} of ${n} scheduled transactions, Applied ${applied}, Failed/Dropped ${failed}",
@@ -2661,7 +2999,7 @@ bool producer_plugin_impl::process_incoming_trxs( const fc::time_point& deadline
          bool api_trx = itr->trx_type == trx_enum_type::incoming_api;
 
          auto trx_tracker = _time_tracker.start_trx(trx_meta->is_transient());
-         push_result pr = push_transaction( deadline, trx_meta, api_trx, itr->return_failure_trace, trx_tracker, itr->next );
+         push_result pr = push_transaction( deadline, trx_meta, api_trx, itr->return_failure_trace, trx_tracker, itr->next, true );
 
          exhausted = pr.block_exhausted;
          if( pr.trx_exhausted ) {
@@ -2678,6 +3016,44 @@ bool producer_plugin_impl::process_incoming_trxs( const fc::time_point& deadline
    return !exhausted;
 }
 
+// Drops queued transactions referencing forked out blocks, see eosio::drop_forked_out_tapos_trxs
+void producer_plugin_impl::drop_forked_out_tapos_trxs( const std::vector<block_id_type>& forked_out ) {
+   const size_t dropped = eosio::drop_forked_out_tapos_trxs( _unapplied_transactions, chain_plug->chain(), forked_out,
+      [this]( const unapplied_transaction& ut, const block_id_type& ref_block ) {
+         fc_dlog( _trx_failed_trace_log, "[TRX_TRACE] Dropping tx: ${txid}, auth: ${a}, reference block ${b} was forked out",
+                  ("txid", ut.id())("a", ut.trx_meta->packed_trx()->get_transaction().first_authorizer())("b", ref_block) );
+         if( ut.next ) {
+            ut.next( std::static_pointer_cast<fc::exception>( std::make_shared<invalid_ref_block_exception>(
+                  FC_LOG_MESSAGE( error, "transaction ${id} reference block ${b} was forked out", ("id", ut.id())("b", ref_block) ) ) ) );
+         }
+      } );
+   if( dropped > 0 )
+      fc_dlog( _log, "Dropped ${n} queued transactions referencing forked out blocks", ("n", dropped) );
+}
+
+// Virtual time an incoming transaction of account a costs under fair scheduling: the cpu subjectively billed to the
+// account recently, divided by its share of staked cpu. Unknown accounts get the largest cost.
+uint64_t producer_plugin_impl::fair_scheduling_cost( const account_name& a ) const {
+   constexpr uint64_t base_cost_us = 100;
+   constexpr uint64_t stake_resolution = 1000; // an account staking 1/stake_resolution of all cpu weighs double
+
+   const chain::controller& chain = chain_plug->chain();
+   const uint64_t cost = base_cost_us + std::max<int64_t>( _subjective_billing.get_subjective_bill( a, fc::time_point::now() ), 0 );
+   if( !chain.db().find<account_object, by_name>( a ) )
+      return cost * stake_resolution;
+
+   const auto& rl = chain.get_resource_limits_manager();
+   int64_t ram_bytes = 0, net_weight = 0, cpu_weight = 0;
+   rl.get_account_limits( a, ram_bytes, net_weight, cpu_weight );
+   const uint64_t total_cpu_weight = rl.get_total_cpu_weight();
+   uint64_t weight = 1;
+   if( cpu_weight < 0 ) // unlimited
+      weight += stake_resolution;
+   else if( cpu_weight > 0 && total_cpu_weight > 0 )
+      weight += static_cast<uint64_t>( (uint128_t)cpu_weight * stake_resolution / total_cpu_weight );
+   return cost * stake_resolution / weight;
+}
+
 bool producer_plugin_impl::block_is_exhausted() const {
    const chain::controller& chain = chain_plug->chain();
    const auto& rl = chain.get_resource_limits_manager();
@@ -2886,6 +3262,7 @@ void producer_plugin_impl::produce_block() {
    } );
 
    chain.commit_block();
+   _scheduled_trxs.commit_block();
 
    block_state_ptr new_bs = chain.head_block_state();
 
@@ -0,0 +1,81 @@
+#define BOOST_TEST_MODULE background_snapshot
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/chain/exceptions.hpp>
+#include <eosio/chain/snapshot.hpp>
+#include <eosio/producer_plugin/producer_plugin.hpp>
+#include <eosio/testing/tester.hpp>
+
+#include <fstream>
+
+namespace {
+
+using namespace eosio;
+using namespace eosio::chain;
+
+BOOST_AUTO_TEST_SUITE(background_snapshot_test)
+
+BOOST_AUTO_TEST_CASE(background_snapshot_test) {
+   boost::filesystem::path temp = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+   try {
+      std::promise<std::tuple<producer_plugin*, chain_plugin*>> plugin_promise;
+      std::future<std::tuple<producer_plugin*, chain_plugin*>> plugin_fut = plugin_promise.get_future();
+
+      std::thread app_thread([&]() {
+         fc::logger::get(DEFAULT_LOGGER).set_log_level(fc::log_level::debug);
+         std::vector<const char*> argv =
+               {"test", "--data-dir", temp.c_str(), "--config-dir", temp.c_str(),
+                "-p", "eosio", "-e", "--disable-subjective-billing=true",
+                "--database-map-mode", "heap", "--background-snapshots"};
+         appbase::app().initialize<chain_plugin, producer_plugin>(argv.size(), (char**) &argv[0]);
+         appbase::app().startup();
+         plugin_promise.set_value(
+               {appbase::app().find_plugin<producer_plugin>(), appbase::app().find_plugin<chain_plugin>()});
+         appbase::app().exec();
+      });
+
+      auto [prod_plug, chain_plug] = plugin_fut.get();
+
+      std::promise<void> started_promise;
+      auto ab = chain_plug->chain().accepted_block.connect([&, set = false](const block_state_ptr& bsp) mutable {
+         if(!set && bsp->block_num >= 5) {
+            set = true;
+            started_promise.set_value();
+         }
+      });
+      BOOST_REQUIRE(started_promise.get_future().wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+
+      // the snapshot is written by a forked process and reported once its block is irreversible
+      using result_t = std::variant<fc::exception_ptr, producer_plugin::snapshot_information>;
+      std::promise<result_t> result_promise;
+      std::future<result_t> result_fut = result_promise.get_future();
+      appbase::app().executor().post(appbase::priority::medium, appbase::exec_queue::read_write, [&, prod_plug=prod_plug]() {
+         prod_plug->create_snapshot([&](const result_t& r) { result_promise.set_value(r); });
+      });
+      BOOST_REQUIRE(result_fut.wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+
+      auto result = result_fut.get();
+      if(std::holds_alternative<fc::exception_ptr>(result))
+         BOOST_FAIL(std::get<fc::exception_ptr>(result)->to_detail_string());
+      const auto& info = std::get<producer_plugin::snapshot_information>(result);
+      BOOST_CHECK_GT(info.head_block_num, 0u);
+      BOOST_REQUIRE(fc::exists(info.snapshot_name));
+
+      // the snapshot is complete and for the reported block
+      std::ifstream infile(info.snapshot_name, std::ios::in | std::ios::binary);
+      istream_snapshot_reader reader(infile);
+      reader.validate();
+      BOOST_CHECK_EQUAL(controller::extract_chain_id(reader), chain_plug->chain().get_chain_id());
+
+      appbase::app().quit();
+      app_thread.join();
+   } catch(...) {
+      bfs::remove_all(temp);
+      throw;
+   }
+   bfs::remove_all(temp);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}// namespace
@@ -0,0 +1,133 @@
+#define BOOST_TEST_MODULE fair_trx_scheduler
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/producer_plugin/fair_trx_scheduler.hpp>
+
+#include <eosio/testing/tester.hpp>
+
+namespace {
+
+using namespace eosio;
+using namespace eosio::chain;
+
+transaction_metadata_ptr make_trx( account_name authorizer ) {
+   static uint64_t nextid = 0;
+   ++nextid;
+
+   signed_transaction trx;
+   trx.expiration = fc::time_point_sec{fc::time_point::now() + fc::seconds( 120 )};
+   trx.actions.emplace_back( vector<permission_level>{{authorizer, config::active_name}},
+                             onerror{ nextid, "test", 4 } );
+   return transaction_metadata::create_no_recover_keys( std::make_shared<packed_transaction>( std::move( trx ) ),
+                                                        transaction_metadata::trx_type::input );
+}
+
+// processes the next incoming transaction as the producer does
+account_name next( unapplied_transaction_queue& q ) {
+   auto itr = q.incoming_begin();
+   if( itr == q.incoming_end() )
+      return {};
+   auto a = itr->trx_meta->packed_trx()->get_transaction().first_authorizer();
+   q.erase( itr );
+   return a;
+}
+
+BOOST_AUTO_TEST_SUITE( fair_trx_scheduler_test )
+
+BOOST_AUTO_TEST_CASE( fifo_without_scheduler ) {
+   unapplied_transaction_queue q;
+   q.add_incoming( make_trx( "alice"_n ), false, false, {} );
+   q.add_incoming( make_trx( "alice"_n ), false, false, {} );
+   q.add_incoming( make_trx( "bob"_n ), false, false, {} );
+
+   BOOST_CHECK_EQUAL( next( q ), "alice"_n );
+   BOOST_CHECK_EQUAL( next( q ), "alice"_n );
+   BOOST_CHECK_EQUAL( next( q ), "bob"_n );
+   BOOST_CHECK( q.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( round_robin_between_accounts ) {
+   unapplied_transaction_queue q;
+   q.set_incoming_scheduler( std::make_unique<fair_trx_scheduler>( []( const account_name& ) { return 1; } ) );
+
+   // alice floods the queue before bob and carol send anything
+   for( int i = 0; i < 5; ++i )
+      q.add_incoming( make_trx( "alice"_n ), false, false, {} );
+   q.add_incoming( make_trx( "bob"_n ), false, false, {} );
+   q.add_incoming( make_trx( "bob"_n ), false, false, {} );
+   q.add_incoming( make_trx( "carol"_n ), false, false, {} );
+   BOOST_CHECK_EQUAL( q.incoming_size(), 8u );
+
+   BOOST_CHECK_EQUAL( next( q ), "alice"_n );
+   BOOST_CHECK_EQUAL( next( q ), "bob"_n );
+   BOOST_CHECK_EQUAL( next( q ), "carol"_n );
+   BOOST_CHECK_EQUAL( next( q ), "alice"_n );
+   BOOST_CHECK_EQUAL( next( q ), "bob"_n );
+
+   // a late arrival does not queue behind alice's backlog
+   q.add_incoming( make_trx( "dave"_n ), false, false, {} );
+   BOOST_CHECK_EQUAL( next( q ), "dave"_n );
+   BOOST_CHECK_EQUAL( next( q ), "alice"_n );
+   BOOST_CHECK_EQUAL( next( q ), "alice"_n );
+   BOOST_CHECK_EQUAL( next( q ), "alice"_n );
+   BOOST_CHECK( next( q ) == account_name{} );
+   BOOST_CHECK( q.empty() );
+}
+
+BOOST_AUTO_TEST_CASE( weighted_by_cost ) {
+   unapplied_transaction_queue q;
+   // bob's transactions cost a third of alice's, e.g. three times the stake
+   q.set_incoming_scheduler( std::make_unique<fair_trx_scheduler>( []( const account_name& a ) {
+      return a == "bob"_n ? 1 : 3;
+   } ) );
+
+   for( int i = 0; i < 4; ++i )
+      q.add_incoming( make_trx( "alice"_n ), false, false, {} );
+   for( int i = 0; i < 8; ++i )
+      q.add_incoming( make_trx( "bob"_n ), false, false, {} );
+
+   std::map<account_name, int> served;
+   for( int i = 0; i < 8; ++i )
+      ++served[next( q )];
+   BOOST_CHECK_EQUAL( served["alice"_n], 2 );
+   BOOST_CHECK_EQUAL( served["bob"_n], 6 );
+}
+
+BOOST_AUTO_TEST_CASE( api_before_p2p_and_unapplied_first ) {
+   unapplied_transaction_queue q;
+   q.set_incoming_scheduler( std::make_unique<fair_trx_scheduler>( []( const account_name& ) { return 1; } ) );
+
+   auto p2p = make_trx( "alice"_n );
+   auto api = make_trx( "alice"_n );
+   auto aborted = make_trx( "bob"_n );
+   q.add_incoming( p2p, false, false, {} );
+   q.add_incoming( api, true, false, {} );
+   q.add_aborted( { aborted } );
+
+   BOOST_CHECK( q.begin()->trx_meta == aborted );
+   BOOST_CHECK( q.unapplied_begin()->trx_meta == aborted );
+   BOOST_CHECK( q.incoming_begin()->trx_meta == api );
+   BOOST_CHECK_EQUAL( std::distance( q.incoming_begin(), q.incoming_end() ), 2 );
+
+   BOOST_CHECK_THROW( q.set_incoming_scheduler( {} ), misc_exception );
+}
+
+BOOST_AUTO_TEST_CASE( prunes_idle_accounts ) {
+   fair_trx_scheduler s( []( const account_name& ) { return 1; } );
+
+   for( uint64_t i = 0; i < fair_trx_scheduler::min_prune_size - 1; ++i ) {
+      auto trx = make_trx( name( i + 1 ) );
+      s.processed( s.schedule( *trx ) );
+   }
+   BOOST_CHECK_EQUAL( s.tracked_accounts(), fair_trx_scheduler::min_prune_size - 1 );
+
+   // every account is back at the queue's virtual time, so all but the newest are dropped
+   s.processed( s.virtual_time() + 1 );
+   auto trx = make_trx( "alice"_n );
+   s.schedule( *trx );
+   BOOST_CHECK_EQUAL( s.tracked_accounts(), 1u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace
@@ -0,0 +1,91 @@
+#define BOOST_TEST_MODULE forked_out_tapos
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/producer_plugin/forked_out_tapos.hpp>
+
+#include <eosio/testing/tester.hpp>
+
+namespace {
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+transaction_metadata_ptr make_trx( const block_id_type& ref_block ) {
+   static uint64_t nextid = 0;
+   ++nextid;
+
+   signed_transaction trx;
+   trx.expiration = fc::time_point_sec{fc::time_point::now() + fc::seconds( 120 )};
+   trx.set_reference_block( ref_block );
+   trx.actions.emplace_back( vector<permission_level>{{"alice"_n, config::active_name}},
+                             onerror{ nextid, "test", 4 } );
+   return transaction_metadata::create_no_recover_keys( std::make_shared<packed_transaction>( std::move( trx ) ),
+                                                        transaction_metadata::trx_type::input );
+}
+
+void push_blocks( tester& from, tester& to, uint32_t first_block_num ) {
+   for( uint32_t n = first_block_num; n <= from.control->head_block_num(); ++n )
+      to.push_block( from.control->fetch_block_by_number( n ) );
+}
+
+std::set<transaction_id_type> queued( unapplied_transaction_queue& q ) {
+   std::set<transaction_id_type> ids;
+   for( auto itr = q.begin(); itr != q.end(); ++itr )
+      ids.insert( itr->id() );
+   return ids;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(forked_out_tapos_test)
+
+BOOST_AUTO_TEST_CASE(drop_trxs_of_forked_out_blocks) { try {
+   tester c;
+   tester c2( setup_policy::none );
+   push_blocks( c, c2, c2.control->head_block_num() + 1 );
+   const uint32_t fork_base_num = c.control->head_block_num();
+   const auto fork_base = c.control->head_block_id();
+
+   // c produces a block that the longer fork of c2 replaces
+   c.create_account( "alice"_n );
+   c.produce_block();
+   const auto forked_out = c.control->head_block_id();
+   c2.create_account( "bob"_n );
+   c2.produce_blocks( 2 );
+   const auto replacement = c2.control->fetch_block_by_number( fork_base_num + 1 )->calculate_id();
+   BOOST_REQUIRE( forked_out != replacement );
+
+   unapplied_transaction_queue q;
+   const auto stale = make_trx( forked_out );
+   const auto stale_aborted = make_trx( forked_out );
+   const auto on_base = make_trx( fork_base );
+   const auto on_replacement = make_trx( replacement ); // same ref_block_num as the stale ones
+   q.add_incoming( stale, false, false, {} );
+   q.add_aborted( { stale_aborted } );
+   q.add_incoming( on_base, false, false, {} );
+   q.add_incoming( on_replacement, false, false, {} );
+   BOOST_REQUIRE_EQUAL( q.size(), 4u );
+
+   std::vector<transaction_id_type> dropped;
+   auto on_drop = [&]( const unapplied_transaction& ut, const block_id_type& ref_block ) {
+      BOOST_CHECK( ref_block == forked_out );
+      dropped.push_back( ut.id() );
+   };
+
+   // still the head of c, nothing to drop
+   BOOST_CHECK_EQUAL( drop_forked_out_tapos_trxs( q, *c.control, { forked_out }, on_drop ), 0u );
+   BOOST_CHECK_EQUAL( q.size(), 4u );
+
+   push_blocks( c2, c, fork_base_num + 1 );
+   BOOST_REQUIRE_EQUAL( c.control->head_block_id(), c2.control->head_block_id() );
+
+   // blocks back on the branch of the new head are ignored
+   BOOST_CHECK_EQUAL( drop_forked_out_tapos_trxs( q, *c.control, { fork_base, forked_out }, on_drop ), 2u );
+   BOOST_CHECK_EQUAL( dropped.size(), 2u );
+   BOOST_CHECK( std::find( dropped.begin(), dropped.end(), stale->id() ) != dropped.end() );
+   BOOST_CHECK( std::find( dropped.begin(), dropped.end(), stale_aborted->id() ) != dropped.end() );
+   BOOST_CHECK( queued( q ) == std::set<transaction_id_type>( { on_base->id(), on_replacement->id() } ) );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
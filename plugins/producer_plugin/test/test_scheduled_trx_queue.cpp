@@ -0,0 +1,135 @@
+#define BOOST_TEST_MODULE scheduled_trx_queue
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/producer_plugin/scheduled_trx_queue.hpp>
+
+#include <eosio/testing/tester.hpp>
+
+namespace {
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+auto never_blacklisted = []( const transaction_id_type& ) { return false; };
+
+transaction_id_type push_delayed( tester& chain, name permission, uint32_t delay_sec ) {
+   auto trace = chain.push_action( config::system_account_name, updateauth::get_name(), "alice"_n, fc::mutable_variant_object()
+         ("account", "alice")
+         ("permission", permission)
+         ("parent", "active")
+         ("auth", authority( chain.get_public_key( "alice"_n, permission.to_string() ), 1 )),
+         30, delay_sec );
+   BOOST_REQUIRE_EQUAL( transaction_receipt::delayed, trace->receipt->status );
+   return trace->id;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(scheduled_trx_queue_test)
+
+BOOST_AUTO_TEST_CASE(scheduled_trx_queue_refresh) { try {
+   tester chain;
+   chain.create_account( "alice"_n );
+   chain.produce_block();
+
+   const auto& db = chain.control->db();
+   scheduled_trx_queue q;
+
+   const auto first = push_delayed( chain, "first"_n, 1 );
+   const auto second = push_delayed( chain, "second"_n, 20 );
+   // published in the pending block, left for the next refresh
+   q.refresh( *chain.control, never_blacklisted );
+   BOOST_CHECK_EQUAL( q.size(), 0u );
+
+   chain.produce_block();
+   q.refresh( *chain.control, never_blacklisted );
+   BOOST_CHECK_EQUAL( q.size(), 2u );
+   BOOST_CHECK( !q.pop_due( db, chain.control->pending_block_time() ) );
+
+   // refreshing again does not queue them twice
+   q.refresh( *chain.control, never_blacklisted );
+   BOOST_CHECK_EQUAL( q.size(), 2u );
+
+   // the tester executes due scheduled transactions itself, so the first is gone by the time it is due
+   chain.produce_blocks( 4 );
+   BOOST_REQUIRE( !db.find<generated_transaction_object, by_trx_id>( first ) );
+   q.refresh( *chain.control, never_blacklisted );
+   BOOST_CHECK( !q.pop_due( db, chain.control->pending_block_time() ) );
+   BOOST_CHECK_EQUAL( q.size(), 1u );
+
+   const auto later = chain.control->pending_block_time() + fc::seconds( 30 );
+   auto e = q.pop_due( db, later );
+   BOOST_REQUIRE( e );
+   BOOST_CHECK( e->trx_id == second );
+   BOOST_CHECK_EQUAL( q.size(), 0u );
+   q.push( *e );
+   BOOST_CHECK_EQUAL( q.size(), 1u );
+
+   // blacklisted transactions are skipped until released
+   const auto third = push_delayed( chain, "third"_n, 1 );
+   chain.produce_block();
+   q.refresh( *chain.control, [&]( const transaction_id_type& id ) { return id == third; } );
+   BOOST_CHECK_EQUAL( q.size(), 1u );
+   q.release( db, third );
+   BOOST_CHECK_EQUAL( q.size(), 2u );
+
+   std::vector<transaction_id_type> popped;
+   while( auto p = q.pop_due( db, later ) )
+      popped.push_back( p->trx_id );
+   BOOST_REQUIRE_EQUAL( popped.size(), 2u );
+   // ordered by delay
+   BOOST_CHECK( popped[0] == third );
+   BOOST_CHECK( popped[1] == second );
+
+   q.clear();
+   q.refresh( *chain.control, never_blacklisted );
+   BOOST_CHECK_EQUAL( q.size(), 2u );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE(scheduled_trx_queue_abort_block) { try {
+   tester chain;
+   chain.create_account( "alice"_n );
+   chain.produce_block();
+
+   const auto& db = chain.control->db();
+   scheduled_trx_queue q;
+
+   const auto trx_id = push_delayed( chain, "first"_n, 1 );
+   chain.produce_block();
+   // the pending block is the one the transaction is due in, the tester only executes it when producing the block
+   chain.produce_block();
+   q.refresh( *chain.control, never_blacklisted );
+   const auto due = chain.control->pending_block_time();
+   auto e = q.pop_due( db, due );
+   BOOST_REQUIRE( e );
+   BOOST_CHECK( e->trx_id == trx_id );
+
+   auto trace = chain.control->push_scheduled_transaction( trx_id, fc::time_point::maximum(), fc::microseconds::maximum(), 0, false );
+   BOOST_REQUIRE( !trace->except );
+   BOOST_REQUIRE( !db.find<generated_transaction_object, by_trx_id>( trx_id ) );
+   BOOST_CHECK( !q.pop_due( db, due ) );
+
+   // aborting the block restores the transaction, which must become due again
+   chain.control->abort_block();
+   q.abort_block( never_blacklisted );
+   BOOST_REQUIRE( db.find<generated_transaction_object, by_trx_id>( trx_id ) );
+   e = q.pop_due( db, due );
+   BOOST_REQUIRE( e );
+   BOOST_CHECK( e->trx_id == trx_id );
+
+   // unless it was blacklisted
+   chain.control->abort_block();
+   q.abort_block( [&]( const transaction_id_type& id ) { return id == trx_id; } );
+   BOOST_CHECK( !q.pop_due( db, due ) );
+
+   // once the block with it is committed it is not requeued
+   q.release( db, trx_id );
+   e = q.pop_due( db, due );
+   BOOST_REQUIRE( e );
+   q.commit_block();
+   q.abort_block( never_blacklisted );
+   BOOST_CHECK_EQUAL( q.size(), 0u );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,202 @@
+#define BOOST_TEST_MODULE transaction_admission
+#include <boost/test/included/unit_test.hpp>
+
+#include <eosio/producer_plugin/transaction_admission.hpp>
+
+#include <eosio/testing/tester.hpp>
+
+#include <thread>
+
+namespace {
+
+using namespace eosio;
+using namespace eosio::chain;
+
+packed_transaction make_trx( account_name contract, account_name authorizer, uint32_t nonce ) {
+   signed_transaction trx;
+   trx.expiration = fc::time_point_sec{fc::time_point::now() + fc::seconds( 30 )};
+   trx.actions.emplace_back( vector<permission_level>{{authorizer, config::active_name}}, contract, "nonce"_n,
+                             fc::raw::pack( nonce ) );
+   return packed_transaction( std::move( trx ) );
+}
+
+BOOST_AUTO_TEST_SUITE( transaction_admission_test )
+
+BOOST_AUTO_TEST_CASE( rate_table_burst_and_refill ) {
+   transaction_admission::rate_table table;
+   const account_name a = "alice"_n;
+   const auto now = fc::time_point::now();
+
+   BOOST_CHECK( !table.enabled() );
+   for( int i = 0; i < 100; ++i )
+      BOOST_CHECK( table.admit( a, now ) );
+
+   table.configure( 3, fc::seconds( 1 ) );
+   BOOST_CHECK( table.enabled() );
+
+   // full burst at once, then nothing until the bucket refills
+   BOOST_CHECK( table.admit( a, now ) );
+   BOOST_CHECK( table.admit( a, now ) );
+   BOOST_CHECK( table.admit( a, now ) );
+   BOOST_CHECK( !table.admit( a, now ) );
+   BOOST_CHECK( !table.admit( a, now + fc::milliseconds( 100 ) ) );
+
+   // one more every third of a second
+   BOOST_CHECK( table.admit( a, now + fc::milliseconds( 334 ) ) );
+   BOOST_CHECK( !table.admit( a, now + fc::milliseconds( 334 ) ) );
+
+   // other accounts are unaffected
+   BOOST_CHECK( table.admit( "bob"_n, now ) );
+
+   // an idle account gets its full burst back, not more
+   const auto later = now + fc::seconds( 10 );
+   BOOST_CHECK( table.admit( a, later ) );
+   BOOST_CHECK( table.admit( a, later ) );
+   BOOST_CHECK( table.admit( a, later ) );
+   BOOST_CHECK( !table.admit( a, later ) );
+
+   table.configure( 0, fc::seconds( 1 ) );
+   BOOST_CHECK( !table.enabled() );
+   BOOST_CHECK( table.admit( a, now ) );
+}
+
+BOOST_AUTO_TEST_CASE( rate_table_concurrent ) {
+   transaction_admission::rate_table table;
+   table.configure( 1000, fc::seconds( 1000 ) );
+   const auto now = fc::time_point::now();
+
+   std::atomic<uint32_t> admitted{0};
+   std::vector<std::thread> threads;
+   for( int t = 0; t < 4; ++t ) {
+      threads.emplace_back( [&]() {
+         for( int i = 0; i < 1000; ++i ) {
+            if( table.admit( "alice"_n, now ) )
+               ++admitted;
+         }
+      } );
+   }
+   for( auto& t : threads )
+      t.join();
+
+   // no charge is lost or doubled under contention
+   BOOST_CHECK_EQUAL( admitted.load(), 1000u );
+}
+
+BOOST_AUTO_TEST_CASE( check_rejects_by_authorizer_and_contract ) {
+   const auto now = fc::time_point::now();
+
+   {
+      transaction_admission admission;
+      BOOST_CHECK( !admission.enabled() );
+      admission.check( make_trx( "token"_n, "alice"_n, 0 ), now );
+
+      admission.configure_authorizer_limit( 2, fc::seconds( 1 ) );
+      BOOST_CHECK( admission.enabled() );
+      admission.check( make_trx( "token"_n, "alice"_n, 1 ), now );
+      admission.check( make_trx( "other"_n, "alice"_n, 2 ), now );
+      BOOST_CHECK_THROW( admission.check( make_trx( "token"_n, "alice"_n, 3 ), now ), tx_rate_limited );
+      admission.check( make_trx( "token"_n, "bob"_n, 4 ), now );
+      BOOST_CHECK_EQUAL( admission.dropped_by_authorizer(), 1u );
+      BOOST_CHECK_EQUAL( admission.dropped_by_contract(), 0u );
+   }
+   {
+      transaction_admission admission;
+      admission.configure_contract_limit( 2, fc::seconds( 1 ) );
+      admission.check( make_trx( "token"_n, "alice"_n, 1 ), now );
+      admission.check( make_trx( "token"_n, "bob"_n, 2 ), now );
+      BOOST_CHECK_THROW( admission.check( make_trx( "token"_n, "carol"_n, 3 ), now ), tx_rate_limited );
+      admission.check( make_trx( "other"_n, "carol"_n, 4 ), now );
+      BOOST_CHECK_EQUAL( admission.dropped_by_authorizer(), 0u );
+      BOOST_CHECK_EQUAL( admission.dropped_by_contract(), 1u );
+
+      // refilled after the window
+      admission.check( make_trx( "token"_n, "carol"_n, 5 ), now + fc::seconds( 1 ) );
+   }
+   {
+      // a transaction rejected by one limit is not charged to the other
+      transaction_admission admission;
+      admission.configure_authorizer_limit( 2, fc::seconds( 1 ) );
+      admission.configure_contract_limit( 1, fc::seconds( 1 ) );
+      admission.check( make_trx( "token"_n, "alice"_n, 1 ), now );
+      BOOST_CHECK_THROW( admission.check( make_trx( "token"_n, "alice"_n, 2 ), now ), tx_rate_limited );
+      BOOST_CHECK_THROW( admission.check( make_trx( "token"_n, "alice"_n, 3 ), now ), tx_rate_limited );
+      BOOST_CHECK_EQUAL( admission.dropped_by_contract(), 2u );
+      admission.check( make_trx( "other"_n, "alice"_n, 4 ), now );
+      BOOST_CHECK_THROW( admission.check( make_trx( "other"_n, "alice"_n, 5 ), now ), tx_rate_limited );
+      BOOST_CHECK_EQUAL( admission.dropped_by_authorizer(), 1u );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( rate_table_has_room_and_refund ) {
+   transaction_admission::rate_table table;
+   table.configure( 2, fc::seconds( 1 ) );
+   const account_name a = "alice"_n;
+   const auto now = fc::time_point::now();
+
+   BOOST_CHECK( table.has_room( a, now ) );
+   BOOST_CHECK( table.admit( a, now ) );
+   BOOST_CHECK( table.admit( a, now ) );
+   BOOST_CHECK( !table.has_room( a, now ) );
+   table.refund( a );
+   BOOST_CHECK( table.has_room( a, now ) );
+   BOOST_CHECK( table.admit( a, now ) );
+   BOOST_CHECK( !table.admit( a, now ) );
+}
+
+BOOST_AUTO_TEST_CASE( refund_gives_back_both_limits ) {
+   transaction_admission admission;
+   admission.configure_authorizer_limit( 1, fc::seconds( 1 ) );
+   admission.configure_contract_limit( 1, fc::seconds( 1 ) );
+   const auto now = fc::time_point::now();
+
+   admission.check( make_trx( "token"_n, "alice"_n, 1 ), now );
+   BOOST_CHECK_THROW( admission.check( make_trx( "token"_n, "alice"_n, 2 ), now ), tx_rate_limited );
+   admission.refund( make_trx( "token"_n, "alice"_n, 1 ) );
+   admission.check( make_trx( "token"_n, "alice"_n, 3 ), now );
+}
+
+// admission is charged from controller::push_transaction's on_authorized, which must not run for a transaction
+// whose signatures do not satisfy its authorizations
+BOOST_AUTO_TEST_CASE( on_authorized_after_authorization ) try {
+   eosio::testing::tester chain;
+   chain.create_account( "alice"_n );
+   chain.produce_block();
+   BOOST_REQUIRE( chain.control->is_building_block() );
+
+   uint32_t nonce = 0;
+   auto push = [&]( const private_key_type& key, const std::function<void()>& on_authorized ) {
+      signed_transaction trx;
+      trx.actions.emplace_back( chain.get_action( config::system_account_name, "reqauth"_n,
+                                                  vector<permission_level>{{"alice"_n, config::active_name}},
+                                                  fc::mutable_variant_object()( "from", "alice" ) ) );
+      chain.set_transaction_headers( trx, eosio::testing::tester::DEFAULT_EXPIRATION_DELTA + ++nonce ); // unique id
+      trx.sign( key, chain.control->get_chain_id() );
+      auto ptrx = std::make_shared<packed_transaction>( std::move( trx ) );
+      auto meta = transaction_metadata::start_recover_keys( ptrx, chain.control->get_thread_pool(), chain.control->get_chain_id(),
+                                                            fc::microseconds::maximum(), transaction_metadata::trx_type::input ).get();
+      return chain.control->push_transaction( meta, fc::time_point::maximum(), fc::microseconds::maximum(), 0, false, 0,
+                                              on_authorized );
+   };
+
+   uint32_t calls = 0;
+   auto count = [&]() { ++calls; };
+
+   auto trace = push( chain.get_private_key( "bob"_n, "active" ), count );
+   BOOST_CHECK( trace->except );
+   BOOST_CHECK_EQUAL( calls, 0u );
+
+   trace = push( chain.get_private_key( "alice"_n, "active" ), count );
+   BOOST_CHECK( !trace->except );
+   BOOST_CHECK_EQUAL( calls, 1u );
+
+   // a rejection from on_authorized fails the transaction
+   trace = push( chain.get_private_key( "alice"_n, "active" ), []() {
+      EOS_THROW( tx_rate_limited, "transaction rate of authorizer alice exceeded" );
+   } );
+   BOOST_REQUIRE( trace->except );
+   BOOST_CHECK_EQUAL( trace->except->code(), tx_rate_limited::code_value );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace
@@ -40,30 +40,36 @@ namespace eosio {
    struct metrics_model {
       std::vector<std::shared_ptr<Collectable>> _collectables;
       std::shared_ptr<Registry> _registry;
-      std::vector<std::reference_wrapper<Family<Gauge>>> _gauges;
-      std::vector<std::reference_wrapper<Family<Counter>>> _counters;
+      // metrics that only differ in their labels share a family
+      std::map<std::string, std::reference_wrapper<Family<Gauge>>> _gauges;
+      std::map<std::string, std::reference_wrapper<Family<Counter>>> _counters;
 
       void add_gauge_metric(const runtime_metric& plugin_metric) {
-         auto& gauge_family = BuildGauge()
-               .Name(plugin_metric.family)
-               .Help("")
-               .Register(*_registry);
-         auto& gauge = gauge_family.Add({});
+         auto itr = _gauges.find(plugin_metric.family);
+         if (itr == _gauges.end()) {
+            auto& gauge_family = BuildGauge()
+                  .Name(plugin_metric.family)
+                  .Help("")
+                  .Register(*_registry);
+            itr = _gauges.emplace(plugin_metric.family, gauge_family).first;
+         }
+         auto& gauge = itr->second.get().Add(plugin_metric.labels);
          gauge.Set(plugin_metric.value);
 
-         _gauges.push_back(gauge_family);
-
          tlog("Added gauge metric ${f}:${l}", ("f", plugin_metric.family) ("l", plugin_metric.label));
       }
 
       void add_counter_metric(const runtime_metric& plugin_metric) {
-         auto& counter_family = BuildCounter()
-               .Name(plugin_metric.family)
-               .Help("")
-               .Register(*_registry);
-         auto& counter = counter_family.Add({});
+         auto itr = _counters.find(plugin_metric.family);
+         if (itr == _counters.end()) {
+            auto& counter_family = BuildCounter()
+                  .Name(plugin_metric.family)
+                  .Help("")
+                  .Register(*_registry);
+            itr = _counters.emplace(plugin_metric.family, counter_family).first;
+         }
+         auto& counter = itr->second.get().Add(plugin_metric.labels);
          counter.Increment(plugin_metric.value);
-         _counters.push_back(counter_family);
 
          tlog("Added counter metric ${f}:${l}", ("f", plugin_metric.family) ("l", plugin_metric.label));
       }
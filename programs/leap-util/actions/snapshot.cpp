@@ -4,13 +4,16 @@
 #include <eosio/chain/config.hpp>
 #include <eosio/chain/controller.hpp>
 #include <eosio/chain/fork_database.hpp>
+#include <eosio/chain/state_commitment.hpp>
 
 #include <memory>
 
 #include <fc/bitutil.hpp>
 #include <fc/filesystem.hpp>
 #include <fc/io/json.hpp>
+#include <fc/scoped_exit.hpp>
 #include <fc/variant.hpp>
+#include <fc/variant_object.hpp>
 
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/filesystem.hpp>
@@ -42,6 +45,22 @@ void snapshot_actions::setup(CLI::App& app) {
          throw(CLI::RuntimeError(-1));
       }
    });
+
+   // subcommand - state commitment of snapshot
+   auto commitment = sub->add_subcommand("state-commitment", "Print the state commitment of the chain state in a snapshot file as json, comparable to producer/get_state_commitment");
+   commitment->add_option("--input-file,-i", opt->input_file, "Snapshot file to load (tmp state dir used).")->required();
+   commitment->add_option("--chain-id", opt->chain_id, "Specify a chain id in case it is not included in a snapshot or you want to override it.");
+   commitment->add_option("--db-size", opt->db_size, "Maximum size (in MiB) of the chain state database")->capture_default_str();
+
+   commitment->callback([this]() {
+      try {
+         int rc = run_state_commitment();
+         if(rc) throw(CLI::RuntimeError(rc));
+      } catch(...) {
+         print_exception();
+         throw(CLI::RuntimeError(-1));
+      }
+   });
 }
 
 int snapshot_actions::run_subcommand() {
@@ -115,3 +134,62 @@ int snapshot_actions::run_subcommand() {
    ilog("Completed writing snapshot: ${s}", ("s", json_path.generic_string()));
    return 0;
 }
+
+int snapshot_actions::run_state_commitment() {
+   if(!fc::exists(opt->input_file)) {
+      std::cerr << "cannot load snapshot, " << opt->input_file
+                << " does not exist" << std::endl;
+      return -1;
+   }
+
+   bfs::path snapshot_path = opt->input_file;
+   auto chain_id = chain_id_type("");
+   if(!opt->chain_id.empty()) {
+      chain_id = chain_id_type(opt->chain_id);
+   } else {
+      auto infile = std::ifstream(snapshot_path.generic_string(),
+                               (std::ios::in | std::ios::binary));
+      istream_snapshot_reader reader(infile);
+      reader.validate();
+      chain_id = controller::extract_chain_id(reader);
+      infile.close();
+   }
+
+   bfs::path temp_dir = boost::filesystem::temp_directory_path() /
+                        boost::filesystem::unique_path();
+   controller::config cfg;
+   cfg.blocks_dir = temp_dir / "blocks";
+   cfg.state_dir = temp_dir / "state";
+   cfg.state_size = opt->db_size * 1024 * 1024;
+   cfg.state_guard_size = opt->guard_size * 1024 * 1024;
+   protocol_feature_set pfs = initialize_protocol_features( bfs::path("protocol_features"), false );
+
+   fc::mutable_variant_object result;
+   {
+      auto remove_temp_dir = fc::make_scoped_exit([&temp_dir]() { fc::remove_all(temp_dir); });
+
+      auto infile = std::ifstream(snapshot_path.generic_string(),
+                                  (std::ios::in | std::ios::binary));
+      auto reader = std::make_shared<istream_snapshot_reader>(infile);
+
+      auto check_shutdown = []() { return false; };
+      auto shutdown = []() { throw; };
+
+      controller control(cfg, std::move(pfs), chain_id);
+      control.add_indices();
+      control.startup(shutdown, check_shutdown, reader);
+      infile.close();
+
+      const state_commitment& commitment = control.calculate_state_commitment();
+      fc::mutable_variant_object indices;
+      for(const auto& [index, digest] : commitment.index_digests())
+         indices(index, digest);
+      result("head_block_id", control.head_block_id())
+            ("head_block_num", control.head_block_num())
+            ("state_commitment", commitment.digest())
+            ("indices", std::move(indices));
+   }
+
+   std::cout << fc::json::to_pretty_string(result) << std::endl;
+   return 0;
+}
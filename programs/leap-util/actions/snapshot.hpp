@@ -17,4 +17,5 @@ public:
 
    // callbacks
    int run_subcommand();
+   int run_state_commitment();
 };
\ No newline at end of file
@@ -20,6 +20,7 @@
 #include <fc/io/json.hpp>
 
 #include <array>
+#include <thread>
 #include <utility>
 
 #ifdef NON_VALIDATING_TEST
@@ -130,6 +131,53 @@ BOOST_FIXTURE_TEST_CASE( get_block_with_invalid_abi, TESTER ) try {
 
 } FC_LOG_AND_RETHROW() /// get_block_with_invalid_abi
 
+BOOST_FIXTURE_TEST_CASE( get_block_parallel_decode, TESTER ) try {
+   create_accounts( {"asserter"_n} );
+   set_code( "asserter"_n, test_contracts::asserter_wasm() );
+   set_abi( "asserter"_n, test_contracts::asserter_abi().data() );
+   produce_block();
+
+   for( int i = 0; i < 50; ++i ) {
+      push_action( "asserter"_n, "procassert"_n, "asserter"_n, mutable_variant_object()
+         ("condition", 1)
+         ("message", "message " + std::to_string(i)) );
+   }
+   produce_block();
+
+   chain_apis::read_only plugin(*(this->control), {}, fc::microseconds::maximum(), fc::microseconds::maximum(), {}, {});
+   chain_apis::read_only::get_raw_block_params param{std::to_string(control->head_block_num())};
+   auto block = plugin.get_raw_block(param, fc::time_point::maximum());
+   BOOST_REQUIRE_EQUAL(block->transactions.size(), 50u);
+   auto abi_cache = plugin.get_block_serializers(block, fc::microseconds::maximum());
+
+   const std::string serial = json::to_string(plugin.convert_block(block, abi_cache, fc::microseconds::maximum()), fc::time_point::maximum());
+   BOOST_TEST(serial.find("message 49") != std::string::npos);
+
+   // helpers on their own threads
+   std::vector<std::thread> threads;
+   auto post_thread = [&threads]( std::function<void()> f ) { threads.emplace_back( std::move(f) ); };
+   const std::string parallel = json::to_string(plugin.convert_block(block, abi_cache, fc::microseconds::maximum(), post_thread), fc::time_point::maximum());
+   for( auto& t : threads )
+      t.join();
+   BOOST_TEST(parallel == serial);
+
+   // helpers that only run once the conversion is done find no work left
+   std::vector<std::function<void()>> deferred;
+   auto post_deferred = [&deferred]( std::function<void()> f ) { deferred.emplace_back( std::move(f) ); };
+   const std::string unhelped = json::to_string(plugin.convert_block(block, abi_cache, fc::microseconds::maximum(), post_deferred), fc::time_point::maximum());
+   BOOST_TEST(!deferred.empty());
+   for( auto& f : deferred )
+      f();
+   BOOST_TEST(unhelped == serial);
+
+   // the deadline still applies to the block as a whole
+   deferred.clear();
+   BOOST_CHECK_THROW(plugin.convert_block(block, abi_cache, fc::microseconds(0), post_deferred), fc::exception);
+   for( auto& f : deferred )
+      f();
+
+} FC_LOG_AND_RETHROW() /// get_block_parallel_decode
+
 BOOST_AUTO_TEST_CASE( get_consensus_parameters ) try {
    tester t{setup_policy::old_wasm_parser};
    t.produce_blocks(1);
@@ -312,6 +312,32 @@ BOOST_FIXTURE_TEST_CASE( get_table_test, TESTER ) try {
       BOOST_REQUIRE_EQUAL("7777.0000 CCC", result.rows[0]["balance"].as_string());
    }
 
+   // get table raw: the stored rows, the same as the hex encoded ones
+   p.lower_bound = p.upper_bound = "";
+   p.limit = 10;
+   p.reverse = false;
+   p.json = false;
+   p.show_payer = true;
+   result = plugin.read_only::get_table_rows(p, fc::time_point::maximum());
+   auto raw = plugin.read_only::get_table_rows_raw(p, fc::time_point::maximum());
+   BOOST_REQUIRE_EQUAL(4u, raw.rows.size());
+   BOOST_REQUIRE_EQUAL(result.rows.size(), raw.rows.size());
+   BOOST_REQUIRE_EQUAL(result.more, raw.more);
+   for (size_t i = 0; i < raw.rows.size(); ++i) {
+      BOOST_REQUIRE(result.rows[i]["data"].as<bytes>() == raw.rows[i].data);
+      BOOST_REQUIRE_EQUAL(result.rows[i]["payer"].as<name>(), raw.rows[i].payer);
+   }
+
+   // json is ignored, payer only when asked for
+   p.json = true;
+   p.show_payer = false;
+   p.limit = 1;
+   raw = plugin.read_only::get_table_rows_raw(p, fc::time_point::maximum());
+   BOOST_REQUIRE_EQUAL(1u, raw.rows.size());
+   BOOST_REQUIRE_EQUAL(true, raw.more);
+   BOOST_REQUIRE(raw.rows[0].data == result.rows[0]["data"].as<bytes>());
+   BOOST_REQUIRE_EQUAL(name(), raw.rows[0].payer);
+
 } FC_LOG_AND_RETHROW()
 
 BOOST_FIXTURE_TEST_CASE( get_table_by_seckey_test, TESTER ) try {
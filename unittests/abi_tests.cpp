@@ -2987,6 +2987,64 @@ BOOST_AUTO_TEST_CASE(serialize_optional_struct_type)
    } FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE(compiled_type_plans)
+{
+   using eosio::testing::fc_exception_message_is;
+
+   auto abi = R"({
+      "version": "eosio::abi/1.1",
+      "types": [{"new_type_name": "node_list", "type": "node[]"}],
+      "structs": [
+         {"name": "node", "base": "", "fields": [
+            {"name": "v", "type": "uint8"},
+            {"name": "children", "type": "node_list"},
+            {"name": "next", "type": "node?"}
+         ]},
+         {"name": "fixed", "base": "", "fields": [
+            {"name": "a", "type": "uint8[2]"},
+            {"name": "e", "type": "uint8$"}
+         ]}
+      ],
+   })";
+
+   try {
+      abi_serializer orig( fc::json::from_string(abi).as<abi_def>(), abi_serializer::create_yield_function( max_serialization_time ) );
+      abi_serializer abis( orig ); // copies must rebind their plans to their own maps
+      orig = abi_serializer();
+
+      verify_round_trip_conversion(abis, "node", R"({"v":1,"children":[],"next":null})", "010000");
+      verify_round_trip_conversion(abis, "node", R"({"v":1,"children":[{"v":2,"children":[],"next":null}],"next":{"v":3,"children":[],"next":null}})",
+                                   "010102000001030000");
+      verify_round_trip_conversion(abis, "node_list", R"([{"v":4,"children":[],"next":null}])", "01040000");
+      verify_round_trip_conversion(abis, "fixed", R"({"a":2})", "02");
+      verify_round_trip_conversion(abis, "fixed", R"({"a":2,"e":3})", "0203");
+
+      abi_serializer assigned;
+      {
+         abi_serializer tmp( abis );
+         assigned = tmp;
+      }
+      verify_round_trip_conversion(assigned, "node", R"({"v":1,"children":[{"v":2,"children":[],"next":null}],"next":{"v":3,"children":[],"next":null}})",
+                                   "010102000001030000");
+      verify_round_trip_conversion(assigned, "fixed", R"({"a":2,"e":3})", "0203");
+
+      BOOST_CHECK_EXCEPTION( abis.binary_to_variant("node", fc::variant("010100").as<bytes>(), abi_serializer::create_yield_function( max_serialization_time )),
+                             unpack_exception, fc_exception_message_is("Stream unexpectedly ended; unable to unpack field 'v' of struct 'node.children[0]'") );
+
+      // a rejected ABI must not leave plans referring to the previous one
+      auto dup_abi = R"({
+         "version": "eosio::abi/1.1",
+         "types": [{"new_type_name": "node_list", "type": "node[]"}, {"new_type_name": "node_list", "type": "node[]"}],
+         "structs": [{"name": "node", "base": "", "fields": [{"name": "v", "type": "uint8"}]}]
+      })";
+      BOOST_CHECK_THROW( abis.set_abi( fc::json::from_string(dup_abi).as<abi_def>(), abi_serializer::create_yield_function( max_serialization_time ) ),
+                         duplicate_abi_type_def_exception );
+      BOOST_CHECK_THROW( abis.binary_to_variant("fixed", fc::variant("0203").as<bytes>(), abi_serializer::create_yield_function( max_serialization_time )),
+                         fc::exception );
+
+   } FC_LOG_AND_RETHROW()
+}
+
 template<class T>
 inline std::pair<action_trace, std::string> generate_action_trace(const std::optional<T> &  return_value, const std::string &  return_value_hex, bool parsable = true)
 {
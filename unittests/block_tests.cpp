@@ -205,6 +205,62 @@ BOOST_AUTO_TEST_CASE(untrusted_producer_test)
    }) ;
 }
 
+/**
+ * Blocks received before their predecessor is applied are validated ahead of time; they must apply the same way
+ * and a bad producer signature among them must still be rejected
+ */
+BOOST_AUTO_TEST_CASE(validation_window_test)
+{
+   tester main;
+   tester validator;
+
+   std::vector<signed_block_ptr> blocks;
+   for( char c = 'a'; c <= 'e'; ++c ) {
+      main.create_account( account_name( std::string( "windowacc" ) + c ) );
+      blocks.push_back( main.produce_block() );
+   }
+
+   // same id as the last block, signed by a key that is not the producer's
+   auto bad = std::make_shared<signed_block>( blocks.back()->clone() );
+   bad->producer_signature = main.get_private_key( "bogus"_n, "active" ).sign( digest_type::hash( std::string( "bogus" ) ) );
+
+   // as net_plugin does while syncing: only the first block links to a block in fork_db
+   BOOST_REQUIRE( validator.control->create_block_state( blocks.front()->calculate_id(), blocks.front() ) );
+   for( size_t i = 1; i < blocks.size() - 1; ++i )
+      BOOST_REQUIRE( !validator.control->create_block_state( blocks[i]->calculate_id(), blocks[i] ) );
+   BOOST_REQUIRE( !validator.control->create_block_state( bad->calculate_id(), bad ) );
+
+   for( size_t i = 0; i < blocks.size() - 1; ++i ) {
+      auto bsf = validator.control->create_block_state_future( blocks[i]->calculate_id(), blocks[i] );
+      // taken from the validation window rather than validated again
+      BOOST_CHECK( bsf.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::deferred );
+      validator.control->abort_block();
+      controller::block_report br;
+      validator.control->push_block( br, bsf.get(), forked_branch_callback{}, trx_meta_cache_lookup{} );
+   }
+   BOOST_REQUIRE_EQUAL( validator.control->head_block_id(), blocks[blocks.size() - 2]->calculate_id() );
+
+   auto bsf = validator.control->create_block_state_future( bad->calculate_id(), bad );
+   BOOST_REQUIRE_EXCEPTION( bsf.get(), fc::exception, []( const fc::exception& e ) {
+      return e.code() == wrong_signing_key::code_value;
+   } );
+
+   // the correctly signed block is still accepted
+   validator.push_block( blocks.back() );
+   BOOST_REQUIRE_EQUAL( validator.control->head_block_id(), main.control->head_block_id() );
+
+   // a forged copy validated ahead first does not poison the correctly signed block
+   auto next = main.produce_block();
+   auto last = main.produce_block();
+   auto forged = std::make_shared<signed_block>( last->clone() );
+   forged->producer_signature = bad->producer_signature;
+   BOOST_REQUIRE( validator.control->create_block_state( next->calculate_id(), next ) );
+   BOOST_REQUIRE( !validator.control->create_block_state( forged->calculate_id(), forged ) );
+   validator.push_block( next );
+   validator.push_block( last );
+   BOOST_REQUIRE_EQUAL( validator.control->head_block_id(), main.control->head_block_id() );
+}
+
 /**
  * Ensure that the block broadcasted by producing node and receiving node is identical
  */
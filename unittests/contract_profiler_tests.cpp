@@ -0,0 +1,63 @@
+#include <eosio/chain/contract_profiler.hpp>
+#include <eosio/testing/tester.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "token_test_utilities.hpp"
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+BOOST_AUTO_TEST_SUITE(contract_profiler_tests)
+
+BOOST_AUTO_TEST_CASE(disabled_by_default) try {
+   tester chain;
+   BOOST_REQUIRE( !chain.control->get_contract_profiler() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE(profiles_wasm_actions) try {
+   fc::temp_directory tempdir;
+   tester chain( tempdir, []( controller::config& cfg ) { cfg.profile_contracts = true; }, true );
+   chain.execute_setup_policy( setup_policy::full );
+
+   deploy_token( chain );
+   chain.create_account( "alice"_n );
+   for( int i = 0; i < 3; ++i )
+      transfer_token( chain, "alice"_n, "1.0000 TOK", std::to_string( i ) );
+   chain.produce_block();
+
+   auto* prof = chain.control->get_contract_profiler();
+   BOOST_REQUIRE( prof );
+   const auto rows = prof->top( 100 );
+   auto find = [&]( name contract, name action ) {
+      auto itr = std::find_if( rows.begin(), rows.end(), [&]( const auto& e ) {
+         return e.contract == contract && e.action == action;
+      } );
+      BOOST_REQUIRE( itr != rows.end() );
+      return *itr;
+   };
+
+   // the transfer notifies both accounts but only eosio.token has code
+   const auto transfer = find( "eosio.token"_n, "transfer"_n );
+   BOOST_CHECK_EQUAL( transfer.calls, 3u );
+   BOOST_CHECK_GE( transfer.total_us, transfer.max_us );
+   BOOST_CHECK_EQUAL( find( "eosio.token"_n, "issue"_n ).calls, 1u );
+   BOOST_CHECK( std::none_of( rows.begin(), rows.end(), []( const auto& e ) { return e.contract == "alice"_n; } ) );
+   BOOST_CHECK( std::is_sorted( rows.begin(), rows.end(), []( const auto& a, const auto& b ) { return a.total_us > b.total_us; } ) );
+
+   BOOST_CHECK_EQUAL( prof->top( 1 ).size(), 1u );
+   prof->clear();
+   BOOST_CHECK( prof->top( 100 ).empty() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE(bounded_entries) {
+   contract_profiler prof( 16 ); // one entry per shard
+   for( uint64_t i = 1; i <= 1000; ++i )
+      prof.record( name( i ), "act"_n, fc::microseconds( 2 ) );
+   const auto rows = prof.top( 1000 );
+   BOOST_CHECK_LE( rows.size(), 16u );
+   BOOST_CHECK_EQUAL( rows.size() * 2 + prof.untracked_us(), 2000u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,6 @@
 #include <eosio/testing/tester.hpp>
 #include <fc/log/logger_config.hpp>
+#include <fc/io/fstream.hpp>
 #include <eosio/chain/deep_mind.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -48,6 +49,22 @@ struct deep_mind_tester : deep_mind_log_fixture, validating_tester
    deep_mind_tester() : validating_tester({}, &deep_mind_logger) {}
 };
 
+struct deep_mind_binary_fixture
+{
+   deep_mind_handler deep_mind_logger;
+   fc::temp_file binary_output;
+   deep_mind_binary_fixture()
+   {
+      deep_mind_logger.update_config(deep_mind_handler::deep_mind_config{.zero_elapsed = true});
+      deep_mind_logger.update_binary_output(binary_output.path().preferred_string());
+   }
+};
+
+struct deep_mind_binary_tester : deep_mind_binary_fixture, validating_tester
+{
+   deep_mind_binary_tester() : validating_tester({}, &deep_mind_logger) {}
+};
+
 namespace {
 
 void compare_files(const std::string& filename1, const std::string& filename2)
@@ -111,4 +128,49 @@ BOOST_FIXTURE_TEST_CASE(deep_mind, deep_mind_tester)
    }
 }
 
+BOOST_FIXTURE_TEST_CASE(deep_mind_binary, deep_mind_binary_tester)
+{
+   produce_block();
+   create_account( "alice"_n );
+   produce_block();
+   deep_mind_logger.flush();
+
+   std::string content;
+   fc::read_file_contents(binary_output.path(), content);
+   fc::datastream<const char*> ds(content.data(), content.size());
+
+   std::map<deep_mind_record, uint32_t> counts;
+   std::vector<uint32_t> accepted_block_nums;
+   std::optional<deep_mind_record> first;
+   while (ds.remaining()) {
+      uint32_t size = 0;
+      uint8_t tag = 0;
+      fc::raw::unpack(ds, size);
+      fc::raw::unpack(ds, tag);
+      BOOST_REQUIRE_LE(size, ds.remaining());
+      const auto record = static_cast<deep_mind_record>(tag);
+      if (!first)
+         first = record;
+      ++counts[record];
+      if (record == deep_mind_record::accepted_block) {
+         fc::datastream<const char*> payload(ds.pos(), size);
+         uint32_t block_num = 0;
+         fc::raw::unpack(payload, block_num);
+         accepted_block_nums.push_back(block_num);
+      }
+      ds.skip(size);
+   }
+
+   BOOST_REQUIRE(first && *first == deep_mind_record::version);
+   BOOST_CHECK_EQUAL(counts[deep_mind_record::abidump_start], 1u);
+   BOOST_CHECK_EQUAL(counts[deep_mind_record::abidump_end], 1u);
+   BOOST_CHECK_GT(counts[deep_mind_record::applied_transaction], 0u);
+   BOOST_CHECK_GT(counts[deep_mind_record::ram_op], 0u);
+   BOOST_CHECK_EQUAL(counts[deep_mind_record::start_block], accepted_block_nums.size());
+   BOOST_REQUIRE(!accepted_block_nums.empty());
+   for (size_t i = 1; i < accepted_block_nums.size(); ++i)
+      BOOST_CHECK_EQUAL(accepted_block_nums[i], accepted_block_nums[i-1] + 1);
+   BOOST_CHECK_EQUAL(accepted_block_nums.back(), validating_node->head_block_num());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
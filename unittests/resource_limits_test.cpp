@@ -418,4 +418,79 @@ BOOST_AUTO_TEST_SUITE(resource_limits_test)
    } FC_LOG_AND_RETHROW()
 
 
+   /**
+    * Usage batched in memory for a block must produce the same limits, failures and final state as usage written
+    * to the database by every transaction, including usage from transactions that are rolled back.
+    */
+   BOOST_AUTO_TEST_CASE(batched_usage_matches_direct_usage) try {
+      const account_name small_account("smallacc");
+      const account_name large_account("largeacc");
+
+      auto run_blocks = []( resource_limits_fixture& rl, const account_name& small, const account_name& large ) {
+         using checkpoint = resource_limits_manager::usage_checkpoint;
+         std::vector<int64_t> observed;
+         auto observe = [&]() {
+            for( const auto& a : { small, large } ) {
+               const auto cpu = rl.get_account_cpu_limit_ex( a ).first;
+               const auto net = rl.get_account_net_limit_ex( a ).first;
+               observed.insert( observed.end(), { cpu.used, cpu.available, int64_t(cpu.last_usage_update_time.slot),
+                                                  net.used, net.available, int64_t(net.last_usage_update_time.slot) } );
+            }
+            observed.push_back( rl.get_block_cpu_limit() );
+            observed.push_back( rl.get_block_net_limit() );
+         };
+
+         for( const auto& a : { small, large } )
+            rl.initialize_account( a, false );
+         rl.set_account_limits( small, -1, 1, 1, false );
+         rl.set_account_limits( large, -1, 1000000, 1000000, false );
+         rl.process_account_limit_updates();
+
+         for( uint32_t block_num = 1; block_num <= 5; ++block_num ) {
+            {  // billed to both accounts and kept
+               auto s = rl.start_session();
+               checkpoint cp( rl );
+               rl.update_account_usage( { small, large }, block_num );
+               rl.add_transaction_usage( { small, large }, 1000, 200, block_num );
+               s.squash();
+               cp.commit();
+            }
+            observe();
+            {  // billed and then rolled back
+               auto s = rl.start_session();
+               checkpoint cp( rl );
+               rl.add_transaction_usage( { large }, 5000, 300, block_num );
+               observe();
+               s.undo();
+               cp.undo();
+            }
+            observe();
+            {  // exceeds the account limit and is rolled back when the session goes out of scope
+               auto s = rl.start_session();
+               checkpoint cp( rl );
+               BOOST_REQUIRE_THROW( rl.add_transaction_usage( { small }, 40000, 0, block_num ), tx_cpu_usage_exceeded );
+            }
+            observe();
+
+            rl.flush_batched_usage();
+            rl.process_account_limit_updates();
+            rl.process_block_usage( block_num );
+            observe();
+            observed.push_back( rl.get_virtual_block_cpu_limit() );
+            observed.push_back( rl.get_virtual_block_net_limit() );
+         }
+         return observed;
+      };
+
+      resource_limits_fixture direct;
+      resource_limits_fixture batched;
+      batched.set_batched_usage( true );
+      BOOST_REQUIRE( batched.is_batched_usage() );
+
+      const auto expected = run_blocks( direct, small_account, large_account );
+      const auto actual   = run_blocks( batched, small_account, large_account );
+      BOOST_REQUIRE_EQUAL_COLLECTIONS( actual.begin(), actual.end(), expected.begin(), expected.end() );
+   } FC_LOG_AND_RETHROW()
+
+
    BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+#include <eosio/chain/state_commitment.hpp>
+#include <eosio/testing/tester.hpp>
+
+#include <fc/variant_object.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "token_test_utilities.hpp"
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+using mvo = fc::mutable_variant_object;
+
+namespace {
+
+struct commitment_tester : tester {
+   explicit commitment_tester( const fc::temp_directory& tempdir, setup_policy policy = setup_policy::full )
+   : tester( tempdir, []( controller::config& cfg ) { cfg.maintain_state_commitment = true; }, true ) {
+      execute_setup_policy( policy );
+   }
+
+   void create_token() {
+      deploy_token( *this );
+      create_accounts( { "alice"_n, "bob"_n } );
+   }
+
+   void transfer( name to, const std::string& quantity ) {
+      transfer_token( *this, to, quantity );
+   }
+
+   // the maintained commitment must match the one calculated from scratch
+   void check_commitment() {
+      control->abort_block();
+      state_commitment full;
+      full.calculate( control->db(), control->get_thread_pool() );
+      const state_commitment& incremental = control->calculate_state_commitment();
+      BOOST_REQUIRE( incremental.valid() );
+      BOOST_REQUIRE_EQUAL( incremental.digest(), full.digest() );
+   }
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(state_commitment_tests)
+
+BOOST_AUTO_TEST_CASE(incremental_matches_full) try {
+   fc::temp_directory tempdir;
+   commitment_tester chain( tempdir );
+   chain.check_commitment();
+
+   chain.create_token();
+   chain.produce_block();
+   chain.check_commitment();
+
+   const auto before = chain.control->calculate_state_commitment().digest();
+   chain.transfer( "alice"_n, "10.0000 TOK" );
+   chain.set_authority( "alice"_n, "trade"_n, authority( chain.get_public_key( "alice"_n, "trade" ) ), "active"_n );
+   chain.link_authority( "alice"_n, "eosio.token"_n, "trade"_n, "transfer"_n );
+   chain.produce_block();
+   chain.check_commitment();
+   BOOST_REQUIRE_NE( chain.control->calculate_state_commitment().digest(), before );
+
+   // removes the permission and table row created above
+   chain.unlink_authority( "alice"_n, "eosio.token"_n, "transfer"_n );
+   chain.delete_authority( "alice"_n, "trade"_n );
+   chain.push_action( "eosio.token"_n, "transfer"_n, "alice"_n, mvo()
+      ( "from", "alice" )( "to", "eosio.token" )( "quantity", "10.0000 TOK" )( "memo", "" ) );
+   chain.push_action( "eosio.token"_n, "close"_n, "alice"_n, mvo()( "owner", "alice" )( "symbol", "4,TOK" ) );
+   chain.produce_blocks( 3 );
+   chain.check_commitment();
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE(fork_switch) try {
+   fc::temp_directory tempdir1, tempdir2;
+   commitment_tester c( tempdir1 );
+   commitment_tester c2( tempdir2, setup_policy::none );
+
+   c.create_token();
+   c.produce_block();
+   const uint32_t fork_base = c.control->head_block_num();
+   for( uint32_t n = c2.control->head_block_num() + 1; n <= c.control->head_block_num(); ++n )
+      c2.push_block( c.control->fetch_block_by_number( n ) );
+
+   // c builds a short fork, c2 a longer one with different transfers
+   c.transfer( "alice"_n, "1.0000 TOK" );
+   c.produce_blocks( 2 );
+   c.check_commitment();
+
+   c2.transfer( "bob"_n, "2.0000 TOK" );
+   c2.produce_blocks( 3 );
+   c2.check_commitment();
+
+   for( uint32_t n = fork_base + 1; n <= c2.control->head_block_num(); ++n )
+      c.push_block( c2.control->fetch_block_by_number( n ) );
+   BOOST_REQUIRE_EQUAL( c.control->head_block_id(), c2.control->head_block_id() );
+
+   c.check_commitment();
+   BOOST_REQUIRE_EQUAL( c.control->calculate_state_commitment().digest(),
+                        c2.control->calculate_state_commitment().digest() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE(persisted_across_restart) try {
+   fc::temp_directory tempdir;
+   commitment_tester chain( tempdir );
+   chain.create_token();
+   chain.transfer( "bob"_n, "5.0000 TOK" );
+   chain.produce_blocks( 2 );
+   chain.control->abort_block();
+   const auto expected = chain.control->calculate_state_commitment().digest();
+
+   chain.close();
+   BOOST_REQUIRE( fc::exists( chain.get_config().state_dir / config::state_commitment_filename ) );
+   chain.open();
+   // read() consumes the file, a crash from here on cannot leave a stale commitment behind
+   BOOST_REQUIRE( !fc::exists( chain.get_config().state_dir / config::state_commitment_filename ) );
+
+   chain.control->abort_block();
+   BOOST_REQUIRE_EQUAL( chain.control->calculate_state_commitment().digest(), expected );
+   chain.produce_block();
+   chain.check_commitment();
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
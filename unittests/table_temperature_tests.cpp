@@ -0,0 +1,116 @@
+#include <eosio/chain/contract_table_objects.hpp>
+#include <eosio/chain/table_temperature.hpp>
+#include <eosio/testing/tester.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include "token_test_utilities.hpp"
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+namespace {
+
+constexpr uint32_t cold_after_blocks = 10;
+
+struct temperature_tester : tester {
+   explicit temperature_tester( const fc::temp_directory& tempdir )
+   : tester( tempdir, []( controller::config& cfg ) { cfg.table_cold_after_blocks = cold_after_blocks; }, true ) {
+      execute_setup_policy( setup_policy::full );
+
+      deploy_token( *this );
+      create_accounts( { "alice"_n, "bob"_n } );
+      transfer( "alice"_n );
+      transfer( "bob"_n );
+      produce_block();
+   }
+
+   void transfer( name to ) {
+      transfer_token( *this, to, "1.0000 TOK" );
+   }
+
+   int64_t accounts_table( name owner ) const {
+      const auto* t = control->db().find<table_id_object, by_code_scope_table>(
+            boost::make_tuple( "eosio.token"_n, owner, "accounts"_n ) );
+      BOOST_REQUIRE( t );
+      return t->id._id;
+   }
+
+   table_temperature& temperature() const {
+      BOOST_REQUIRE( control->get_table_temperature() );
+      return *control->get_table_temperature();
+   }
+
+   /// walks all tables in steps of max_tables
+   table_temperature::table_report walk_tables( size_t max_tables ) const {
+      std::optional<table_temperature::table_report> r;
+      size_t steps = 0;
+      while( !( r = temperature().walk_tables( control->db(), max_tables ) ) )
+         ++steps;
+      const auto& idx = control->db().get_index<table_id_multi_index>();
+      BOOST_REQUIRE_EQUAL( steps, ( idx.size() - 1 ) / max_tables );
+      return *r;
+   }
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(table_temperature_tests)
+
+BOOST_AUTO_TEST_CASE(disabled_by_default) try {
+   tester chain;
+   BOOST_REQUIRE( !chain.control->get_table_temperature() );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE(cold_tables) try {
+   fc::temp_directory tempdir;
+   temperature_tester chain( tempdir );
+   const auto alice = chain.accounts_table( "alice"_n );
+   const auto bob = chain.accounts_table( "bob"_n );
+
+   BOOST_REQUIRE( !chain.temperature().is_cold( alice ) );
+   BOOST_REQUIRE( !chain.temperature().is_cold( bob ) );
+   const auto before = chain.walk_tables( 1000 );
+   BOOST_REQUIRE_GT( table_temperature::state_residency( chain.control->db() ).resident_bytes, 0u );
+
+   // only alice's balance is used from now on
+   for( uint32_t i = 0; i <= cold_after_blocks; ++i ) {
+      chain.transfer( "alice"_n );
+      chain.produce_block();
+   }
+   chain.produce_block(); // starts the next block, accesses are attributed to it
+
+   BOOST_REQUIRE( !chain.temperature().is_cold( alice ) );
+   BOOST_REQUIRE( chain.temperature().is_cold( bob ) );
+   BOOST_REQUIRE_GT( chain.temperature().last_access( alice ), chain.temperature().last_access( bob ) );
+
+   const auto after = chain.walk_tables( 1 );
+   BOOST_REQUIRE_GT( after.cold_tables, before.cold_tables );
+   BOOST_REQUIRE_GE( after.cold_rows, 1u );
+   BOOST_REQUIRE_EQUAL( after.hot_tables + after.cold_tables, before.hot_tables + before.cold_tables );
+
+   // an access warms the table up again
+   chain.transfer( "bob"_n );
+   BOOST_REQUIRE( !chain.temperature().is_cold( bob ) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE(tables_do_not_share_slots) try {
+   table_temperature temp( cold_after_blocks );
+   const int64_t a = 5;
+   const int64_t b = a + ( int64_t(1) << 20 );
+   temp.set_block_num( 1 );
+   temp.touch( a );
+   temp.set_block_num( 100 );
+   temp.touch( b );
+   BOOST_CHECK_EQUAL( temp.last_access( a ), 1u );
+   BOOST_CHECK_EQUAL( temp.last_access( b ), 100u );
+   BOOST_CHECK( temp.is_cold( a ) );
+   BOOST_CHECK( !temp.is_cold( b ) );
+   // never accessed, counts as accessed in the first tracked block
+   BOOST_CHECK_EQUAL( temp.last_access( b + 1 ), 1u );
+   // ids too large to track are never reported cold
+   BOOST_CHECK( !temp.is_cold( int64_t(1) << 40 ) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,28 @@
+#include "token_test_utilities.hpp"
+
+#include <fc/variant_object.hpp>
+
+#include <test_contracts.hpp>
+
+using mvo = fc::mutable_variant_object;
+
+void deploy_token( base_tester& t ) {
+   t.create_account( "eosio.token"_n );
+   t.set_code( "eosio.token"_n, test_contracts::eosio_token_wasm() );
+   t.set_abi( "eosio.token"_n, test_contracts::eosio_token_abi().data() );
+   t.push_action( "eosio.token"_n, "create"_n, "eosio.token"_n, mvo()
+      ( "issuer", "eosio.token" )
+      ( "maximum_supply", "1000000.0000 TOK" ) );
+   t.push_action( "eosio.token"_n, "issue"_n, "eosio.token"_n, mvo()
+      ( "to", "eosio.token" )
+      ( "quantity", "1000000.0000 TOK" )
+      ( "memo", "" ) );
+}
+
+void transfer_token( base_tester& t, name to, const string& quantity, const string& memo ) {
+   t.push_action( "eosio.token"_n, "transfer"_n, "eosio.token"_n, mvo()
+      ( "from", "eosio.token" )
+      ( "to", to )
+      ( "quantity", quantity )
+      ( "memo", memo ) );
+}
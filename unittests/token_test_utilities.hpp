@@ -0,0 +1,12 @@
+#pragma once
+
+#include <eosio/testing/tester.hpp>
+
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+/// deploys eosio.token to a new eosio.token account, which is issued the whole supply of 1000000.0000 TOK
+void deploy_token( base_tester& t );
+
+/// transfers quantity of TOK from eosio.token to the account `to`
+void transfer_token( base_tester& t, name to, const string& quantity, const string& memo = "" );